@@ -85,6 +85,13 @@ MACROS
 	function to ensure that the buffer sent is within the allowed range. 
 */
 
+#define SOCKET_RING_RX_CHUNK								1460
+/*!< 
+	Largest payload delivered by a single receive request (one TCP segment). A socket
+	working in ring mode (@ref recvRing) only re-arms reception while the ring has at
+	least this much free space, so a receive never overflows the ring.
+*/
+
 #define  AF_INET											2
 /*!< 
 	The AF_INET is the address family used for IPv4. An IPv4 transport address is specified with the @ref sockaddr_in structure.
@@ -1425,6 +1432,58 @@ NMI_API sint8 connect(SOCKET sock, struct sockaddr *pstrAddr, uint8 u8AddrLen);
 */
 NMI_API sint16 recv(SOCKET sock, void *pvRecvBuf, uint16 u16BufLen, uint32 u32Timeoutmsec);
 /** @} */
+/** @defgroup ReceiveRingSocketFn recvRing
+ *   @ingroup SocketAPI
+ *	Continuous receive into a caller supplied ring buffer.
+ *
+ *	Once a ring is attached, the socket keeps a receive request pending with the WINC as long as the ring
+ *	has room for @ref SOCKET_RING_RX_CHUNK bytes. Received data is read over SPI directly into the ring,
+ *	and the application reads it in place through @ref recvRingPeek / @ref recvRingConsume.
+ *	The @ref SOCKET_MSG_RECV event is still raised, with pu8Buffer pointing at the new bytes inside the ring.
+ *	That view ends at the ring end, bytes that wrapped around are only reached through @ref recvRingPeek.
+ *	If the WINC delivers more than the ring can hold, the data is dropped and the event carries
+ *	@ref SOCK_ERR_BUFFER_FULL. The stream is broken then, the socket receives nothing more and should be closed.
+ */
+ /**@{*/
+/*!
+@fn		NMI_API sint16 recvRing(SOCKET sock, uint8 *pu8RingBuf, uint16 u16RingSize);
+
+@param [in]	sock
+				Connected TCP socket ID.
+@param [in]	pu8RingBuf
+				Ring storage, owned by the application until the socket is closed.
+@param [in]	u16RingSize
+				Ring size in bytes, at least @ref SOCKET_RING_RX_CHUNK.
+
+@return
+	The function returns @ref SOCK_ERR_NO_ERROR for successful operation and a negative value (indicating the error) otherwise.
+*/
+NMI_API sint16 recvRing(SOCKET sock, uint8 *pu8RingBuf, uint16 u16RingSize);
+/*!
+@fn		NMI_API sint16 recvRingPeek(SOCKET sock, uint8 **ppu8Data);
+
+@param [in]	sock
+				Socket ID with a ring attached.
+@param [out]	ppu8Data
+				Set to the oldest unread byte in the ring.
+
+@return
+	Number of contiguous bytes readable at *ppu8Data (zero when the ring is empty), or a negative error code.
+*/
+NMI_API sint16 recvRingPeek(SOCKET sock, uint8 **ppu8Data);
+/*!
+@fn		NMI_API sint16 recvRingConsume(SOCKET sock, uint16 u16Len);
+
+@param [in]	sock
+				Socket ID with a ring attached.
+@param [in]	u16Len
+				Number of bytes to release, as returned by @ref recvRingPeek.
+
+@return
+	The function returns @ref SOCK_ERR_NO_ERROR for successful operation and a negative value (indicating the error) otherwise.
+*/
+NMI_API sint16 recvRingConsume(SOCKET sock, uint16 u16Len);
+/** @} */
 /** @defgroup ReceiveFromSocketFn recvfrom
  *   @ingroup SocketAPI
  * 	Recieves data from a UDP Scoket.
@@ -103,6 +103,11 @@ typedef struct{
 	uint8				bIsUsed;
 	uint8				u8SSLFlags;
 	uint8				bIsRecvPending;
+	uint8				*pu8RingBuffer;
+	uint16				u16RingSize;
+	uint16				u16RingHead;
+	uint16				u16RingCount;
+	uint8				bIsRingOverflow;
 }tstrSocket;
 
 /*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
@@ -120,6 +125,123 @@ volatile tpfAppResolveCb		gpfAppResolveCb;
 volatile uint8					gbSocketInit = 0;
 volatile tpfPingCb				gfpPingCb;
 
+/*********************************************************************
+Function
+		Socket_ArmRingRecv
+
+Description
+		Issue a new receive request for a socket working in ring mode,
+		as long as the ring can hold a full WINC receive buffer.
+
+Return
+		None.
+*********************************************************************/
+static void Socket_ArmRingRecv(SOCKET sock)
+{
+	if((gastrSockets[sock].bIsUsed == 1) && (gastrSockets[sock].pu8RingBuffer != NULL) && (!gastrSockets[sock].bIsRecvPending)
+		&& (!gastrSockets[sock].bIsRingOverflow))
+	{
+		if((uint16)(gastrSockets[sock].u16RingSize - gastrSockets[sock].u16RingCount) >= SOCKET_RING_RX_CHUNK)
+		{
+			tstrRecvCmd	strRecv;
+			uint8		u8Cmd = SOCKET_CMD_RECV;
+
+			if(gastrSockets[sock].u8SSLFlags & SSL_FLAGS_ACTIVE)
+			{
+				u8Cmd = SOCKET_CMD_SSL_RECV;
+			}
+			strRecv.u32Timeoutmsec	= 0xFFFFFFFF;
+			strRecv.sock			= sock;
+			strRecv.u16SessionID	= gastrSockets[sock].u16SessionID;
+
+			if(SOCKET_REQUEST(u8Cmd, (uint8*)&strRecv, sizeof(tstrRecvCmd), NULL , 0, 0) == SOCK_ERR_NO_ERROR)
+			{
+				gastrSockets[sock].bIsRecvPending = 1;
+			}
+		}
+	}
+}
+/*********************************************************************
+Function
+		Socket_ReadRingData
+
+Description
+		Read the received payload straight from the WINC into the free
+		space of the socket ring, splitting the transfer at the ring end.
+		The application callback gets a view of the newly written bytes,
+		which ends at the ring end like the one of recvRingPeek.
+		A payload larger than the free space would lose stream data, so
+		it is dropped whole, the callback gets SOCK_ERR_BUFFER_FULL and
+		the socket receives nothing more until it is closed.
+
+Return
+		None.
+*********************************************************************/
+static void Socket_ReadRingData(SOCKET sock, tstrSocketRecvMsg *pstrRecv,uint8 u8SocketMsg,
+								  uint32 u32StartAddress,uint16 u16ReadCount)
+{
+	uint16	u16Free = gastrSockets[sock].u16RingSize - gastrSockets[sock].u16RingCount;
+	uint16	u16Tail = gastrSockets[sock].u16RingHead;
+	uint32	u32Address = u32StartAddress;
+	uint16	u16Left;
+
+	if(u16ReadCount > u16Free)
+	{
+		M2M_ERR("Ring overflow, <%d> bytes for <%d> free\n", u16ReadCount, u16Free);
+		hif_receive(0, NULL, 0, 1);
+		gastrSockets[sock].bIsRingOverflow = 1;
+
+		pstrRecv->pu8Buffer			= NULL;
+		pstrRecv->s16BufferSize		= SOCK_ERR_BUFFER_FULL;
+		pstrRecv->u16RemainingSize	= 0;
+		if (gpfAppSocketCb)
+			gpfAppSocketCb(sock, u8SocketMsg, pstrRecv);
+		return;
+	}
+	u16Left = u16ReadCount;
+
+	while(u16Left > 0)
+	{
+		uint16	u16Head = gastrSockets[sock].u16RingHead;
+		uint16	u16Read = gastrSockets[sock].u16RingSize - u16Head;
+
+		if(u16Read > u16Left)
+			u16Read = u16Left;
+
+		if(hif_receive(u32Address, &gastrSockets[sock].pu8RingBuffer[u16Head], u16Read, (u16Left == u16Read)) != M2M_SUCCESS)
+		{
+			M2M_INFO("(ERRR)Current <%d>\n", u16Left);
+			break;
+		}
+
+		u16Head += u16Read;
+		if(u16Head == gastrSockets[sock].u16RingSize)
+			u16Head = 0;
+		gastrSockets[sock].u16RingHead	= u16Head;
+		gastrSockets[sock].u16RingCount	+= u16Read;
+		u32Address	+= u16Read;
+		u16Left		-= u16Read;
+	}
+
+	if(u16Left != 0)
+	{
+		hif_receive(0, NULL, 0, 1);
+	}
+
+	/* Only the bytes up to the ring end are contiguous, the rest is read through recvRingPeek. */
+	u16ReadCount -= u16Left;
+	if(u16ReadCount > (gastrSockets[sock].u16RingSize - u16Tail))
+		u16ReadCount = gastrSockets[sock].u16RingSize - u16Tail;
+	pstrRecv->pu8Buffer			= &gastrSockets[sock].pu8RingBuffer[u16Tail];
+	pstrRecv->s16BufferSize		= u16ReadCount;
+	pstrRecv->u16RemainingSize	= 0;
+
+	if (gpfAppSocketCb)
+		gpfAppSocketCb(sock, u8SocketMsg, pstrRecv);
+
+	/* Keep the receive path armed while the ring has room. */
+	Socket_ArmRingRecv(sock);
+}
 /*********************************************************************
 Function
 		Socket_ReadSocketData
@@ -143,6 +265,11 @@ Date
 NMI_API void Socket_ReadSocketData(SOCKET sock, tstrSocketRecvMsg *pstrRecv,uint8 u8SocketMsg,
 								  uint32 u32StartAddress,uint16 u16ReadCount)
 {
+	if(gastrSockets[sock].pu8RingBuffer != NULL)
+	{
+		Socket_ReadRingData(sock, pstrRecv, u8SocketMsg, u32StartAddress, u16ReadCount);
+		return;
+	}
 	if((u16ReadCount > 0) && (gastrSockets[sock].pu8UserBuffer != NULL) && (gastrSockets[sock].u16UserBufferSize > 0) && (gastrSockets[sock].bIsUsed == 1))
 	{
 		uint32	u32Address = u32StartAddress;
@@ -858,6 +985,92 @@ sint16 recv(SOCKET sock, void *pvRecvBuf, uint16 u16BufLen, uint32 u32Timeoutmse
 	return s16Ret;
 }
 /*********************************************************************
+Function
+		recvRing
+
+Description
+		Attach a receive ring to a connected socket. From then on the
+		socket keeps a receive request pending while the ring has room,
+		and received data is placed directly into the ring.
+
+Return
+		SOCK_ERR_NO_ERROR on success, negative error code otherwise.
+*********************************************************************/
+sint16 recvRing(SOCKET sock, uint8 *pu8RingBuf, uint16 u16RingSize)
+{
+	sint16	s16Ret = SOCK_ERR_INVALID_ARG;
+
+	if((sock >= 0) && (pu8RingBuf != NULL) && (u16RingSize >= SOCKET_RING_RX_CHUNK) && (gastrSockets[sock].bIsUsed == 1))
+	{
+		s16Ret = SOCK_ERR_NO_ERROR;
+		gastrSockets[sock].pu8RingBuffer	= pu8RingBuf;
+		gastrSockets[sock].u16RingSize		= u16RingSize;
+		gastrSockets[sock].u16RingHead		= 0;
+		gastrSockets[sock].u16RingCount		= 0;
+		gastrSockets[sock].bIsRingOverflow	= 0;
+
+		Socket_ArmRingRecv(sock);
+	}
+	return s16Ret;
+}
+/*********************************************************************
+Function
+		recvRingPeek
+
+Description
+		Return a view of the oldest unread bytes in the socket ring. The
+		view is contiguous, so it ends at the wrap point of the ring.
+
+Return
+		Number of bytes available at *ppu8Data, negative error code otherwise.
+*********************************************************************/
+sint16 recvRingPeek(SOCKET sock, uint8 **ppu8Data)
+{
+	sint16	s16Ret = SOCK_ERR_INVALID_ARG;
+
+	if((sock >= 0) && (ppu8Data != NULL) && (gastrSockets[sock].pu8RingBuffer != NULL))
+	{
+		uint16	u16Tail;
+		uint16	u16Count = gastrSockets[sock].u16RingCount;
+
+		if(gastrSockets[sock].u16RingHead >= u16Count)
+			u16Tail = gastrSockets[sock].u16RingHead - u16Count;
+		else
+			u16Tail = gastrSockets[sock].u16RingSize - (u16Count - gastrSockets[sock].u16RingHead);
+
+		if(u16Count > (gastrSockets[sock].u16RingSize - u16Tail))
+			u16Count = gastrSockets[sock].u16RingSize - u16Tail;
+
+		*ppu8Data	= &gastrSockets[sock].pu8RingBuffer[u16Tail];
+		s16Ret		= (sint16)u16Count;
+	}
+	return s16Ret;
+}
+/*********************************************************************
+Function
+		recvRingConsume
+
+Description
+		Release bytes previously returned by recvRingPeek and re-arm the
+		receive request if enough room was freed.
+
+Return
+		SOCK_ERR_NO_ERROR on success, negative error code otherwise.
+*********************************************************************/
+sint16 recvRingConsume(SOCKET sock, uint16 u16Len)
+{
+	sint16	s16Ret = SOCK_ERR_INVALID_ARG;
+
+	if((sock >= 0) && (gastrSockets[sock].pu8RingBuffer != NULL) && (u16Len <= gastrSockets[sock].u16RingCount))
+	{
+		s16Ret = SOCK_ERR_NO_ERROR;
+		gastrSockets[sock].u16RingCount -= u16Len;
+
+		Socket_ArmRingRecv(sock);
+	}
+	return s16Ret;
+}
+/*********************************************************************
 Function
 		close
 
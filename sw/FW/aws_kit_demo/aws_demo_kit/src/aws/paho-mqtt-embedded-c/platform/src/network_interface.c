@@ -53,7 +53,20 @@
 #include "cryptoauthlib.h"
 
 
-static uint8_t *tlsSocketBuf = NULL;
+/** \brief Socket RX ring, filled by the WINC driver while the TLS layer consumes it. */
+static uint8_t netRxRing[NETWORK_RX_RING_SIZE];
+/** \brief Coalescing buffer for outgoing TLS records. */
+static uint8_t netTxFrame[SOCKET_BUFFER_MAX_LENGTH];
+static uint16_t netTxLength = 0;
+/** \brief Bytes of the sends handed to the WINC and not yet confirmed, oldest first. */
+static volatile uint16_t netTxPending[NETWORK_TX_WINDOW];
+static volatile uint8_t netTxHead = 0;
+/** \brief Number of sends handed to the WINC and not yet confirmed. */
+static volatile uint8_t netTxInFlight = 0;
+/** \brief Error the WINC reported for a send, kept until the next connection. */
+static volatile int netTxError = SOCK_ERR_NO_ERROR;
+/** \brief Bytes sent and received since the connection was made. */
+static NetworkStats netStats;
 
 /**
  * \brief Reads data from the WolfSSL library.
@@ -126,20 +139,18 @@ void network_socket_init(void)
 }
 
 /**
- * \brief Connects the network socket library to the IP address and port.
+ * \brief Opens a TCP socket and starts connecting it, without waiting for the connection.
  *
  * \param network_socket[out]       The network socket
  * \param address[in]               The network IP address
  * \param port[in]                  The network port
- * \param timeout_ms[in]            The timeout
  *
  * \return    The network socket status
  */
-int network_socket_connect(SOCKET *network_socket, uint32_t address, uint16_t port, int timeout_ms)
+int network_socket_connect_start(SOCKET *network_socket, uint32_t address, uint16_t port)
 {
 	int ret = SOCK_ERR_INVALID;
 	struct sockaddr_in socket_address;
-	Timer connection_timer;
 
 	if (network_socket == NULL)
 		return SOCK_ERR_INVALID_ARG;
@@ -154,22 +165,75 @@ int network_socket_connect(SOCKET *network_socket, uint32_t address, uint16_t po
 	socket_address.sin_addr.s_addr = address;
 	socket_address.sin_port        = _htons(port);
 
-	ret = connect(*network_socket, (struct sockaddr*)&socket_address, sizeof(struct sockaddr));
+	return connect(*network_socket, (struct sockaddr*)&socket_address, sizeof(struct sockaddr));
+}
+
+/**
+ * \brief Checks a connection started by network_socket_connect_start(), and attaches the RX ring once it is up.
+ *
+ * \param network_socket[in]        The network socket
+ *
+ * \return    NETWORK_SOCKET_PENDING while connecting, otherwise the network socket status
+ */
+int network_socket_connect_poll(SOCKET *network_socket)
+{
+	if (network_socket == NULL)
+		return SOCK_ERR_INVALID_ARG;
+
+	if (!GET_SOCKET_STATUS(SOCKET_STATUS_CONNECT))
+		return NETWORK_SOCKET_PENDING;
+
+	netTxLength = 0;
+	netTxHead = 0;
+	netTxInFlight = 0;
+	netTxError = SOCK_ERR_NO_ERROR;
+	memset(&netStats, 0, sizeof(netStats));
+
+	/* Keep a receive request pending while the ring has room */
+	return recvRing(*network_socket, netRxRing, sizeof(netRxRing));
+}
+
+/**
+ * \brief Connects the network socket library to the IP address and port.
+ *
+ * \param network_socket[out]       The network socket
+ * \param address[in]               The network IP address
+ * \param port[in]                  The network port
+ * \param timeout_ms[in]            The timeout
+ *
+ * \return    The network socket status
+ */
+int network_socket_connect(SOCKET *network_socket, uint32_t address, uint16_t port, int timeout_ms)
+{
+	int ret;
+	Timer connection_timer;
+
+	ret = network_socket_connect_start(network_socket, address, port);
 	if (ret != SOCK_ERR_NO_ERROR)
 		return ret;	
 
-	
 	TimerInit(&connection_timer);
 	TimerCountdownMS(&connection_timer, timeout_ms);
 
-	while (!GET_SOCKET_STATUS(SOCKET_STATUS_CONNECT)) {
+	while ((ret = network_socket_connect_poll(network_socket)) == NETWORK_SOCKET_PENDING) {
 		if(TimerIsExpired(&connection_timer))
 			return SOCK_ERR_TIMEOUT;
 
 		m2m_wifi_handle_events(NULL);
 	}
-	
-	return SOCK_ERR_NO_ERROR;
+
+	return ret;
+}
+
+/**
+ * \brief Returns the byte counters since the last connection.
+ *
+ * \param stats[out]                The network statistics
+ */
+void network_socket_get_stats(NetworkStats *stats)
+{
+	if (stats)
+		*stats = netStats;
 }
 
 /**
@@ -191,6 +255,9 @@ int network_socket_disconnect(SOCKET *network_socket)
 
 /**
  * \brief Reads data from the network socket library.
+ *        Data is copied once, from the socket RX ring straight into the caller buffer.
+ *        During the handshake it never waits, it returns 0 when nothing has arrived yet and the
+ *        client task runs the handshake again on its next pass.
  *
  * \param network[in]               The network socket
  * \param read_buffer[in]           The buffer
@@ -202,157 +269,193 @@ int network_socket_disconnect(SOCKET *network_socket)
  */
 int network_socket_read(SOCKET *socket, unsigned char *read_buffer, int length, int flags, int timeout_ms)
 {
-    int i = length, totalLen = 0, bodyLen = 0, read_count = 0, left_size = 0, copy_count = 0;
-	Timer waitTimer;
+	int ret;
+	int count = 0;
+	sint16 avail = 0;
+	uint8_t *view = NULL;
+	bool handshake;
+	bool polled = false;
+	Timer wait_timer;
 	t_aws_kit* kit = aws_kit_get_instance();
 
+	if ((socket == NULL) || (read_buffer == NULL))
+		return SOCK_ERR_INVALID_ARG;
+
 #ifdef AWS_KIT_DEBUG
 	AWS_INFO("aws_net_receive_packet_cb = %d, %d, %d, %d", timeout_ms, length, kit->tls.ssl->options.processReply, kit->tls.ssl->options.handShakeState);
 #endif
-	if (kit->tls.ssl->options.connectState == CLIENT_HELLO_SENT) {
-		if (kit->tls.ssl->options.processReply == 0 ) {
-			tlsSocketBuf = (uint8_t*)malloc(MAIN_WIFI_M2M_BUFFER_SIZE * 3);
-			if (tlsSocketBuf == NULL) {
-				AWS_ERROR("Failed to allocate socket heap!\r\n");
-				return WOLFSSL_CBIO_ERR_GENERAL;
-			}
-
-			if (recv(*socket, tlsSocketBuf, MAIN_WIFI_M2M_BUFFER_SIZE, flags)) {
-				AWS_ERROR("Failed to receive packet!");
-				return WOLFSSL_CBIO_ERR_CONN_CLOSE;
-			}
+	handshake = !wolfSSL_is_init_finished(kit->tls.ssl);
 
-			while (!GET_SOCKET_STATUS(SOCKET_STATUS_RECEIVE)) {
-				m2m_wifi_handle_events(NULL);
-			}
-			DISABLE_SOCKET_STATUS(SOCKET_STATUS_RECEIVE);
-
-			bodyLen = (tlsSocketBuf[3] << 8) | (tlsSocketBuf[4]);
-			totalLen = bodyLen + RECORD_HEADER_SZ;
-
-			read_count = totalLen / pstrRecv->s16BufferSize;
-			left_size = totalLen % pstrRecv->s16BufferSize;
-			copy_count = 1 * pstrRecv->s16BufferSize;
-
-			while (read_count > 0) {
-				if (read_count == 1) {
-					if (recv(*socket, tlsSocketBuf + copy_count, MAIN_WIFI_M2M_BUFFER_SIZE, flags)) {
-						AWS_ERROR("Failed to receive packet!");
-						return WOLFSSL_CBIO_ERR_CONN_CLOSE;
-					}
-
-					while (!GET_SOCKET_STATUS(SOCKET_STATUS_RECEIVE)) {
-						m2m_wifi_handle_events(NULL);
-					}
-					DISABLE_SOCKET_STATUS(SOCKET_STATUS_RECEIVE);
-					copy_count += left_size;
-				} else {
-					if (recv(*socket, tlsSocketBuf + copy_count, MAIN_WIFI_M2M_BUFFER_SIZE, flags)) {
-						AWS_ERROR("Failed to receive packet!");
-						return WOLFSSL_CBIO_ERR_CONN_CLOSE;
-					}
-
-					while (!GET_SOCKET_STATUS(SOCKET_STATUS_RECEIVE)) {
-						m2m_wifi_handle_events(NULL);
-					}
-					DISABLE_SOCKET_STATUS(SOCKET_STATUS_RECEIVE);
-					copy_count += pstrRecv->s16BufferSize;
-				}
-				--read_count;
-			}
-			memcpy(read_buffer, &tlsSocketBuf[0], length);
-		} else {
-			memcpy(read_buffer, &tlsSocketBuf[RECORD_HEADER_SZ], length);
-			if (tlsSocketBuf) {			
-				free(tlsSocketBuf);
-				tlsSocketBuf = NULL;
-			}
-		}
-	} else if (kit->tls.ssl->options.connectState == FINISHED_DONE) {
-		if (kit->tls.ssl->options.processReply == 0 ) {
-			if (kit->tls.ssl->curRL.type == 22) {
-				tlsSocketBuf = (uint8_t*)malloc(MAIN_WIFI_M2M_BUFFER_SIZE * 3);
-				if (tlsSocketBuf == NULL) {
-					AWS_ERROR("Failed to allocate heap!");
-					return WOLFSSL_CBIO_ERR_GENERAL;
-				}
-
-				if (recv(*socket, tlsSocketBuf, MAIN_WIFI_M2M_BUFFER_SIZE, flags)) {
-					AWS_ERROR("Failed to receive packet!");
-					return WOLFSSL_CBIO_ERR_CONN_CLOSE;
-				}
-
-				while (!GET_SOCKET_STATUS(SOCKET_STATUS_RECEIVE)) {
-					m2m_wifi_handle_events(NULL);
-				}
-				DISABLE_SOCKET_STATUS(SOCKET_STATUS_RECEIVE);
-				memcpy(read_buffer, &tlsSocketBuf[0], length);
-
-			} else {
-				memcpy(read_buffer, &tlsSocketBuf[RECORD_HEADER_SZ + 1], length);
-			}
+	/* A reply is expected, so the buffered flight must go out first */
+	ret = network_socket_flush(socket, 0, timeout_ms);
+	if (handshake && ret == SOCK_ERR_BUFFER_FULL)
+		return 0;
+	if (ret != SOCK_ERR_NO_ERROR)
+		return WOLFSSL_CBIO_ERR_CONN_CLOSE;
 
-		} else {
+	TimerInit(&wait_timer);
+	if (kit->clientState == CLIENT_STATE_MQTT_WAIT_MESSAGE)
+		TimerCountdownMS(&wait_timer, AWS_NET_SUBSCRIBE_TIMEOUT_MS);
+	else
+		TimerCountdownMS(&wait_timer, timeout_ms);
 
-			if (kit->tls.ssl->curRL.type == 20) {
-				memcpy(read_buffer, &tlsSocketBuf[RECORD_HEADER_SZ], length);
-			} else {
-				memcpy(read_buffer, &tlsSocketBuf[RECORD_HEADER_SZ * 2 + 1], length);
-				if (tlsSocketBuf) {			
-					free(tlsSocketBuf);
-					tlsSocketBuf = NULL;
-				}
-			}
+	while (count < length) {
+		avail = recvRingPeek(*socket, &view);
+		if (avail < 0) {
+			AWS_ERROR("Failed to receive packet!");
+			return WOLFSSL_CBIO_ERR_CONN_CLOSE;
 		}
-	} else {
-		if (kit->tls.ssl->options.processReply == 0 ) {
-			tlsSocketBuf = (uint8_t*)malloc(MAIN_WIFI_M2M_BUFFER_SIZE);
-			if (tlsSocketBuf == NULL) {
-				AWS_ERROR("Failed to allocate heap!");
-				return WOLFSSL_CBIO_ERR_GENERAL;
-			}
 
-			if (recv(*socket, tlsSocketBuf, MAIN_WIFI_M2M_BUFFER_SIZE, flags)) {
-				AWS_ERROR("Failed to receive packet!");
-				return WOLFSSL_CBIO_ERR_CONN_CLOSE;
-			}
+		if (avail > 0) {
+			if (avail > (length - count))
+				avail = length - count;
+			memcpy(&read_buffer[count], view, avail);
+			recvRingConsume(*socket, avail);
+			count += avail;
+			netStats.rxBytes += avail;
+			continue;
+		}
 
-			TimerInit(&waitTimer);
-			if (kit->clientState == CLIENT_STATE_MQTT_WAIT_MESSAGE)
-				TimerCountdownMS(&waitTimer, AWS_NET_SUBSCRIBE_TIMEOUT_MS);
-			else
-				TimerCountdownMS(&waitTimer, timeout_ms);
-			while (!GET_SOCKET_STATUS(SOCKET_STATUS_RECEIVE)) {
-				if(TimerIsExpired(&waitTimer) && !kit->blocking) {
-					AWS_INFO("Expired MQTT waiting timer to receive!");
-					DISABLE_SOCKET_STATUS(SOCKET_STATUS_RECEIVE);
-					if (tlsSocketBuf) {			
-						free(tlsSocketBuf);
-						tlsSocketBuf = NULL;
-					}
-					return 0;
-				}
-				m2m_wifi_handle_events(NULL);
-			}
-			DISABLE_SOCKET_STATUS(SOCKET_STATUS_RECEIVE);
-			memcpy(read_buffer, &tlsSocketBuf[0], length);
+		/* Return what we have, the TLS layer asks again for the rest. */
+		if (count > 0)
+			break;
 
-		} else {
-			memcpy(read_buffer, &tlsSocketBuf[RECORD_HEADER_SZ], length);
-			if (tlsSocketBuf) {			
-				free(tlsSocketBuf);
-				tlsSocketBuf = NULL;
+		DISABLE_SOCKET_STATUS(SOCKET_STATUS_RECEIVE);
+		/* The handshake only looks once for new data, the client task comes back for the rest. */
+		if (handshake) {
+			if (polled)
+				return 0;
+			polled = true;
+		}
+		if (TimerIsExpired(&wait_timer)) {
+			if (!kit->blocking) {
+				AWS_INFO("Expired MQTT waiting timer to receive!");
+				return 0;
 			}
 		}
+		m2m_wifi_handle_events(NULL);
 	}
+
 #ifdef AWS_KIT_DEBUG
-    atcab_printbin_label((const uint8_t*)"RECEIVED PACKET\r\n", (uint8_t*)read_buffer, length);
+	atcab_printbin_label((const uint8_t*)"RECEIVED PACKET\r\n", (uint8_t*)read_buffer, count);
 #endif
-    return i;
+	return count;
 }
 	
+/**
+ * \brief Hands one frame to the WINC, waiting only for a free slot in the send window.
+ *        During the handshake it does not wait at all, SOCK_ERR_BUFFER_FULL tells to try again later.
+ *
+ * \param socket[in]                The network socket
+ * \param frame[in]                 The frame, at most SOCKET_BUFFER_MAX_LENGTH bytes
+ * \param length[in]                The frame length
+ * \param flags[in]                 The network socket write flags
+ * \param timeout_ms[in]            The timeout
+ *
+ * \return    The network socket status
+ */
+static int network_socket_send_frame(SOCKET *socket, uint8_t *frame, uint16_t length, int flags, int timeout_ms)
+{
+	int ret;
+	bool handshake;
+	Timer wait_timer;
+	t_aws_kit* kit = aws_kit_get_instance();
+
+	handshake = !wolfSSL_is_init_finished(kit->tls.ssl);
+	TimerInit(&wait_timer);
+	TimerCountdownMS(&wait_timer, handshake ? 0 : timeout_ms);
+
+	while ((netTxInFlight >= NETWORK_TX_WINDOW) && !(kit->nonBlocking) && (netTxError == SOCK_ERR_NO_ERROR)) {
+		if (TimerIsExpired(&wait_timer))
+			return handshake ? SOCK_ERR_BUFFER_FULL : SOCK_ERR_TIMEOUT;
+
+		m2m_wifi_handle_events(NULL);
+	}
+
+	if (netTxError != SOCK_ERR_NO_ERROR) {
+		AWS_ERROR("WINC failed to send a packet!(%d)", netTxError);
+		return netTxError;
+	}
+
+	/* The frame is copied to the WINC by send(), so the buffer is free on return */
+	while ((ret = send(*socket, (void*)frame, length, flags)) == SOCK_ERR_BUFFER_FULL) {
+		if (TimerIsExpired(&wait_timer))
+			return handshake ? SOCK_ERR_BUFFER_FULL : SOCK_ERR_TIMEOUT;
+
+		m2m_wifi_handle_events(NULL);
+	}
+
+	if (ret < 0) {
+		AWS_ERROR("Failed to send packet!");
+		return SOCK_ERR_CONN_ABORTED;
+	}
+
+	/* Without a free slot (non-blocking mode) the bytes are counted with the newest send */
+	if (netTxInFlight < NETWORK_TX_WINDOW) {
+		netTxPending[(netTxHead + netTxInFlight) % NETWORK_TX_WINDOW] = length;
+		netTxInFlight++;
+	} else {
+		netTxPending[(netTxHead + netTxInFlight - 1) % NETWORK_TX_WINDOW] += length;
+	}
+	netStats.txBytes += length;
+
+	return SOCK_ERR_NO_ERROR;
+}
+
+/**
+ * \brief Sends the pending coalesced frame, if any.
+ *
+ * \param socket[in]                The network socket
+ * \param flags[in]                 The network socket write flags
+ * \param timeout_ms[in]            The timeout
+ *
+ * \return    The network socket status
+ */
+int network_socket_flush(SOCKET *socket, int flags, int timeout_ms)
+{
+	int ret = SOCK_ERR_NO_ERROR;
+
+	if (socket == NULL)
+		return SOCK_ERR_INVALID_ARG;
+
+	if (netTxLength > 0) {
+		ret = network_socket_send_frame(socket, netTxFrame, netTxLength, flags, timeout_ms);
+		/* A frame the WINC had no room for is kept for the next try */
+		if (ret != SOCK_ERR_BUFFER_FULL)
+			netTxLength = 0;
+	}
+
+	return ret;
+}
+
+/**
+ * \brief Notifies the send window that the WINC completed a send.
+ *        A send keeps its slot in the window until all of its bytes are confirmed.
+ *        A failed send breaks the TCP stream, the error is returned by the next write.
+ *
+ * \param sent_size[in]             The size reported by SOCKET_MSG_SEND, negative on error
+ */
+void network_socket_send_done(int16_t sent_size)
+{
+	if (netTxInFlight == 0)
+		return;
+
+	if (sent_size <= 0) {
+		netTxError = (sent_size < 0) ? sent_size : SOCK_ERR_CONN_ABORTED;
+	} else if (sent_size < netTxPending[netTxHead]) {
+		netTxPending[netTxHead] -= sent_size;
+		return;
+	}
+
+	netTxHead = (netTxHead + 1) % NETWORK_TX_WINDOW;
+	netTxInFlight--;
+}
+
 /**
  * \brief Writes data to the network socket library.
+ *        Small TLS records are coalesced into full WINC frames. During the handshake a
+ *        whole flight is held back until the next read, so it leaves in as few frames as possible.
+ *        When the WINC has no room during the handshake, the bytes taken so far are returned.
  *
  * \param network[in]               The network socket
  * \param send_buffer[in]           The buffer
@@ -364,9 +467,9 @@ int network_socket_read(SOCKET *socket, unsigned char *read_buffer, int length,
  */
 int network_socket_write(SOCKET *socket, unsigned char *send_buffer, int length, int flags, int timeout_ms)
 {
-	int sent = 0;
+	int ret;
+	int chunk = 0;
 	int count = 0;
-	Timer wait_timer;
 	t_aws_kit* kit = aws_kit_get_instance();
 	
 	if ((socket == NULL) || (send_buffer == NULL))
@@ -376,28 +479,39 @@ int network_socket_write(SOCKET *socket, unsigned char *send_buffer, int length,
 	AWS_INFO("aws_net_send_packet_cb = %d, %d, %d, %d", timeout_ms, length, kit->tls.ssl->options.processReply, kit->tls.ssl->options.handShakeState);
 #endif
 	while (count < length) {
-		/* Write data to TCP socket buffer. */
-		sent = ((length - count) > MAIN_WIFI_M2M_BUFFER_SIZE) ? MAIN_WIFI_M2M_BUFFER_SIZE : length;
-		
-		if (send(*socket, (void*)&send_buffer[count], sent, flags) < 0) {
-			AWS_ERROR("Failed to send packet!");
-			return SOCK_ERR_CONN_ABORTED;
+		if ((netTxLength == 0) && ((length - count) >= SOCKET_BUFFER_MAX_LENGTH)) {
+			/* Full frame, send it straight from the caller buffer */
+			ret = network_socket_send_frame(socket, &send_buffer[count], SOCKET_BUFFER_MAX_LENGTH, flags, timeout_ms);
+			if (ret == SOCK_ERR_BUFFER_FULL)
+				return count;
+			if (ret != SOCK_ERR_NO_ERROR)
+				return ret;
+			count += SOCKET_BUFFER_MAX_LENGTH;
+			continue;
 		}
 
-		TimerInit(&wait_timer);
-		TimerCountdownMS(&wait_timer, timeout_ms);
-		
-		while (!GET_SOCKET_STATUS(SOCKET_STATUS_SEND) && !(kit->nonBlocking)) {
-			if(TimerIsExpired(&wait_timer)) {
-				DISABLE_SOCKET_STATUS(SOCKET_STATUS_SEND);
-				return SOCK_ERR_TIMEOUT;
-			}
+		chunk = length - count;
+		if (chunk > (SOCKET_BUFFER_MAX_LENGTH - netTxLength))
+			chunk = SOCKET_BUFFER_MAX_LENGTH - netTxLength;
 
-			m2m_wifi_handle_events(NULL);
+		memcpy(&netTxFrame[netTxLength], &send_buffer[count], chunk);
+		netTxLength += chunk;
+		count += chunk;
+
+		if (netTxLength == SOCKET_BUFFER_MAX_LENGTH) {
+			ret = network_socket_flush(socket, flags, timeout_ms);
+			if (ret == SOCK_ERR_BUFFER_FULL)
+				return count;
+			if (ret != SOCK_ERR_NO_ERROR)
+				return ret;
 		}
+	}
 
-		DISABLE_SOCKET_STATUS(SOCKET_STATUS_SEND);
-		count += sent;
+	/* Outside the handshake every record goes out right away */
+	if (wolfSSL_is_init_finished(kit->tls.ssl)) {
+		ret = network_socket_flush(socket, flags, timeout_ms);
+		if (ret != SOCK_ERR_NO_ERROR)
+			return ret;
 	}
 
 #ifdef AWS_KIT_DEBUG
@@ -49,6 +49,17 @@
 
 #include "socket/include/socket.h"
 
+/** \brief Size of the socket RX ring, holds a few full WINC receive buffers */
+#define NETWORK_RX_RING_SIZE		(SOCKET_RING_RX_CHUNK * 3)
+/** \brief Number of sends that may be outstanding in the WINC at once */
+#define NETWORK_TX_WINDOW			(4)
+/** \brief Returned by network_socket_connect_poll() while the connection is being set up */
+#define NETWORK_SOCKET_PENDING		(1)
+
+typedef struct network_stats {
+	uint32_t txBytes;
+	uint32_t rxBytes;
+} NetworkStats;
 
 typedef struct mqtt_network {
 	int (*mqttread)(struct mqtt_network *network, unsigned char *read_buffer, int length, int timeout_ms);
@@ -62,9 +73,14 @@ int mqtt_packet_write(Network *network, unsigned char *send_buffer, int length,
 
 void network_socket_init(void);
 int network_socket_connect(SOCKET *network_socket, uint32_t address, uint16_t port, int timeout_ms);
+int network_socket_connect_start(SOCKET *network_socket, uint32_t address, uint16_t port);
+int network_socket_connect_poll(SOCKET *network_socket);
+void network_socket_get_stats(NetworkStats *stats);
 int network_socket_disconnect(SOCKET *network_socket);
 
 int network_socket_read(SOCKET *socket, unsigned char *read_buffer, int length, int flags, int timeout_ms);
 int network_socket_write(SOCKET *socket, unsigned char *send_buffer, int length, int flags, int timeout_ms);
+int network_socket_flush(SOCKET *socket, int flags, int timeout_ms);
+void network_socket_send_done(int16_t sent_size);
 
 #endif // MQTT_NETWORK_INTERFACE_H_INCLUDED
\ No newline at end of file
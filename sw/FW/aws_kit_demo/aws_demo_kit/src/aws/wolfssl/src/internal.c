@@ -2913,6 +2913,15 @@ ProtocolVersion MakeDTLSv1_2(void)
         return (word32) Seconds_get();
     }
 
+#elif defined(ATMEL_AWS_WOLFSSL)
+
+    extern time_t atmel_time(time_t* timer);
+
+    word32 LowResTimer(void)
+    {
+        return (word32)atmel_time(0);
+    }
+
 #elif defined(USER_TICKS)
 #if 0
     word32 LowResTimer(void)
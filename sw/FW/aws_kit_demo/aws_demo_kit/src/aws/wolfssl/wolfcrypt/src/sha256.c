@@ -258,7 +258,7 @@ static void set_Transform(void) {
 }
 
 #else
-   #if defined(FREESCALE_MMCAU)
+   #if defined(FREESCALE_MMCAU) || defined(WOLFSSL_ATCA_SHA256)
       #define XTRANSFORM(sha256, B) Transform(sha256, B)
    #else
       #define XTRANSFORM(sha256, B) Transform(sha256)
@@ -340,7 +340,7 @@ int wc_InitSha256(Sha256* sha256)
 }
 
 
-#if !defined(FREESCALE_MMCAU)
+#if !defined(FREESCALE_MMCAU) && !defined(WOLFSSL_ATCA_SHA256)
 static const ALIGN32 word32 K[64] = {
     0x428A2F98L, 0x71374491L, 0xB5C0FBCFL, 0xE9B5DBA5L, 0x3956C25BL,
     0x59F111F1L, 0x923F82A4L, 0xAB1C5ED5L, 0xD807AA98L, 0x12835B01L,
@@ -373,6 +373,20 @@ static int Transform(Sha256* sha256, byte* buf)
 
 #endif /* FREESCALE_MMCAU */
 
+#if defined(WOLFSSL_ATCA_SHA256)
+
+/* compression function shared with the cryptoauthlib software SHA-256,
+   hashes big endian message blocks into a native endian digest */
+void sw_sha256_transform(word32* hash, const byte* blocks, word32 block_count);
+
+static int Transform(Sha256* sha256, byte* buf)
+{
+    sw_sha256_transform(sha256->digest, buf, 1);
+    return 0;
+}
+
+#endif /* WOLFSSL_ATCA_SHA256 */
+
 #define Ch(x,y,z)       ((z) ^ ((x) & ((y) ^ (z))))
 #define Maj(x,y,z)      ((((x) | (y)) & (z)) | ((x) & (y)))
 #define R(x, n)         (((x)&0xFFFFFFFFU)>>(n))
@@ -389,7 +403,7 @@ static int Transform(Sha256* sha256, byte* buf)
      (d) += t0; \
      (h)  = t0 + t1;
 
-#if !defined(FREESCALE_MMCAU)
+#if !defined(FREESCALE_MMCAU) && !defined(WOLFSSL_ATCA_SHA256)
 static int Transform(Sha256* sha256)
 {
     word32 S[8], t0, t1;
@@ -438,7 +452,7 @@ static int Transform(Sha256* sha256)
     return 0;
 }
 
-#endif /* #if !defined(FREESCALE_MMCAU) */
+#endif /* #if !defined(FREESCALE_MMCAU) && !defined(WOLFSSL_ATCA_SHA256) */
 
 static INLINE void AddLength(Sha256* sha256, word32 len)
 {
@@ -456,7 +470,21 @@ int wc_Sha256Update(Sha256* sha256, const byte* data, word32 len)
     SAVE_XMM_YMM ; /* for Intel AVX */
 
     while (len) {
-        word32 add = min(len, SHA256_BLOCK_SIZE - sha256->buffLen);
+        word32 add;
+
+    #if defined(WOLFSSL_ATCA_SHA256)
+        /* whole blocks are hashed in place instead of through the buffer */
+        if (sha256->buffLen == 0 && len >= SHA256_BLOCK_SIZE) {
+            add = len - len % SHA256_BLOCK_SIZE;
+            sw_sha256_transform(sha256->digest, data, add / SHA256_BLOCK_SIZE);
+            AddLength(sha256, add);
+            data += add;
+            len  -= add;
+            continue;
+        }
+    #endif
+
+        add = min(len, SHA256_BLOCK_SIZE - sha256->buffLen);
         XMEMCPY(&local[sha256->buffLen], data, add);
 
         sha256->buffLen += add;
@@ -466,7 +494,7 @@ int wc_Sha256Update(Sha256* sha256, const byte* data, word32 len)
         if (sha256->buffLen == SHA256_BLOCK_SIZE) {
             int ret;
 
-            #if defined(LITTLE_ENDIAN_ORDER) && !defined(FREESCALE_MMCAU)
+            #if defined(LITTLE_ENDIAN_ORDER) && !defined(FREESCALE_MMCAU) && !defined(WOLFSSL_ATCA_SHA256)
                 #if defined(HAVE_INTEL_AVX1) || defined(HAVE_INTEL_AVX2)
                 if(!IS_INTEL_AVX1 && !IS_INTEL_AVX2)
                 #endif
@@ -501,7 +529,7 @@ int wc_Sha256Final(Sha256* sha256, byte* hash)
         XMEMSET(&local[sha256->buffLen], 0, SHA256_BLOCK_SIZE - sha256->buffLen);
         sha256->buffLen += SHA256_BLOCK_SIZE - sha256->buffLen;
 
-        #if defined(LITTLE_ENDIAN_ORDER) && !defined(FREESCALE_MMCAU)
+        #if defined(LITTLE_ENDIAN_ORDER) && !defined(FREESCALE_MMCAU) && !defined(WOLFSSL_ATCA_SHA256)
             #if defined(HAVE_INTEL_AVX1) || defined(HAVE_INTEL_AVX2)
             if(!IS_INTEL_AVX1 && !IS_INTEL_AVX2)
             #endif
@@ -522,7 +550,7 @@ int wc_Sha256Final(Sha256* sha256, byte* hash)
     sha256->loLen = sha256->loLen << 3;
 
     /* store lengths */
-    #if defined(LITTLE_ENDIAN_ORDER) && !defined(FREESCALE_MMCAU)
+    #if defined(LITTLE_ENDIAN_ORDER) && !defined(FREESCALE_MMCAU) && !defined(WOLFSSL_ATCA_SHA256)
         #if defined(HAVE_INTEL_AVX1) || defined(HAVE_INTEL_AVX2)
         if(!IS_INTEL_AVX1 && !IS_INTEL_AVX2)
         #endif
@@ -533,7 +561,8 @@ int wc_Sha256Final(Sha256* sha256, byte* hash)
     XMEMCPY(&local[SHA256_PAD_SIZE + sizeof(word32)], &sha256->loLen,
             sizeof(word32));
 
-    #if defined(FREESCALE_MMCAU) || defined(HAVE_INTEL_AVX1) || defined(HAVE_INTEL_AVX2)
+    #if defined(FREESCALE_MMCAU) || defined(WOLFSSL_ATCA_SHA256) || \
+        defined(HAVE_INTEL_AVX1) || defined(HAVE_INTEL_AVX2)
         /* Kinetis requires only these bytes reversed */
         #if defined(HAVE_INTEL_AVX1) || defined(HAVE_INTEL_AVX2)
         if(IS_INTEL_AVX1 || IS_INTEL_AVX2)
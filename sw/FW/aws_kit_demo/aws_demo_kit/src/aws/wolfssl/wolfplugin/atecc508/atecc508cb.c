@@ -43,12 +43,19 @@
  */
 
 #include <wolfssl/internal.h>
+#include <wolfssl/wolfcrypt/error-crypt.h>
 #include "atecc508cb.h"
 #include "tls/atcatls.h"
 #include "tls/atcatls_cfg.h"
 #include "atcacert/atcacert_client.h"
+#include "atcacert/atcacert_der.h"
+#include "crypto/atca_crypto_sw_sha2.h"
+#include "crypto/atca_crypto_sw_rand.h"
+#include "aws_kit_crypto.h"
 #include "cert_def_1_signer.h"
 #include "cert_def_2_device.h"
+#include "cert_def_1_signer_build.h"
+#include "cert_def_2_device_build.h"
 
 /**
  * \brief Set a parent key to output buffer.
@@ -96,6 +103,87 @@ int atca_tls_init_enc_key(void)
 	return ret;
 }
 
+/** \name Arguments of the ATECC508A work handed to the crypto service task.
+   @{ */
+typedef struct {
+	const uint8_t* peerPubKey;
+	uint8_t* pms;
+} t_atca_tls_ecdh_arg;
+
+typedef struct {
+	uint8_t* entropy;
+	uint8_t blocks;
+} t_atca_tls_entropy_arg;
+
+typedef struct {
+	const uint8_t* digest;
+	uint8_t* signature;
+} t_atca_tls_sign_arg;
+
+typedef struct {
+	const uint8_t* digest;
+	const uint8_t* signature;
+	const uint8_t* pubKey;
+	bool* verified;
+} t_atca_tls_verify_arg;
+/** @} */
+
+/** \brief Device public key of slot 0, it only changes with the private key so GenKey runs once per boot. */
+static uint8_t atcaTlsDevicePubKey[ATCA_PUB_KEY_SIZE];
+static volatile bool atcaTlsDevicePubKeyValid = false;
+
+static void atca_tls_cache_device_pubkey(const uint8_t* pubKey)
+{
+	memcpy(atcaTlsDevicePubKey, pubKey, ATCA_PUB_KEY_SIZE);
+	atcaTlsDevicePubKeyValid = true;
+}
+
+static int atca_tls_get_pubkey_work(void* arg)
+{
+	int ret = atcab_get_pubkey(TLS_SLOT_AUTH_PRIV, (uint8_t*)arg);
+	if (ret == ATCA_SUCCESS) atca_tls_cache_device_pubkey((const uint8_t*)arg);
+	return ret;
+}
+
+/** \brief The prefetch caches the key from its work function, nobody waits for the request. */
+static void atca_tls_prefetch_done(t_aws_crypto_request* request)
+{
+}
+
+static int atca_tls_ecdh_work(void* arg)
+{
+	t_atca_tls_ecdh_arg* ecdh = (t_atca_tls_ecdh_arg*)arg;
+	return atcatls_ecdh(TLS_SLOT_AUTH_PRIV, ecdh->peerPubKey, ecdh->pms);
+}
+
+static int atca_tls_entropy_work(void* arg)
+{
+	t_atca_tls_entropy_arg* entropy = (t_atca_tls_entropy_arg*)arg;
+	int ret;
+	uint8_t i;
+
+	/* All Random commands of a seed share one wake. */
+	ret = atcab_session_begin();
+	if (ret != ATCA_SUCCESS) return ret;
+	for (i = 0; i < entropy->blocks && ret == ATCA_SUCCESS; i++)
+		ret = atcatls_random(&entropy->entropy[i * RANDOM_NUM_SIZE]);
+	atcab_session_end();
+
+	return ret;
+}
+
+static int atca_tls_sign_work(void* arg)
+{
+	t_atca_tls_sign_arg* sign = (t_atca_tls_sign_arg*)arg;
+	return atcatls_sign(TLS_SLOT_AUTH_PRIV, sign->digest, sign->signature);
+}
+
+static int atca_tls_verify_work(void* arg)
+{
+	t_atca_tls_verify_arg* verify = (t_atca_tls_verify_arg*)arg;
+	return atcatls_verify(verify->digest, verify->signature, verify->pubKey, verify->verified);
+}
+
 /**
  * \brief Create the pre master secret using own private key and peer's public key.
  *
@@ -110,26 +198,41 @@ int atca_tls_create_pms_cb(WOLFSSL* ssl, unsigned char* pubKey, unsigned int* si
 	int ret = ATCA_SUCCESS;
 	uint8_t peerPubKey[ECC_BUFSIZE];
 	uint32_t peerPubKeyLen = sizeof(peerPubKey);
+	t_aws_crypto_request pubKeyRequest;
+	bool pubKeyCached;
+	t_atca_tls_ecdh_arg ecdh;
 
 	do {
 
 		if (ssl->arrays->preMasterSecret == NULL || pubKey == NULL || size == NULL || inOut != 0) BREAK(ret, "Failed: invalid param");
 
+		/* Use the cached Device public key, or read it from slot 0 on the crypto task while the peer's key is exported here. */
+		pubKey[0] = ATCA_PUB_KEY_SIZE + 1;
+		pubKey[1] = 0x04;
+		pubKeyRequest.done = NULL;
+		pubKeyCached = atcaTlsDevicePubKeyValid;
+		if (pubKeyCached) {
+			memcpy(&pubKey[2], atcaTlsDevicePubKey, ATCA_PUB_KEY_SIZE);
+		} else if (aws_kit_crypto_submit(&pubKeyRequest, AWS_CRYPTO_PRIO_HIGH, atca_tls_get_pubkey_work, &pubKey[2], NULL, NULL) != 0) {
+			pubKeyRequest.done = NULL;
+		}
+
 		/* Export public key imported in X9.63 format. */
 		ret = wc_ecc_export_x963(ssl->peerEccKey, peerPubKey, (word32*)&peerPubKeyLen);
-		if (ret != MP_OKAY) BREAK(ret, "Failed: export public key");
+		if (pubKeyRequest.done) {
+			if (aws_kit_crypto_wait(&pubKeyRequest) != 0 && ret == MP_OKAY) ret = pubKeyRequest.status;
+		} else if (!pubKeyCached && ret == MP_OKAY) {
+			ret = aws_kit_crypto_call(AWS_CRYPTO_PRIO_HIGH, atca_tls_get_pubkey_work, &pubKey[2]);
+		}
+		if (ret != 0) BREAK(ret, "Failed: export public key or read device public key");
 		atcab_printbin_label((const uint8_t*)"Peer's public key\r\n", peerPubKey, peerPubKeyLen);
-
-		/* Read the Device public key from slot 0. */
-		pubKey[0] = ATCA_PUB_KEY_SIZE + 1;
-		pubKey[1] = 0x04;
-		ret = atcab_get_pubkey(TLS_SLOT_AUTH_PRIV, &pubKey[2]);
-		if (ret != 0) BREAK(ret, "Failed: read device public key");
 		*size = ATCA_PUB_KEY_SIZE + 2;
 
 		/* Compute pre master secret with Device private and public key of AWS IoT. 
 		   Securely Read the pre master secret from 0th + 1 slot. */
-		ret = atcatls_ecdh(TLS_SLOT_AUTH_PRIV, peerPubKey + 1, ssl->arrays->preMasterSecret);
+		ecdh.peerPubKey = peerPubKey + 1;
+		ecdh.pms = ssl->arrays->preMasterSecret;
+		ret = aws_kit_crypto_call(AWS_CRYPTO_PRIO_HIGH, atca_tls_ecdh_work, &ecdh);
 		if (ret != 0) BREAK(ret, "Failed: create PMS");
 		ssl->arrays->preMasterSz = ATCA_KEY_SIZE;
 		atcab_printbin_label((const uint8_t*)"Client public key to be sent\r\n", &pubKey[2], *size - 2);
@@ -140,38 +243,168 @@ int atca_tls_create_pms_cb(WOLFSSL* ssl, unsigned char* pubKey, unsigned int* si
 }
 
 /**
- * \brief Generate random number to be required on ClientHello step of TLS.
+ * \brief Read the Device public key on the crypto task ahead of the handshake, unless it is cached already.
+ * The request completes on its own, the caller only watches request->pending.
  *
- * \param count[in]              Number of random required by WolfSSL
- * \param rand_out[out]          Pointer to store random number generated by ATECC508A
+ * \param request[out]           Request to submit, must stay valid until it has completed
+ * \return ATCA_SUCCESS          On success, request->pending is false when nothing had to be read
+ */
+int atca_tls_prefetch_device_pubkey(t_aws_crypto_request* request)
+{
+	static uint8_t pubKey[ATCA_PUB_KEY_SIZE];
+
+	if (request == NULL) return ATCA_BAD_PARAM;
+
+	request->pending = false;
+	if (atcaTlsDevicePubKeyValid) return ATCA_SUCCESS;
+
+	return aws_kit_crypto_submit(request, AWS_CRYPTO_PRIO_HIGH, atca_tls_get_pubkey_work, pubKey, atca_tls_prefetch_done, NULL);
+}
+
+/** \name Hash_DRBG behind the TLS random numbers, and the last entropy block for the health tests.
+   @{ */
+static atcac_drbg_ctx atcaTlsDrbg;
+static xSemaphoreHandle atcaTlsDrbgLock = NULL;
+static uint8_t atcaTlsLastEntropy[RANDOM_NUM_SIZE];
+/** @} */
+
+/**
+ * \brief Read entropy from the ATECC508A and run the continuous health tests on it.
+ * A block equal to the previous one means a stuck source, and the fixed FF FF 00 00 pattern
+ * is what the Random command returns while the configuration zone is unlocked.
+ *
+ * \param entropy[out]           Entropy, blocks of RANDOM_NUM_SIZE bytes
+ * \param blocks[in]             Number of blocks to read
  * \return ATCA_SUCCESS          On success
  */
-int atca_tls_get_random_number(uint32_t count, uint8_t* rand_out)
+static int atca_tls_get_entropy(uint8_t* entropy, uint8_t blocks)
 {
 	int ret = ATCA_SUCCESS;
-	uint8_t i = 0, rnd_num[RANDOM_NUM_SIZE];
-	uint32_t copy_count = 0;
+	t_atca_tls_entropy_arg arg;
+	uint8_t i, j;
+	bool unlocked;
+
+	do {
+
+		arg.entropy = entropy;
+		arg.blocks = blocks;
+		ret = aws_kit_crypto_call(AWS_CRYPTO_PRIO_HIGH, atca_tls_entropy_work, &arg);
+		if (ret != ATCA_SUCCESS) BREAK(ret, "Failed: read entropy");
+
+		for (i = 0; i < blocks; i++) {
+			for (j = 0, unlocked = true; j < RANDOM_NUM_SIZE && unlocked; j++)
+				unlocked = entropy[i * RANDOM_NUM_SIZE + j] == ((j & 0x02) ? 0x00 : 0xFF);
+			if (unlocked || memcmp(&entropy[i * RANDOM_NUM_SIZE], atcaTlsLastEntropy, RANDOM_NUM_SIZE) == 0) {
+				ret = ATCA_ASSERT_FAILURE;
+				BREAK(ret, "Failed: entropy health test");
+			}
+			memcpy(atcaTlsLastEntropy, &entropy[i * RANDOM_NUM_SIZE], RANDOM_NUM_SIZE);
+		}
+
+	} while(0);
+
+	return ret;
+}
+
+/**
+ * \brief Test and instantiate the DRBG of the TLS random numbers with entropy from the ATECC508A.
+ *
+ * \param pers[in]               Personalization string, e.g. the serial number of the ATECC508A
+ * \param pers_size[in]          Length of the personalization string
+ * \return ATCA_SUCCESS          On success
+ */
+int atca_tls_init_random(const uint8_t* pers, size_t pers_size)
+{
+	int ret = ATCA_SUCCESS;
+	uint8_t seed[2 * RANDOM_NUM_SIZE];
+
+	if (atcaTlsDrbgLock == NULL) atcaTlsDrbgLock = xSemaphoreCreateMutex();
+	if (atcaTlsDrbgLock == NULL) return ATCA_GEN_FAIL;
+	xSemaphoreTake(atcaTlsDrbgLock, portMAX_DELAY);
 
 	do {
 
-		if (rand_out == NULL) BREAK(ret, "Failed: invalid param");
+		atcac_sw_drbg_uninstantiate(&atcaTlsDrbg);
+
+		ret = atcac_sw_drbg_self_test();
+		if (ret != ATCA_SUCCESS) BREAK(ret, "Failed: DRBG self test");
+
+		/* Entropy input in the first block, nonce in the second. */
+		ret = atca_tls_get_entropy(seed, 2);
+		if (ret != ATCA_SUCCESS) break;
+
+		ret = atcac_sw_drbg_instantiate(&atcaTlsDrbg, &seed[0], RANDOM_NUM_SIZE, &seed[RANDOM_NUM_SIZE], RANDOM_NUM_SIZE,
+										pers, pers_size, ATCA_TLS_DRBG_RESEED_INTERVAL);
+		if (ret != ATCA_SUCCESS) BREAK(ret, "Failed: instantiate DRBG");
 
-		while (i < count) {
+	} while(0);
+
+	memset(seed, 0, sizeof(seed));
+	xSemaphoreGive(atcaTlsDrbgLock);
 
-			ret = atcatls_random(rnd_num);
-			if (ret != 0) BREAK(ret, "Failed: create random number");
+	return ret;
+}
 
-			copy_count = (count - i > RANDOM_NUM_SIZE) ? RANDOM_NUM_SIZE : count - i;
-			memcpy(&rand_out[i], rnd_num, copy_count);
-			i += copy_count;
+/**
+ * \brief Generate random numbers with the DRBG, which is reseeded from the ATECC508A every
+ * ATCA_TLS_DRBG_RESEED_INTERVAL requests.
+ *
+ * \param count[in]              Number of random bytes required
+ * \param rand_out[out]          Pointer to store the random bytes
+ * \return ATCA_SUCCESS          On success
+ */
+int atca_tls_get_random_number(uint32_t count, uint8_t* rand_out)
+{
+	int ret = ATCA_SUCCESS;
+	uint8_t entropy[RANDOM_NUM_SIZE];
+	uint32_t copy_count = 0;
+
+	if (rand_out == NULL || atcaTlsDrbgLock == NULL) return ATCA_BAD_PARAM;
+	xSemaphoreTake(atcaTlsDrbgLock, portMAX_DELAY);
+
+	do {
+
+		if (atcaTlsDrbg.reseed_counter == 0) {
+			ret = ATCA_FUNC_FAIL;
+			BREAK(ret, "Failed: DRBG not instantiated");
+		}
+
+		while (count > 0) {
+
+			if (atcaTlsDrbg.reseed_counter > atcaTlsDrbg.reseed_interval) {
+				ret = atca_tls_get_entropy(entropy, 1);
+				if (ret != ATCA_SUCCESS) break;
+				ret = atcac_sw_drbg_reseed(&atcaTlsDrbg, entropy, sizeof(entropy), NULL, 0);
+				memset(entropy, 0, sizeof(entropy));
+				if (ret != ATCA_SUCCESS) BREAK(ret, "Failed: reseed DRBG");
+			}
+
+			copy_count = (count > ATCA_DRBG_MAX_REQUEST_SIZE) ? ATCA_DRBG_MAX_REQUEST_SIZE : count;
+			ret = atcac_sw_drbg_generate(&atcaTlsDrbg, rand_out, copy_count, NULL, 0);
+			if (ret != ATCA_SUCCESS) BREAK(ret, "Failed: create random number");
+			rand_out += copy_count;
+			count -= copy_count;
 		}
-		atcab_printbin_label((const uint8_t*)"Random Number\r\n", rand_out, count);
 
 	} while(0);
 
+	xSemaphoreGive(atcaTlsDrbgLock);
+
 	return ret;
 }
 
+/**
+ * \brief Random block generator of WolfSSL, see CUSTOM_RAND_GENERATE_BLOCK.
+ *
+ * \param output[out]            Pointer to store the random bytes
+ * \param sz[in]                 Number of random bytes required
+ * \return 0                     On success
+ */
+int atca_tls_random_block(byte* output, word32 sz)
+{
+	return atca_tls_get_random_number(sz, output) == ATCA_SUCCESS ? 0 : RNG_FAILURE_E;
+}
+
 /**
  * \brief Get signer public key to build device certificate..
  *
@@ -185,11 +418,15 @@ int atca_tls_get_signer_public_key(uint8_t *pubKey)
 	uint8_t paddedPubKey[96];
 
 	memset(paddedPubKey, 0x00, sizeof(paddedPubKey));
+	ret = atcab_session_begin();
+	if (ret != ATCA_SUCCESS) return ret;
 	for (; start_block < end_block; start_block++) {
 		ret = atcab_read_zone(DEVZONE_DATA, TLS_SLOT_SIGNER_PUBKEY, 
 							start_block, 0, &paddedPubKey[(start_block - 0) * 32], 32);
-		if (ret != ATCA_SUCCESS) return ret;
+		if (ret != ATCA_SUCCESS) break;
 	}
+	atcab_session_end();
+	if (ret != ATCA_SUCCESS) return ret;
 
 	memcpy(&pubKey[32], &paddedPubKey[40], 32);
 	memcpy(&pubKey[0], &paddedPubKey[4], 32);
@@ -212,7 +449,7 @@ int atca_tls_build_signer_cert(t_atcert* cert)
 
 		if (cert->signer_der == NULL || cert->signer_pem == NULL) BREAK(ret, "Failed: invalid param");
 
-		ret = atcatls_get_cert(&g_cert_def_1_signer, NULL, cert->signer_der, (size_t*)&cert->signer_der_size);
+		ret = atcacert_read_cert_compiled(&g_cert_def_1_signer, cert_def_1_signer_build, NULL, cert->signer_der, (size_t*)&cert->signer_der_size);
 		if (ret != ATCACERT_E_SUCCESS) BREAK(ret, "Failed: read signer certificate");
 		atcab_printbin_label((const uint8_t*)"Signer DER certficate\r\n", cert->signer_der, cert->signer_der_size);	
 
@@ -244,7 +481,7 @@ int atca_tls_build_device_cert(t_atcert* cert)
 
 		if (cert->device_der == NULL || cert->device_pem == NULL) BREAK(ret, "Failed: invalid param");
 
-		ret = atcatls_get_cert(&g_cert_def_2_device, cert->signer_pubkey, cert->device_der, (size_t*)&cert->device_der_size);
+		ret = atcacert_read_cert_compiled(&g_cert_def_2_device, cert_def_2_device_build, cert->signer_pubkey, cert->device_der, (size_t*)&cert->device_der_size);
 		if (ret != ATCACERT_E_SUCCESS) BREAK(ret, "Failed: read device certificate");
 		atcab_printbin_label((const uint8_t*)"Device DER certificate\r\n", cert->device_der, cert->device_der_size);
 
@@ -256,11 +493,208 @@ int atca_tls_build_device_cert(t_atcert* cert)
 		if (ret != ATCACERT_E_SUCCESS) BREAK(ret, "Failed: read device public key");
 		atcab_printbin_label((const uint8_t*)"Device public key\r\n", cert->device_pubkey, ATCERT_PUBKEY_SIZE);
 
+		/* The public key of the certificate was just computed by GenKey on slot 0. */
+		atca_tls_cache_device_pubkey(cert->device_pubkey);
+
 	} while(0);
 	
 	return ret;
 }
 
+/**
+ * \brief Get the issue date of the device certificate built by atca_tls_build_device_cert.
+ *
+ * \param cert[in]               Certificate structure holding the device DER certificate
+ * \param issue_date[out]        Issue date of the device certificate
+ * \return ATCA_SUCCESS          On success
+ */
+int atca_tls_get_device_issue_date(t_atcert* cert, atcacert_tm_utc_t* issue_date)
+{
+	int ret = ATCA_BAD_PARAM;
+
+	do {
+
+		if (cert == NULL || cert->device_der == NULL || issue_date == NULL) BREAK(ret, "Failed: invalid param");
+
+		ret = atcacert_get_issue_date(&g_cert_def_2_device, cert->device_der, cert->device_der_size, issue_date);
+		if (ret != ATCACERT_E_SUCCESS) BREAK(ret, "Failed: read issue date");
+
+	} while(0);
+
+	return ret;
+}
+
+/**
+ * \brief Hash the device data of one certificate definition, except public keys computed by GenKey.
+ *
+ * \param ctx[inout]             SHA-256 context
+ * \param cert_def[in]           Certificate definition
+ * \return ATCA_SUCCESS          On success
+ */
+static int atca_tls_hash_cert_locs(atcac_sha2_256_ctx* ctx, const atcacert_def_t* cert_def)
+{
+	int ret = ATCA_SUCCESS;
+	atcacert_device_loc_t device_locs[16];
+	size_t device_locs_count = 0, i;
+	uint8_t block, loc[6], data[ATCA_BLOCK_SIZE];
+
+	ret = atcacert_get_device_locs(cert_def, device_locs, &device_locs_count,
+								sizeof(device_locs) / sizeof(device_locs[0]), ATCA_BLOCK_SIZE);
+	if (ret != ATCACERT_E_SUCCESS) return ret;
+
+	for (i = 0; i < device_locs_count; i++) {
+		/* The public key of a private key slot only changes with the compressed certificate. */
+		if (device_locs[i].zone == DEVZONE_DATA && device_locs[i].is_genkey) continue;
+
+		loc[0] = (uint8_t)device_locs[i].zone;
+		loc[1] = device_locs[i].slot;
+		loc[2] = (uint8_t)(device_locs[i].offset >> 8);
+		loc[3] = (uint8_t)device_locs[i].offset;
+		loc[4] = (uint8_t)(device_locs[i].count >> 8);
+		loc[5] = (uint8_t)device_locs[i].count;
+		atcac_sw_sha2_256_update(ctx, loc, sizeof(loc));
+		for (block = device_locs[i].offset / ATCA_BLOCK_SIZE;
+			 block < (device_locs[i].offset + device_locs[i].count) / ATCA_BLOCK_SIZE; block++) {
+			ret = atcab_read_zone(device_locs[i].zone, device_locs[i].slot, block, 0, data, ATCA_BLOCK_SIZE);
+			if (ret != ATCA_SUCCESS) return ret;
+			atcac_sw_sha2_256_update(ctx, data, sizeof(data));
+		}
+	}
+
+	return ret;
+}
+
+/**
+ * \brief Compute a digest of everything the signer and device certificates are rebuilt from.
+ * The serial number and the compressed certificate slots go into the digest, so it changes
+ * whenever the kit is provisioned with other certificates.
+ *
+ * \param digest[out]            32 bytes digest
+ * \return ATCA_SUCCESS          On success
+ */
+int atca_tls_get_cert_digest(uint8_t* digest)
+{
+	int ret = ATCA_SUCCESS;
+	atcac_sha2_256_ctx ctx;
+	uint8_t serial[ATCA_SERIAL_NUM_SIZE];
+
+	do {
+
+		if (digest == NULL) BREAK(ret, "Failed: invalid param");
+
+		ret = atcab_session_begin();
+		if (ret != ATCA_SUCCESS) BREAK(ret, "Failed: wake device");
+
+		atcac_sw_sha2_256_init(&ctx);
+		ret = atcab_read_serial_number(serial);
+		if (ret == ATCA_SUCCESS) {
+			atcac_sw_sha2_256_update(&ctx, serial, sizeof(serial));
+			ret = atca_tls_hash_cert_locs(&ctx, &g_cert_def_1_signer);
+		}
+		if (ret == ATCA_SUCCESS)
+			ret = atca_tls_hash_cert_locs(&ctx, &g_cert_def_2_device);
+		atcab_session_end();
+		if (ret != ATCA_SUCCESS) BREAK(ret, "Failed: read certificate data");
+
+		atcac_sw_sha2_256_finish(&ctx, digest);
+
+	} while(0);
+
+	return ret;
+}
+
+/**
+ * \brief Encode a raw R and S signature as the DER ECDSA-Sig-Value SEQUENCE expected by WolfSSL.
+ * R and S are 32 bytes each, so every length fits in one byte and the SEQUENCE is at most 72 bytes.
+ *
+ * \param raw_sig[in]            64 bytes signature, R followed by S
+ * \param der_sig[out]           DER encoded signature
+ * \param der_sig_size[inout]    Size of der_sig as input, and length of the encoded signature as output
+ * \return ATCA_SUCCESS          On success
+ */
+static int atca_tls_der_enc_sig(const uint8_t* raw_sig, uint8_t* der_sig, word32* der_sig_size)
+{
+	int ret = ATCA_SUCCESS;
+	size_t r_size = 0, s_size = 0;
+
+	do {
+
+		/* A zero R or S is not a valid signature. */
+		for (r_size = 0; r_size < ATCA_KEY_SIZE && raw_sig[r_size] == 0; r_size++);
+		for (s_size = 0; s_size < ATCA_KEY_SIZE && raw_sig[ATCA_KEY_SIZE + s_size] == 0; s_size++);
+		if (r_size == ATCA_KEY_SIZE || s_size == ATCA_KEY_SIZE) {
+			ret = ATCA_BAD_PARAM;
+			BREAK(ret, "Failed: zero R or S");
+		}
+
+		r_size = *der_sig_size > 2 ? *der_sig_size - 2 : 0;
+		ret = atcacert_der_enc_integer(&raw_sig[0], ATCA_KEY_SIZE, TRUE, &der_sig[2], &r_size);
+		if (ret != ATCACERT_E_SUCCESS) BREAK(ret, "Failed: encode R");
+
+		s_size = *der_sig_size - 2 - r_size;
+		ret = atcacert_der_enc_integer(&raw_sig[ATCA_KEY_SIZE], ATCA_KEY_SIZE, TRUE, &der_sig[2 + r_size], &s_size);
+		if (ret != ATCACERT_E_SUCCESS) BREAK(ret, "Failed: encode S");
+
+		der_sig[0] = 0x30;
+		der_sig[1] = (uint8_t)(r_size + s_size);
+		*der_sig_size = (word32)(2 + r_size + s_size);
+
+	} while(0);
+
+	return ret;
+}
+
+/**
+ * \brief Decode a DER ECDSA-Sig-Value SEQUENCE to raw R and S, each left padded to 32 bytes.
+ *
+ * \param der_sig[in]            DER encoded signature
+ * \param der_sig_size[in]       Length of the encoded signature
+ * \param raw_sig[out]           64 bytes signature, R followed by S
+ * \return ATCA_SUCCESS          On success
+ */
+static int atca_tls_der_dec_sig(const uint8_t* der_sig, word32 der_sig_size, uint8_t* raw_sig)
+{
+	int ret = ATCA_SUCCESS;
+	uint8_t integer[ATCA_KEY_SIZE + 1];
+	size_t der_int_size, int_size, curr_idx = 2, i;
+
+	do {
+
+		if (der_sig_size < 2 || der_sig[0] != 0x30 || der_sig[1] != der_sig_size - 2) {
+			ret = ATCACERT_E_DECODING_ERROR;
+			BREAK(ret, "Failed: invalid signature sequence");
+		}
+
+		for (i = 0; i < 2; i++) {
+			der_int_size = der_sig_size - curr_idx;
+			int_size = sizeof(integer);
+			ret = atcacert_der_dec_integer(&der_sig[curr_idx], &der_int_size, integer, &int_size);
+			if (ret != ATCACERT_E_SUCCESS) BREAK(ret, "Failed: decode integer");
+			curr_idx += der_int_size;
+
+			/* Drop the padding byte of an unsigned integer and right align the value. */
+			if (int_size == ATCA_KEY_SIZE + 1) {
+				if (integer[0] != 0x00) {
+					ret = ATCACERT_E_DECODING_ERROR;
+					BREAK(ret, "Failed: integer too large");
+				}
+				memcpy(&raw_sig[i * ATCA_KEY_SIZE], &integer[1], ATCA_KEY_SIZE);
+			} else {
+				memset(&raw_sig[i * ATCA_KEY_SIZE], 0, ATCA_KEY_SIZE - int_size);
+				memcpy(&raw_sig[i * ATCA_KEY_SIZE + ATCA_KEY_SIZE - int_size], integer, int_size);
+			}
+		}
+		if (ret != ATCACERT_E_SUCCESS) break;
+		if (curr_idx != der_sig_size) {
+			ret = ATCACERT_E_DECODING_ERROR;
+			BREAK(ret, "Failed: trailing signature data");
+		}
+
+	} while(0);
+
+	return ret;
+}
+
 /**
  * \brief Sign input digest computed in SHA256 on SeverKeyExchange step of TLS.
  *
@@ -277,44 +711,22 @@ int atca_tls_build_device_cert(t_atcert* cert)
 int atca_tls_sign_certificate_cb(WOLFSSL* ssl, const byte* in, word32 inSz, byte* out, word32* outSz, const byte* key, word32 keySz, void* ctx)
 {
 	int ret = ATCA_SUCCESS;
-	mp_int r, s;
+	uint8_t raw_signature[ATCA_SIG_SIZE];
+	t_atca_tls_sign_arg sign;
 
 	do {
 
 		if (in == NULL || out == NULL || outSz == NULL) BREAK(ret, "Failed: invalid param");
 
 		/* Sign the input digest with the private key in slot 0. */
-		ret = atcatls_sign(TLS_SLOT_AUTH_PRIV, in, out);
+		sign.digest = in;
+		sign.signature = raw_signature;
+		ret = aws_kit_crypto_call(AWS_CRYPTO_PRIO_HIGH, atca_tls_sign_work, &sign);
 		if (ret != ATCA_SUCCESS) BREAK(ret, "Failed: sign digest");
 
-		ret = mp_init_multi(&r, &s, NULL, NULL, NULL, NULL);
-		if (ret != MP_OKAY) BREAK(ret, "Failed: init R and S");
-
-		/* Load R and S. */    
-		ret = mp_read_unsigned_bin(&r, &out[0], ATCA_KEY_SIZE);
-		if (ret != MP_OKAY) {
-			goto exit_sign;
-		}
-		ret = mp_read_unsigned_bin(&s, &out[ATCA_KEY_SIZE], ATCA_KEY_SIZE);
-		if (ret != MP_OKAY) {
-			goto exit_sign;
-		}
-
-	    /* Check for zeros */
-		if (mp_iszero(&r) || mp_iszero(&s)) {
-			ret = -1;
-			goto exit_sign;        
-		}
-
-		/* convert mp_ints to ECDSA sig, initializes r and s internally */
-		ret = StoreECC_DSA_Sig(out, outSz, &r, &s);
-		if (ret != MP_OKAY) {
-			goto exit_sign;      
-		}
-
-exit_sign:
-		mp_clear(&r);
-		mp_clear(&s);
+		/* Convert R and S to ECDSA sig. */
+		ret = atca_tls_der_enc_sig(raw_signature, out, outSz);
+		if (ret != ATCA_SUCCESS) BREAK(ret, "Failed: encode signature");
 
 		atcab_printbin_label((const uint8_t*)"Der Encoded Signature\r\n", out, *outSz);
 
@@ -342,34 +754,22 @@ int atca_tls_verify_signature_cb(WOLFSSL* ssl, const byte* sig, word32 sigSz, co
 	int ret = ATCA_SUCCESS;
 	bool verified = FALSE;
 	uint8_t raw_sigature[ATCA_SIG_SIZE];	
-	mp_int r, s;
+	t_atca_tls_verify_arg verify;
 
 	do {
 
 		if (key == NULL || sig == NULL || hash == NULL || result == NULL) BREAK(ret, "Failed: invalid param");
 
-	    memset(&r, 0, sizeof(r));
-	    memset(&s, 0, sizeof(s));
-
-		/* Decode ASN.1 formatted signature. */
-	    ret = DecodeECC_DSA_Sig(sig, sigSz, &r, &s);
-	    if (ret != MP_OKAY) {
-	        return -1;
-	    }
-
-	    /* Extract R and S. */
-	    ret = mp_to_unsigned_bin(&r, &raw_sigature[0]);
-	    if (ret != MP_OKAY) {
-	        goto exit_verify;
-	    }
-
-	    ret = mp_to_unsigned_bin(&s, &raw_sigature[ATCA_KEY_SIZE]);
-	    if (ret != MP_OKAY) {
-	        goto exit_verify;
-	    }
+		/* Decode ASN.1 formatted signature to R and S. */
+		ret = atca_tls_der_dec_sig(sig, sigSz, raw_sigature);
+		if (ret != ATCA_SUCCESS) BREAK(ret, "Failed: decode signature");
 
         /* Verify the signature extracted in 64 bytes length. */
-		ret = atcatls_verify(hash, raw_sigature, key + 1, &verified);
+		verify.digest = hash;
+		verify.signature = raw_sigature;
+		verify.pubKey = key + 1;
+		verify.verified = &verified;
+		ret = aws_kit_crypto_call(AWS_CRYPTO_PRIO_HIGH, atca_tls_verify_work, &verify);
 		if (ret != 0 || (verified != TRUE)) { 
 			BREAK(ret, "Failed: verify signature");
 		} else { 
@@ -377,10 +777,6 @@ int atca_tls_verify_signature_cb(WOLFSSL* ssl, const byte* sig, word32 sigSz, co
 			BREAK(ret, "Verified: signature");
 		}
 
-exit_verify:
-		mp_clear(&r);
-		mp_clear(&s);
-
 	} while(0);
 
 	return ret;
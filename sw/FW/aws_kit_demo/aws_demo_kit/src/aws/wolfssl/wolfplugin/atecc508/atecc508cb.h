@@ -53,6 +53,8 @@ extern "C" {
 #include <wolfssl/ssl.h>
 #include <wolfssl/wolfcrypt/memory.h>
 #include "cryptoauthlib.h"
+#include "atcacert/atcacert_date.h"
+#include "aws_kit_crypto.h"
 
 /**
  * \defgroup Interface between WolfSSL library and CryptoAuthLib.
@@ -66,6 +68,14 @@ extern "C" {
 #define PEM_CERT_INIT_SIZE						(1024)
 #define PEM_CERT_CHAIN_INIT_SIZE				(2048)
 #define ATCERT_PUBKEY_SIZE						(64)
+#define ATCERT_DIGEST_SIZE						(32)
+/** @} */
+
+/** \name Random numbers of the TLS library, generated by a Hash_DRBG seeded from the ATECC508A.
+   @{ */
+#ifndef ATCA_TLS_DRBG_RESEED_INTERVAL
+#define ATCA_TLS_DRBG_RESEED_INTERVAL			(256)	/**< Generate requests before the DRBG is reseeded from the ATECC508A. */
+#endif
 /** @} */
 
 /** \name Certificate structure definition.
@@ -88,10 +98,15 @@ typedef struct {
 ATCA_STATUS atca_tls_set_enc_key(uint8_t* outKey, uint16_t keysize);
 int atca_tls_init_enc_key(void);
 int atca_tls_create_pms_cb(WOLFSSL* ssl, unsigned char* pubKey, unsigned int* size, unsigned char inOut);
+int atca_tls_prefetch_device_pubkey(t_aws_crypto_request* request);
+int atca_tls_init_random(const uint8_t* pers, size_t pers_size);
 int atca_tls_get_random_number(uint32_t count, uint8_t* rand_out);
+int atca_tls_random_block(byte* output, word32 sz);
 int atca_tls_get_signer_public_key(uint8_t *pubKey);
 int atca_tls_build_signer_cert(t_atcert* cert);
 int atca_tls_build_device_cert(t_atcert* cert);
+int atca_tls_get_device_issue_date(t_atcert* cert, atcacert_tm_utc_t* issue_date);
+int atca_tls_get_cert_digest(uint8_t* digest);
 int atca_tls_sign_certificate_cb(WOLFSSL* ssl, const byte* in, word32 inSz, byte* out, word32* outSz, const byte* key, word32 keySz, void* ctx);
 int atca_tls_verify_signature_cb(WOLFSSL* ssl, const byte* sig, word32 sigSz, const byte* hash, word32 hashSz, const byte* key, word32 keySz, int* result, void* ctx);
 
@@ -0,0 +1,88 @@
+// Generated by cert_def_compile from g_cert_def_1_signer, do not edit.
+
+#include <string.h>
+#include "cert_def_1_signer_build.h"
+#include "cert_def_1_signer.h"
+#include "atcacert/atcacert_der.h"
+#include "atcacert/atcacert_date.h"
+#include "crypto/atca_crypto_sw_sha2.h"
+
+static const char g_hex_digits[] = "0123456789ABCDEF";
+
+int cert_def_1_signer_build(const atcacert_build_data_t* data, uint8_t* cert, size_t* cert_size)
+{
+	int ret = 0;
+	size_t sig_size = 75;
+	size_t cert_length = 0;
+	atcacert_tm_utc_t issue_date;
+	atcacert_tm_utc_t expire_date;
+	uint8_t msg[64 + 3];
+	uint8_t sn[32];
+
+	if (data == NULL || data->public_key == NULL || data->comp_cert == NULL || cert == NULL || cert_size == NULL)
+		return ATCACERT_E_BAD_PARAMS;
+	if (data->elements == NULL)
+		return ATCACERT_E_BAD_PARAMS;
+
+	if (*cert_size < CERT_DEF_1_SIGNER_MAX_SIZE) {
+		*cert_size = CERT_DEF_1_SIGNER_MAX_SIZE;
+		return ATCACERT_E_BUFFER_TOO_SMALL;
+	}
+
+	// Format 0, template ID 1, chain ID 0, SN source 0xA
+	if ((data->comp_cert[70] & 0x0F) != 0)
+		return ATCACERT_E_DECODING_ERROR;
+	if (data->comp_cert[69] != 0x10 || (data->comp_cert[70] >> 4) != 0xA)
+		return ATCACERT_E_WRONG_CERT_DEF;
+
+	// Everything in front of the signature comes from the template
+	memcpy(cert, g_cert_def_1_signer.cert_template, 427);
+	ret = atcacert_der_enc_ecdsa_sig_value(&data->comp_cert[0], &cert[427], &sig_size);
+	if (ret != ATCACERT_E_SUCCESS)
+		return ret;
+	*cert_size = 427 + sig_size;
+	cert_length = *cert_size - 4;
+	cert[2] = (uint8_t)(cert_length >> 8);
+	cert[3] = (uint8_t)(cert_length & 0xFF);
+
+	if (data->ca_public_key != NULL) {
+		ret = atcacert_get_key_id(data->ca_public_key, &cert[395]);
+		if (ret != ATCACERT_E_SUCCESS)
+			return ret;
+	}
+
+	memcpy(&cert[247], data->public_key, 64);
+	ret = atcacert_get_key_id(data->public_key, &cert[362]);
+	if (ret != ATCACERT_E_SUCCESS)
+		return ret;
+
+	ret = atcacert_date_dec_compcert(&data->comp_cert[64], DATEFMT_RFC5280_GEN, &issue_date, &expire_date);
+	if (ret != ATCACERT_E_SUCCESS)
+		return ret;
+	ret = atcacert_date_enc_rfc5280_utc(&issue_date, &cert[117]);
+	if (ret != ATCACERT_E_SUCCESS)
+		return ret;
+	ret = atcacert_date_enc_rfc5280_gen(&expire_date, &cert[132]);
+	if (ret != ATCACERT_E_SUCCESS)
+		return ret;
+	cert[216] = g_hex_digits[data->comp_cert[67] >> 4];
+	cert[217] = g_hex_digits[data->comp_cert[67] & 0x0F];
+	cert[218] = g_hex_digits[data->comp_cert[68] >> 4];
+	cert[219] = g_hex_digits[data->comp_cert[68] & 0x0F];
+
+	memcpy(&cert[395], data->elements[0], 20); // aid
+
+	// Serial number is SHA256(public key + encoded dates)
+	memcpy(&msg[0], data->public_key, 64);
+	ret = atcacert_date_enc_compcert(&issue_date, 0, &msg[64]);
+	if (ret != ATCACERT_E_SUCCESS)
+		return ret;
+	ret = atcac_sw_sha2_256(msg, 64 + 3, sn);
+	if (ret != ATCACERT_E_SUCCESS)
+		return ret;
+	sn[0] &= 0x7F;
+	sn[0] |= 0x40;
+	memcpy(&cert[15], sn, 16);
+
+	return ATCACERT_E_SUCCESS;
+}
@@ -0,0 +1,467 @@
+/** \file cert_def_compile.c
+* \brief host tool compiling certificate definitions into straight-line builders
+*
+* Copyright (c) 2015 Atmel Corporation. All rights reserved.
+*
+* \asf_license_start
+*
+* \page License
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice,
+*    this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* 3. The name of Atmel may not be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*
+* 4. This software may only be redistributed and used in connection with an
+*    Atmel microcontroller product.
+*
+* THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+* EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+* ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* \asf_license_stop
+ */ 
+
+
+
+/*
+ * Turns certificate definitions into builders that copy the template and patch the dynamic
+ * elements at their fixed offsets, instead of looking every element up in the definition at run
+ * time. The generated <name>_build.c and <name>_build.h are checked in next to the definitions and
+ * must be regenerated whenever a definition changes. Build and run on the host, e.g. from the
+ * certs directory of the firmware:
+ *
+ *   gcc -I../cryptoauthlib/lib -I. -o cert_def_compile ../cryptoauthlib/app/cert_def_compile.c \
+ *       cert_def_1_signer.c cert_def_2_device.c
+ *   ./cert_def_compile
+ *
+ * Define CERT_DEF_COMPILE_TEST to compile the definitions of the atcacert tests instead.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include "atcacert/atcacert_def.h"
+#ifdef CERT_DEF_COMPILE_TEST
+#include "test_cert_def_0_device.h"
+#include "test_cert_def_1_signer.h"
+#else
+#include "cert_def_1_signer.h"
+#include "cert_def_2_device.h"
+#endif
+
+// Largest DER signature: BIT STRING header (3), SEQUENCE header (2) and two 33 byte INTEGERs
+#define DER_SIG_MAX_SIZE    75
+// Smallest DER signature: same headers and two 1 byte INTEGERs
+#define DER_SIG_MIN_SIZE    11
+// Certificate SEQUENCE tag with a 2 byte length
+#define CERT_HEADER_SIZE    4
+
+typedef struct {
+    const atcacert_def_t* cert_def;
+    const char*           name;     // Definition name without the g_ prefix, also names the files
+} cert_def_entry_t;
+
+static const cert_def_entry_t g_cert_defs[] = {
+#ifdef CERT_DEF_COMPILE_TEST
+    { &g_test_cert_def_0_device, "test_cert_def_0_device" },
+    { &g_test_cert_def_1_signer, "test_cert_def_1_signer" },
+#else
+    { &g_cert_def_1_signer, "cert_def_1_signer" },
+    { &g_cert_def_2_device, "cert_def_2_device" },
+#endif
+};
+
+static const char* const g_date_enc_funcs[] = {
+    "atcacert_date_enc_iso8601_sep",
+    "atcacert_date_enc_rfc5280_utc",
+    "atcacert_date_enc_posix_uint32_be",
+    "atcacert_date_enc_posix_uint32_le",
+    "atcacert_date_enc_rfc5280_gen"
+};
+
+static const char* const g_date_formats[] = {
+    "DATEFMT_ISO8601_SEP",
+    "DATEFMT_RFC5280_UTC",
+    "DATEFMT_POSIX_UINT32_BE",
+    "DATEFMT_POSIX_UINT32_LE",
+    "DATEFMT_RFC5280_GEN"
+};
+
+static int is_device_sn_source(atcacert_cert_sn_src_t sn_source)
+{
+    return sn_source == SNSRC_DEVICE_SN || sn_source == SNSRC_DEVICE_SN_HASH
+           || sn_source == SNSRC_DEVICE_SN_HASH_POS || sn_source == SNSRC_DEVICE_SN_HASH_RAW;
+}
+
+static int is_hash_sn_source(atcacert_cert_sn_src_t sn_source)
+{
+    return sn_source == SNSRC_PUB_KEY_HASH || sn_source == SNSRC_PUB_KEY_HASH_POS || sn_source == SNSRC_PUB_KEY_HASH_RAW
+           || sn_source == SNSRC_DEVICE_SN_HASH || sn_source == SNSRC_DEVICE_SN_HASH_POS || sn_source == SNSRC_DEVICE_SN_HASH_RAW;
+}
+
+/** \brief Checks a definition only uses what a compiled builder can patch at fixed offsets.
+ *
+ * Every element has to sit in the TBS part in front of the signature, so the template offsets are
+ * still valid once the signature changes size.
+ */
+static int check_cert_def(const atcacert_def_t* cert_def, const char* name)
+{
+    const atcacert_cert_loc_t* locs = cert_def->std_cert_elements;
+    size_t sig_offset = locs[STDCERT_SIGNATURE].offset;
+    size_t cert_length = 0;
+    size_t i = 0;
+
+    if (cert_def->type != CERTTYPE_X509) {
+        fprintf(stderr, "%s: only X.509 certificates can be compiled\n", name);
+        return -1;
+    }
+    if (cert_def->sn_source == SNSRC_STORED_DYNAMIC) {
+        fprintf(stderr, "%s: dynamic serial numbers move the elements behind them\n", name);
+        return -1;
+    }
+    if (cert_def->template_id > 0x0F || cert_def->chain_id > 0x0F) {
+        fprintf(stderr, "%s: template and chain IDs are 4-bit values\n", name);
+        return -1;
+    }
+    if (cert_def->cert_template_size < CERT_HEADER_SIZE || cert_def->cert_template[0] != 0x30 || cert_def->cert_template[1] != 0x82) {
+        fprintf(stderr, "%s: template has to start with a SEQUENCE with a 2 byte length\n", name);
+        return -1;
+    }
+    if (sig_offset + 2 > cert_def->cert_template_size || cert_def->cert_template[sig_offset] != 0x03
+        || sig_offset + 2 + cert_def->cert_template[sig_offset + 1] != cert_def->cert_template_size) {
+        fprintf(stderr, "%s: signature has to end the template\n", name);
+        return -1;
+    }
+    cert_length = sig_offset + DER_SIG_MIN_SIZE - CERT_HEADER_SIZE;
+    if (cert_length < 0x100 || sig_offset + DER_SIG_MAX_SIZE - CERT_HEADER_SIZE > 0xFFFF) {
+        fprintf(stderr, "%s: certificate length has to stay 2 bytes for any signature\n", name);
+        return -1;
+    }
+    if (locs[STDCERT_PUBLIC_KEY].count != 64 || cert_def->comp_cert_dev_loc.count != 72) {
+        fprintf(stderr, "%s: public key and compressed certificate are required\n", name);
+        return -1;
+    }
+    if (locs[STDCERT_AUTH_KEY_ID].count != 0 && locs[STDCERT_AUTH_KEY_ID].count != 20) {
+        fprintf(stderr, "%s: unexpected authority key ID size\n", name);
+        return -1;
+    }
+    if (locs[STDCERT_SUBJ_KEY_ID].count != 0 && locs[STDCERT_SUBJ_KEY_ID].count != 20) {
+        fprintf(stderr, "%s: unexpected subject key ID size\n", name);
+        return -1;
+    }
+    if (locs[STDCERT_SIGNER_ID].count != 0 && locs[STDCERT_SIGNER_ID].count != 4) {
+        fprintf(stderr, "%s: unexpected signer ID size\n", name);
+        return -1;
+    }
+    if (cert_def->issue_date_format > DATEFMT_RFC5280_GEN || cert_def->expire_date_format > DATEFMT_RFC5280_GEN
+        || (locs[STDCERT_ISSUE_DATE].count != 0 && locs[STDCERT_ISSUE_DATE].count != ATCACERT_DATE_FORMAT_SIZES[cert_def->issue_date_format])
+        || (locs[STDCERT_EXPIRE_DATE].count != 0 && locs[STDCERT_EXPIRE_DATE].count != ATCACERT_DATE_FORMAT_SIZES[cert_def->expire_date_format])) {
+        fprintf(stderr, "%s: unexpected date size\n", name);
+        return -1;
+    }
+    if (cert_def->cert_sn_dev_loc.zone != DEVZONE_NONE && cert_def->cert_sn_dev_loc.count != 0
+        && cert_def->cert_sn_dev_loc.count != locs[STDCERT_CERT_SN].count) {
+        fprintf(stderr, "%s: stored serial number size doesn't match the template\n", name);
+        return -1;
+    }
+    if (locs[STDCERT_CERT_SN].count != 0) {
+        if ((cert_def->sn_source == SNSRC_DEVICE_SN && locs[STDCERT_CERT_SN].count != 1 + 9)
+            || (cert_def->sn_source == SNSRC_SIGNER_ID && locs[STDCERT_CERT_SN].count != 1 + 2)
+            || (is_hash_sn_source(cert_def->sn_source) && locs[STDCERT_CERT_SN].count > 32)) {
+            fprintf(stderr, "%s: unexpected serial number size\n", name);
+            return -1;
+        }
+        if (is_hash_sn_source(cert_def->sn_source) && locs[STDCERT_ISSUE_DATE].count == 0) {
+            fprintf(stderr, "%s: hashed serial numbers need the issue date\n", name);
+            return -1;
+        }
+    }
+
+    for (i = 0; i < STDCERT_NUM_ELEMENTS; i++) {
+        if (i != STDCERT_SIGNATURE && locs[i].count != 0 && locs[i].offset + locs[i].count > sig_offset) {
+            fprintf(stderr, "%s: standard element %u is not in front of the signature\n", name, (unsigned)i);
+            return -1;
+        }
+    }
+    for (i = 0; i < cert_def->cert_elements_count; i++) {
+        const atcacert_cert_element_t* element = &cert_def->cert_elements[i];
+        if (element->device_loc.count != element->cert_loc.count || element->cert_loc.offset + element->cert_loc.count > sig_offset) {
+            fprintf(stderr, "%s: element %s can't be patched at a fixed offset\n", name, element->id);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static void emit_header(FILE* out, const cert_def_entry_t* entry, const char* guard)
+{
+    const atcacert_def_t* cert_def = entry->cert_def;
+
+    fprintf(out, "// Generated by cert_def_compile from g_%s, do not edit.\n\n", entry->name);
+    fprintf(out, "#ifndef %s_BUILD_H\n", guard);
+    fprintf(out, "#define %s_BUILD_H\n\n", guard);
+    fprintf(out, "#include \"atcacert/atcacert_def.h\"\n\n");
+    fprintf(out, "#ifdef __cplusplus\nextern \"C\" {\n#endif\n\n");
+    fprintf(out, "//! Buffer size that holds the certificate with the largest signature\n");
+    fprintf(out, "#define %s_MAX_SIZE (%u + %u)\n\n", guard, cert_def->std_cert_elements[STDCERT_SIGNATURE].offset, DER_SIG_MAX_SIZE);
+    fprintf(out, "/**\n");
+    fprintf(out, " * \\brief Rebuilds the g_%s certificate from the device data.\n", entry->name);
+    fprintf(out, " *\n");
+    fprintf(out, " * \\param[in]    data       Device data of the certificate.\n");
+    fprintf(out, " * \\param[out]   cert       Buffer to received the certificate.\n");
+    fprintf(out, " * \\param[inout] cert_size  As input, the size of the cert buffer in bytes.\n");
+    fprintf(out, " *                          As output, the size of the certificate returned in cert in bytes.\n");
+    fprintf(out, " *\n");
+    fprintf(out, " * \\return 0 on success\n");
+    fprintf(out, " */\n");
+    fprintf(out, "int %s_build(const atcacert_build_data_t* data, uint8_t* cert, size_t* cert_size);\n\n", entry->name);
+    fprintf(out, "#ifdef __cplusplus\n}\n#endif\n\n");
+    fprintf(out, "#endif // %s_BUILD_H\n", guard);
+}
+
+static void emit_source(FILE* out, const cert_def_entry_t* entry, const char* guard)
+{
+    const atcacert_def_t* cert_def = entry->cert_def;
+    const atcacert_cert_loc_t* locs = cert_def->std_cert_elements;
+    unsigned sig_offset = locs[STDCERT_SIGNATURE].offset;
+    unsigned sn_offset = locs[STDCERT_CERT_SN].offset;
+    unsigned sn_count = locs[STDCERT_CERT_SN].count;
+    int is_hash_sn = sn_count != 0 && is_hash_sn_source(cert_def->sn_source);
+    int is_device_sn = sn_count != 0 && is_device_sn_source(cert_def->sn_source);
+    int is_stored_sn = cert_def->cert_sn_dev_loc.zone != DEVZONE_NONE && cert_def->cert_sn_dev_loc.count != 0;
+    size_t i = 0;
+
+    fprintf(out, "// Generated by cert_def_compile from g_%s, do not edit.\n\n", entry->name);
+    fprintf(out, "#include <string.h>\n");
+    fprintf(out, "#include \"%s_build.h\"\n", entry->name);
+    fprintf(out, "#include \"%s.h\"\n", entry->name);
+    fprintf(out, "#include \"atcacert/atcacert_der.h\"\n");
+    fprintf(out, "#include \"atcacert/atcacert_date.h\"\n");
+    if (is_hash_sn)
+        fprintf(out, "#include \"crypto/atca_crypto_sw_sha2.h\"\n");
+    fprintf(out, "\n");
+    if (locs[STDCERT_SIGNER_ID].count != 0)
+        fprintf(out, "static const char g_hex_digits[] = \"0123456789ABCDEF\";\n\n");
+
+    fprintf(out, "int %s_build(const atcacert_build_data_t* data, uint8_t* cert, size_t* cert_size)\n", entry->name);
+    fprintf(out, "{\n");
+    fprintf(out, "\tint ret = 0;\n");
+    fprintf(out, "\tsize_t sig_size = %u;\n", DER_SIG_MAX_SIZE);
+    fprintf(out, "\tsize_t cert_length = 0;\n");
+    fprintf(out, "\tatcacert_tm_utc_t issue_date;\n");
+    fprintf(out, "\tatcacert_tm_utc_t expire_date;\n");
+    if (is_hash_sn) {
+        fprintf(out, "\tuint8_t msg[64 + 3];\n");
+        fprintf(out, "\tuint8_t sn[32];\n");
+    }
+    fprintf(out, "\n");
+
+    fprintf(out, "\tif (data == NULL || data->public_key == NULL || data->comp_cert == NULL || cert == NULL || cert_size == NULL)\n");
+    fprintf(out, "\t\treturn ATCACERT_E_BAD_PARAMS;\n");
+    if (is_stored_sn) {
+        fprintf(out, "\tif (data->cert_sn == NULL)\n");
+        fprintf(out, "\t\treturn ATCACERT_E_BAD_PARAMS;\n");
+    }
+    if (is_device_sn) {
+        fprintf(out, "\tif (data->device_sn == NULL)\n");
+        fprintf(out, "\t\treturn ATCACERT_E_BAD_PARAMS;\n");
+    }
+    if (cert_def->cert_elements_count > 0) {
+        fprintf(out, "\tif (data->elements == NULL)\n");
+        fprintf(out, "\t\treturn ATCACERT_E_BAD_PARAMS;\n");
+    }
+    fprintf(out, "\n");
+
+    fprintf(out, "\tif (*cert_size < %s_MAX_SIZE) {\n", guard);
+    fprintf(out, "\t\t*cert_size = %s_MAX_SIZE;\n", guard);
+    fprintf(out, "\t\treturn ATCACERT_E_BUFFER_TOO_SMALL;\n");
+    fprintf(out, "\t}\n\n");
+
+    fprintf(out, "\t// Format 0, template ID %u, chain ID %u, SN source 0x%X\n", cert_def->template_id, cert_def->chain_id, cert_def->sn_source);
+    fprintf(out, "\tif ((data->comp_cert[70] & 0x0F) != 0)\n");
+    fprintf(out, "\t\treturn ATCACERT_E_DECODING_ERROR;\n");
+    fprintf(out, "\tif (data->comp_cert[69] != 0x%02X || (data->comp_cert[70] >> 4) != 0x%X)\n",
+            (cert_def->template_id << 4) | cert_def->chain_id, cert_def->sn_source);
+    fprintf(out, "\t\treturn ATCACERT_E_WRONG_CERT_DEF;\n\n");
+
+    fprintf(out, "\t// Everything in front of the signature comes from the template\n");
+    fprintf(out, "\tmemcpy(cert, g_%s.cert_template, %u);\n", entry->name, sig_offset);
+    fprintf(out, "\tret = atcacert_der_enc_ecdsa_sig_value(&data->comp_cert[0], &cert[%u], &sig_size);\n", sig_offset);
+    fprintf(out, "\tif (ret != ATCACERT_E_SUCCESS)\n");
+    fprintf(out, "\t\treturn ret;\n");
+    fprintf(out, "\t*cert_size = %u + sig_size;\n", sig_offset);
+    fprintf(out, "\tcert_length = *cert_size - %u;\n", CERT_HEADER_SIZE);
+    fprintf(out, "\tcert[2] = (uint8_t)(cert_length >> 8);\n");
+    fprintf(out, "\tcert[3] = (uint8_t)(cert_length & 0xFF);\n\n");
+
+    if (locs[STDCERT_AUTH_KEY_ID].count != 0) {
+        fprintf(out, "\tif (data->ca_public_key != NULL) {\n");
+        fprintf(out, "\t\tret = atcacert_get_key_id(data->ca_public_key, &cert[%u]);\n", locs[STDCERT_AUTH_KEY_ID].offset);
+        fprintf(out, "\t\tif (ret != ATCACERT_E_SUCCESS)\n");
+        fprintf(out, "\t\t\treturn ret;\n");
+        fprintf(out, "\t}\n\n");
+    }
+
+    if (is_stored_sn)
+        fprintf(out, "\tmemcpy(&cert[%u], data->cert_sn, %u);\n\n", sn_offset, sn_count);
+
+    fprintf(out, "\tmemcpy(&cert[%u], data->public_key, 64);\n", locs[STDCERT_PUBLIC_KEY].offset);
+    if (locs[STDCERT_SUBJ_KEY_ID].count != 0) {
+        fprintf(out, "\tret = atcacert_get_key_id(data->public_key, &cert[%u]);\n", locs[STDCERT_SUBJ_KEY_ID].offset);
+        fprintf(out, "\tif (ret != ATCACERT_E_SUCCESS)\n");
+        fprintf(out, "\t\treturn ret;\n");
+    }
+    fprintf(out, "\n");
+
+    fprintf(out, "\tret = atcacert_date_dec_compcert(&data->comp_cert[64], %s, &issue_date, &expire_date);\n", g_date_formats[cert_def->expire_date_format]);
+    fprintf(out, "\tif (ret != ATCACERT_E_SUCCESS)\n");
+    fprintf(out, "\t\treturn ret;\n");
+    if (locs[STDCERT_ISSUE_DATE].count != 0) {
+        fprintf(out, "\tret = %s(&issue_date, &cert[%u]);\n", g_date_enc_funcs[cert_def->issue_date_format], locs[STDCERT_ISSUE_DATE].offset);
+        fprintf(out, "\tif (ret != ATCACERT_E_SUCCESS)\n");
+        fprintf(out, "\t\treturn ret;\n");
+    }
+    if (locs[STDCERT_EXPIRE_DATE].count != 0) {
+        fprintf(out, "\tret = %s(&expire_date, &cert[%u]);\n", g_date_enc_funcs[cert_def->expire_date_format], locs[STDCERT_EXPIRE_DATE].offset);
+        fprintf(out, "\tif (ret != ATCACERT_E_SUCCESS)\n");
+        fprintf(out, "\t\treturn ret;\n");
+    }
+    if (locs[STDCERT_SIGNER_ID].count != 0) {
+        unsigned offset = locs[STDCERT_SIGNER_ID].offset;
+        fprintf(out, "\tcert[%u] = g_hex_digits[data->comp_cert[67] >> 4];\n", offset);
+        fprintf(out, "\tcert[%u] = g_hex_digits[data->comp_cert[67] & 0x0F];\n", offset + 1);
+        fprintf(out, "\tcert[%u] = g_hex_digits[data->comp_cert[68] >> 4];\n", offset + 2);
+        fprintf(out, "\tcert[%u] = g_hex_digits[data->comp_cert[68] & 0x0F];\n", offset + 3);
+    }
+    fprintf(out, "\n");
+
+    for (i = 0; i < cert_def->cert_elements_count; i++) {
+        const atcacert_cert_element_t* element = &cert_def->cert_elements[i];
+        fprintf(out, "\tmemcpy(&cert[%u], data->elements[%u], %u); // %s\n",
+                element->cert_loc.offset, (unsigned)i, element->cert_loc.count, element->id);
+    }
+    if (cert_def->cert_elements_count > 0)
+        fprintf(out, "\n");
+
+    if (sn_count != 0) {
+        switch (cert_def->sn_source) {
+        case SNSRC_DEVICE_SN:
+            fprintf(out, "\t// Serial number is 0x40 + device SN\n");
+            fprintf(out, "\tcert[%u] = 0x40;\n", sn_offset);
+            fprintf(out, "\tmemcpy(&cert[%u], data->device_sn, 9);\n", sn_offset + 1);
+            break;
+
+        case SNSRC_SIGNER_ID:
+            fprintf(out, "\t// Serial number is 0x40 + signer ID\n");
+            fprintf(out, "\tcert[%u] = 0x40;\n", sn_offset);
+            fprintf(out, "\tcert[%u] = data->comp_cert[67];\n", sn_offset + 1);
+            fprintf(out, "\tcert[%u] = data->comp_cert[68];\n", sn_offset + 2);
+            break;
+
+        case SNSRC_PUB_KEY_HASH:
+        case SNSRC_PUB_KEY_HASH_POS:
+        case SNSRC_PUB_KEY_HASH_RAW:
+        case SNSRC_DEVICE_SN_HASH:
+        case SNSRC_DEVICE_SN_HASH_POS:
+        case SNSRC_DEVICE_SN_HASH_RAW:
+            if (is_device_sn) {
+                fprintf(out, "\t// Serial number is SHA256(device SN + encoded dates)\n");
+                fprintf(out, "\tmemcpy(&msg[0], data->device_sn, 9);\n");
+                fprintf(out, "\tret = atcacert_date_enc_compcert(&issue_date, %u, &msg[9]);\n", cert_def->expire_years);
+                fprintf(out, "\tif (ret != ATCACERT_E_SUCCESS)\n");
+                fprintf(out, "\t\treturn ret;\n");
+                fprintf(out, "\tret = atcac_sw_sha2_256(msg, 9 + 3, sn);\n");
+            }else {
+                fprintf(out, "\t// Serial number is SHA256(public key + encoded dates)\n");
+                fprintf(out, "\tmemcpy(&msg[0], data->public_key, 64);\n");
+                fprintf(out, "\tret = atcacert_date_enc_compcert(&issue_date, %u, &msg[64]);\n", cert_def->expire_years);
+                fprintf(out, "\tif (ret != ATCACERT_E_SUCCESS)\n");
+                fprintf(out, "\t\treturn ret;\n");
+                fprintf(out, "\tret = atcac_sw_sha2_256(msg, 64 + 3, sn);\n");
+            }
+            fprintf(out, "\tif (ret != ATCACERT_E_SUCCESS)\n");
+            fprintf(out, "\t\treturn ret;\n");
+            if (cert_def->sn_source != SNSRC_PUB_KEY_HASH_RAW && cert_def->sn_source != SNSRC_DEVICE_SN_HASH_RAW)
+                fprintf(out, "\tsn[0] &= 0x7F;\n");
+            if (cert_def->sn_source == SNSRC_PUB_KEY_HASH || cert_def->sn_source == SNSRC_DEVICE_SN_HASH)
+                fprintf(out, "\tsn[0] |= 0x40;\n");
+            fprintf(out, "\tmemcpy(&cert[%u], sn, %u);\n", sn_offset, sn_count);
+            break;
+
+        default:
+            break; // Stored serial numbers were already set
+        }
+        fprintf(out, "\n");
+    }
+
+    fprintf(out, "\treturn ATCACERT_E_SUCCESS;\n");
+    fprintf(out, "}\n");
+}
+
+static int compile_cert_def(const cert_def_entry_t* entry)
+{
+    char guard[64];
+    char file_name[80];
+    FILE* out = NULL;
+    size_t i = 0;
+
+    if (strlen(entry->name) >= sizeof(guard) || check_cert_def(entry->cert_def, entry->name) != 0)
+        return -1;
+
+    for (i = 0; entry->name[i] != '\0'; i++)
+        guard[i] = (char)toupper((unsigned char)entry->name[i]);
+    guard[i] = '\0';
+
+    sprintf(file_name, "%s_build.h", entry->name);
+    out = fopen(file_name, "w");
+    if (out == NULL) {
+        fprintf(stderr, "%s: can't create %s\n", entry->name, file_name);
+        return -1;
+    }
+    emit_header(out, entry, guard);
+    fclose(out);
+
+    sprintf(file_name, "%s_build.c", entry->name);
+    out = fopen(file_name, "w");
+    if (out == NULL) {
+        fprintf(stderr, "%s: can't create %s\n", entry->name, file_name);
+        return -1;
+    }
+    emit_source(out, entry, guard);
+    fclose(out);
+
+    printf("%s: %s_build.c, %s_build.h\n", entry->name, entry->name, entry->name);
+
+    return 0;
+}
+
+int main(void)
+{
+    size_t i = 0;
+    int ret = 0;
+
+    for (i = 0; i < sizeof(g_cert_defs) / sizeof(g_cert_defs[0]); i++) {
+        if (compile_cert_def(&g_cert_defs[i]) != 0)
+            ret = 1;
+    }
+
+    return ret;
+}
@@ -60,9 +60,17 @@
  */
 struct atca_command {
 	ATCADeviceType dt;
-	uint16_t *execution_times;
+#ifndef ATCA_STATIC_DEVICE
+	const uint16_t *execution_times;
+#endif
+	uint32_t poll_delays[CMD_LASTCOMMAND];  // learned delay before polling for completion, in microseconds
 };
 
+#ifdef ATCA_STATIC_DEVICE
+static struct atca_command _gStaticCommand;     // the command object of the one device of a static build
+static bool _gStaticCommandUsed = false;
+#endif
+
 
 /** \brief constructor for ATCACommand
  * \param[in] device_type - specifies which set of commands and execution times should be associated with this command object
@@ -71,13 +79,22 @@ struct atca_command {
 ATCACommand newATCACommand( ATCADeviceType device_type )  // constructor
 {
 	ATCA_STATUS status = ATCA_SUCCESS;
+#ifdef ATCA_STATIC_DEVICE
+	ATCACommand cacmd = NULL;
+
+	if ( _gStaticCommandUsed )
+		return NULL;
+	cacmd = &_gStaticCommand;
+	_gStaticCommandUsed = true;
+#else
 	ATCACommand cacmd = (ATCACommand)malloc(sizeof(struct atca_command));
+#endif
 
 	cacmd->dt = device_type;
 	status = atInitExecTimes(cacmd, device_type);  // setup typical execution times for this device type
 
 	if (status != ATCA_SUCCESS) {
-		free(cacmd);
+		deleteATCACommand(&cacmd);
 		cacmd = NULL;
 	}
 
@@ -525,8 +542,13 @@ ATCA_STATUS atWrite( ATCACommand cacmd, ATCAPacket *packet, bool hasMAC )
 
 void deleteATCACommand( ATCACommand *cacmd )  // destructor
 {
+#ifdef ATCA_STATIC_DEVICE
+	if ( *cacmd == &_gStaticCommand )
+		_gStaticCommandUsed = false;
+#else
 	if ( *cacmd )
 		free((void*)*cacmd);
+#endif
 
 	*cacmd = NULL;
 }
@@ -534,7 +556,7 @@ void deleteATCACommand( ATCACommand *cacmd )  // destructor
 
 /** \brief execution times for x08a family, these are based on the typical value from the datasheet
  */
-uint16_t exectimes_x08a[] = {   // in milleseconds
+const uint16_t exectimes_x08a[] = {   // in milleseconds
 	1,                          // WAKE_TWHI
 	13,                         // CMD_CHECKMAC
 	20,                         // CMD_COUNTER
@@ -561,7 +583,8 @@ uint16_t exectimes_x08a[] = {   // in milleseconds
 
 /** \brief execution times for 204a, these are based on the typical value from the datasheet
  */
-uint16_t exectimes_204a[] = {
+#ifndef ATCA_STATIC_DEVICE
+const uint16_t exectimes_204a[] = {
 	3,  // WAKE_TWHI
 	38, // CMD_CHECKMAC
 	0,
@@ -584,6 +607,7 @@ uint16_t exectimes_204a[] = {
 	0,
 	42  // CMD_WRITEMEM
 };
+#endif
 
 /** \brief initialize the execution times for a given device type
  *
@@ -594,22 +618,31 @@ uint16_t exectimes_204a[] = {
 
 ATCA_STATUS atInitExecTimes(ATCACommand cacmd, ATCADeviceType device_type)
 {
+	int cmd;
+
 	switch ( device_type ) {
 	case ATECC108A:
 	case ATECC508A:
+#ifndef ATCA_STATIC_DEVICE
 		cacmd->execution_times = exectimes_x08a;
 		break;
 	case ATSHA204A:
 		cacmd->execution_times = exectimes_204a;
+#endif
 		break;
 	default:
 		return ATCA_BAD_PARAM;
 		break;
 	}
 
+	// start polling halfway through the execution time until the real one has been learned
+	for (cmd = 0; cmd < CMD_LASTCOMMAND; cmd++)
+		cacmd->poll_delays[cmd] = (uint32_t)atGetExecTime(cacmd, cmd) * 500;
+
 	return ATCA_SUCCESS;
 }
 
+#ifndef ATCA_STATIC_DEVICE
 /** \brief return the typical execution type for the given command
  *
  * \param[in] cacmd the command object for which the execution times are associated
@@ -621,7 +654,78 @@ uint16_t atGetExecTime( ATCACommand cacmd, ATCA_CmdMap cmd )
 {
 	return cacmd->execution_times[cmd];
 }
+#endif
+
+/** \brief return the delay after which to start polling for completion of the given command
+ *
+ * \param[in] cacmd the command object for which the delays are learned
+ * \param[in] cmd - the specific command for which to lookup the delay
+ * \return delay in microseconds
+ */
 
+uint32_t atGetPollDelay( ATCACommand cacmd, ATCA_CmdMap cmd )
+{
+	return cacmd->poll_delays[cmd];
+}
+
+/** \brief update the delay after which to start polling for completion of the given command
+ *
+ * \param[in] cacmd the command object for which the delays are learned
+ * \param[in] cmd - the specific command for which to set the delay
+ * \param[in] delay - delay in microseconds
+ */
+
+void atSetPollDelay( ATCACommand cacmd, ATCA_CmdMap cmd, uint32_t delay )
+{
+	cacmd->poll_delays[cmd] = delay;
+}
+
+
+// The device CRC-16 (polynomial 0x8005, initial value 0) shifts the data in LSB first but keeps its register
+// MSB first. With the register mirrored it becomes a plain reflected CRC with polynomial 0xA001, which is
+// computed a byte (or with ATCA_CRC_NIBBLE_TABLE a nibble, for a 32 byte instead of 512 byte table) at a
+// time and only mirrored back once at the end.
+#ifdef ATCA_CRC_NIBBLE_TABLE
+static const uint16_t atca_crc16_table[16] = {
+	0x0000, 0xCC01, 0xD801, 0x1400, 0xF001, 0x3C00, 0x2800, 0xE401,
+	0xA001, 0x6C00, 0x7800, 0xB401, 0x5000, 0x9C01, 0x8801, 0x4400
+};
+#else
+static const uint16_t atca_crc16_table[256] = {
+	0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
+	0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
+	0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
+	0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
+	0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
+	0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
+	0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
+	0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
+	0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
+	0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
+	0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
+	0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
+	0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
+	0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
+	0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
+	0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
+	0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
+	0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
+	0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
+	0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
+	0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
+	0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
+	0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
+	0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
+	0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
+	0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
+	0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
+	0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
+	0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
+	0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
+	0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
+	0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040
+};
+#endif
 
 /** \brief Calculates CRC over the given raw data and returns the CRC in
  *         little-endian byte order.
@@ -635,19 +739,22 @@ void atCRC( size_t length, const uint8_t *data, uint8_t *crc_le )
 {
 	size_t counter;
 	uint16_t crc_register = 0;
-	uint16_t polynom = 0x8005;
-	uint8_t shift_register;
-	uint8_t data_bit, crc_bit;
 
 	for (counter = 0; counter < length; counter++) {
-		for (shift_register = 0x01; shift_register > 0x00; shift_register <<= 1) {
-			data_bit = (data[counter] & shift_register) ? 1 : 0;
-			crc_bit = crc_register >> 15;
-			crc_register <<= 1;
-			if (data_bit != crc_bit)
-				crc_register ^= polynom;
-		}
+#ifdef ATCA_CRC_NIBBLE_TABLE
+		crc_register = (crc_register >> 4) ^ atca_crc16_table[(crc_register ^ data[counter]) & 0x0F];
+		crc_register = (crc_register >> 4) ^ atca_crc16_table[(crc_register ^ (data[counter] >> 4)) & 0x0F];
+#else
+		crc_register = (crc_register >> 8) ^ atca_crc16_table[(crc_register ^ data[counter]) & 0xFF];
+#endif
 	}
+
+	// Mirror the register back
+	crc_register = ((crc_register >> 1) & 0x5555) | ((crc_register & 0x5555) << 1);
+	crc_register = ((crc_register >> 2) & 0x3333) | ((crc_register & 0x3333) << 2);
+	crc_register = ((crc_register >> 4) & 0x0F0F) | ((crc_register & 0x0F0F) << 4);
+	crc_register = (uint16_t)((crc_register >> 8) | (crc_register << 8));
+
 	crc_le[0] = (uint8_t)(crc_register & 0x00FF);
 	crc_le[1] = (uint8_t)(crc_register >> 8);
 }
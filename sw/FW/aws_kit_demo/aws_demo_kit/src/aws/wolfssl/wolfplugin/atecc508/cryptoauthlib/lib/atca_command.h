@@ -164,7 +164,15 @@ typedef enum {
 } ATCA_CmdMap;
 
 ATCA_STATUS atInitExecTimes(ATCACommand cacmd, ATCADeviceType device_type);
+#ifdef ATCA_STATIC_DEVICE
+// the device family is known at compile time, there is a single table of execution times
+extern const uint16_t exectimes_x08a[];
+#define atGetExecTime(cacmd, cmd)   (exectimes_x08a[(cmd)])
+#else
 uint16_t atGetExecTime( ATCACommand cacmd, ATCA_CmdMap cmd );
+#endif
+uint32_t atGetPollDelay( ATCACommand cacmd, ATCA_CmdMap cmd );
+void atSetPollDelay( ATCACommand cacmd, ATCA_CmdMap cmd, uint32_t delay );
 
 void deleteATCACommand( ATCACommand * );      // destructor
 /*---- end of ATCACommand ----*/
@@ -55,6 +55,11 @@ struct atca_device {
 	ATCAIface mIface;       // has-a physical interface
 };
 
+#ifdef ATCA_STATIC_DEVICE
+static struct atca_device _gStaticDevice;   // the one device of a static build
+static bool _gStaticDeviceUsed = false;
+#endif
+
 /** \brief constructor for an Atmel CryptoAuth device
  * \param[in] cfg  pointer to an interface configuration object
  * \return reference to a new ATCADevice
@@ -67,12 +72,26 @@ ATCADevice newATCADevice(ATCAIfaceCfg *cfg )
 	if (cfg == NULL)
 		return NULL;
 
+#ifdef ATCA_STATIC_DEVICE
+	if (_gStaticDeviceUsed)
+		return NULL;
+	cadev = &_gStaticDevice;
+	_gStaticDeviceUsed = true;
+#else
 	cadev = (ATCADevice)malloc(sizeof(struct atca_device));
+#endif
 	cadev->mCommands = (ATCACommand)newATCACommand(cfg->devtype);
 	cadev->mIface    = (ATCAIface)newATCAIface(cfg);
 
 	if (cadev->mCommands == NULL || cadev->mIface == NULL) {
+#ifdef ATCA_STATIC_DEVICE
+		// the objects are static, one left behind would refuse the next device
+		deleteATCACommand(&cadev->mCommands);
+		deleteATCAIface(&cadev->mIface);
+		_gStaticDeviceUsed = false;
+#else
 		free(cadev);
+#endif
 		cadev = NULL;
 	}
 
@@ -110,7 +129,11 @@ void deleteATCADevice( ATCADevice *cadev ) // destructor
 	if ( *cadev ) {
 		deleteATCACommand( (ATCACommand*)&(dev->mCommands));
 		deleteATCAIface((ATCAIface*)&(dev->mIface));
+#ifdef ATCA_STATIC_DEVICE
+		_gStaticDeviceUsed = false;
+#else
 		free((void*)*cadev);
+#endif
 	}
 
 	*cadev = NULL;
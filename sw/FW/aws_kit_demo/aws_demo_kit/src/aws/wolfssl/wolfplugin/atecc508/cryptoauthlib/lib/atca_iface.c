@@ -58,6 +58,7 @@ struct atca_iface {
 	ATCAIfaceType mType;
 	ATCAIfaceCfg  *mIfaceCFG;   // points to previous defined/given Cfg object, caller manages this
 
+#ifndef ATCA_STATIC_DEVICE
 	ATCA_STATUS (*atinit)(void *hal, ATCAIfaceCfg *);
 	ATCA_STATUS (*atpostinit)(ATCAIface hal);
 	ATCA_STATUS (*atsend)(ATCAIface hal, uint8_t *txdata, int txlength);
@@ -65,13 +66,19 @@ struct atca_iface {
 	ATCA_STATUS (*atwake)(ATCAIface hal);
 	ATCA_STATUS (*atidle)(ATCAIface hal);
 	ATCA_STATUS (*atsleep)(ATCAIface hal);
+#endif
 
 	// treat as private
 	void *hal_data;     // generic pointer used by HAL to point to architecture specific structure
 	                    // no ATCA object should touch this except HAL, HAL manages this pointer and memory it points to
 };
 
+#ifdef ATCA_STATIC_DEVICE
+static struct atca_iface _gStaticIface;     // the interface of the one device of a static build
+static bool _gStaticIfaceUsed = false;
+#else
 ATCA_STATUS _atinit(ATCAIface caiface, ATCAHAL_t *hal);
+#endif
 
 /** \brief constructor for ATCAIface objects
  * \param[in] cfg  points to the logical configuration for the interface
@@ -80,13 +87,26 @@ ATCA_STATUS _atinit(ATCAIface caiface, ATCAHAL_t *hal);
 
 ATCAIface newATCAIface(ATCAIfaceCfg *cfg)  // constructor
 {
+#ifdef ATCA_STATIC_DEVICE
+	ATCAIface caiface = NULL;
+
+	if (_gStaticIfaceUsed || cfg->iface_type != ATCA_I2C_IFACE)
+		return NULL;
+	caiface = &_gStaticIface;
+	_gStaticIfaceUsed = true;
+#else
 	ATCAIface caiface = (ATCAIface)malloc(sizeof(struct atca_iface));
+#endif
 
 	caiface->mType = cfg->iface_type;
 	caiface->mIfaceCFG = cfg;
 
 	if (atinit(caiface) != ATCA_SUCCESS) {
+#ifdef ATCA_STATIC_DEVICE
+		_gStaticIfaceUsed = false;
+#else
 		free(caiface);
+#endif
 		caiface = NULL;
 	}
 
@@ -100,6 +120,16 @@ ATCA_STATUS atinit(ATCAIface caiface)
 	ATCA_STATUS status = ATCA_COMM_FAIL;
 	ATCAHAL_t hal;
 
+#ifdef ATCA_STATIC_DEVICE
+	hal.hal_data = NULL;
+	status = hal_i2c_init( &hal, caiface->mIfaceCFG );
+	if (status == ATCA_SUCCESS) {
+		caiface->hal_data = hal.hal_data;
+
+		// Perform the post init
+		status = hal_i2c_post_init( caiface );
+	}
+#else
 	_atinit( caiface, &hal );
 
 	status = caiface->atinit( &hal, caiface->mIfaceCFG );
@@ -109,10 +139,12 @@ ATCA_STATUS atinit(ATCAIface caiface)
 		// Perform the post init
 		status = caiface->atpostinit( caiface );
 	}
+#endif
 
 	return status;
 }
 
+#ifndef ATCA_STATIC_DEVICE
 ATCA_STATUS atsend(ATCAIface caiface, uint8_t *txdata, int txlength)
 {
 	return caiface->atsend(caiface, txdata, txlength);
@@ -127,17 +159,26 @@ ATCA_STATUS atwake(ATCAIface caiface)
 {
 	return caiface->atwake(caiface);
 }
+#endif
 
 ATCA_STATUS atidle(ATCAIface caiface)
 {
 	atca_delay_ms(1);
+#ifdef ATCA_STATIC_DEVICE
+	return hal_i2c_idle(caiface);
+#else
 	return caiface->atidle(caiface);
+#endif
 }
 
 ATCA_STATUS atsleep(ATCAIface caiface)
 {
 	atca_delay_ms(1);
+#ifdef ATCA_STATIC_DEVICE
+	return hal_i2c_sleep(caiface);
+#else
 	return caiface->atsleep(caiface);
+#endif
 }
 
 ATCAIfaceCfg * atgetifacecfg(ATCAIface caiface)
@@ -153,13 +194,19 @@ void* atgetifacehaldat(ATCAIface caiface)
 void deleteATCAIface(ATCAIface *caiface) // destructor
 {
 	if ( *caiface ) {
+#ifdef ATCA_STATIC_DEVICE
+		hal_i2c_release( (*caiface)->hal_data );
+		_gStaticIfaceUsed = false;
+#else
 		hal_iface_release( (*caiface)->mType, (*caiface)->hal_data);  // let HAL clean up and disable physical level interface if ref count is 0
 		free((void*)*caiface);
+#endif
 	}
 
 	*caiface = NULL;
 }
 
+#ifndef ATCA_STATIC_DEVICE
 ATCA_STATUS _atinit(ATCAIface caiface, ATCAHAL_t *hal)
 {
 	// get method mapping to HAL methods for this interface
@@ -175,4 +222,5 @@ ATCA_STATUS _atinit(ATCAIface caiface, ATCAHAL_t *hal)
 
 	return ATCA_SUCCESS;
 }
+#endif
 /** @} */
@@ -121,9 +121,22 @@ ATCAIface newATCAIface(ATCAIfaceCfg *cfg);  // constructor
 // IFace methods
 ATCA_STATUS atinit(ATCAIface caiface);
 ATCA_STATUS atpostinit(ATCAIface caiface);
+#ifdef ATCA_STATIC_DEVICE
+// the interface of a static build is I2C, calls on the command path go straight to the HAL
+#ifndef ATCA_HAL_I2C
+#error "ATCA_STATIC_DEVICE requires ATCA_HAL_I2C"
+#endif
+ATCA_STATUS hal_i2c_send(ATCAIface iface, uint8_t *txdata, int txlength);
+ATCA_STATUS hal_i2c_receive( ATCAIface iface, uint8_t *rxdata, uint16_t *rxlength);
+ATCA_STATUS hal_i2c_wake(ATCAIface iface);
+#define atsend(caiface, txdata, txlength)       hal_i2c_send((caiface), (txdata), (txlength))
+#define atreceive(caiface, rxdata, rxlength)    hal_i2c_receive((caiface), (rxdata), (rxlength))
+#define atwake(caiface)                         hal_i2c_wake(caiface)
+#else
 ATCA_STATUS atsend(ATCAIface caiface, uint8_t *txdata, int txlength);
 ATCA_STATUS atreceive(ATCAIface caiface, uint8_t *rxdata, uint16_t *rxlength);
 ATCA_STATUS atwake(ATCAIface caiface);
+#endif
 ATCA_STATUS atidle(ATCAIface caiface);
 ATCA_STATUS atsleep(ATCAIface caiface);
 
@@ -85,12 +85,17 @@ int atcacert_read_cert(const atcacert_def_t* cert_def,
 	if (ret != ATCACERT_E_SUCCESS)
 		return ret;
 
+	// The locations are merged and aligned to 32-byte blocks, read them all while the device stays awake
+	ret = atcab_session_begin();
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
 	for (i = 0; i < device_locs_count; i++) {
 		uint8_t data[416];
 		if (device_locs[i].zone == DEVZONE_DATA && device_locs[i].is_genkey) {
 			ret = atcab_get_pubkey(device_locs[i].slot, data);
 			if (ret != ATCA_SUCCESS)
-				return ret;
+				break;
 		}
 		else {
 			size_t start_block = device_locs[i].offset / 32;
@@ -99,15 +104,21 @@ int atcacert_read_cert(const atcacert_def_t* cert_def,
 			for (block = (uint8_t)start_block; block < end_block; block++) {
 				ret = atcab_read_zone(device_locs[i].zone, device_locs[i].slot, block, 0, &data[block * 32 - device_locs[i].offset], 32);
 				if (ret != ATCA_SUCCESS)
-					return ret;
+					break;
 			}
+			if (ret != ATCA_SUCCESS)
+				break;
 		}
 
 		ret = atcacert_cert_build_process(&build_state, &device_locs[i], data);
 		if (ret != ATCACERT_E_SUCCESS)
-			return ret;
+			break;
 	}
 
+	atcab_session_end();
+	if (ret != ATCACERT_E_SUCCESS)
+		return ret;
+
 	ret = atcacert_cert_build_finish(&build_state);
 	if (ret != ATCACERT_E_SUCCESS)
 		return ret;
@@ -115,6 +126,101 @@ int atcacert_read_cert(const atcacert_def_t* cert_def,
 	return ATCACERT_E_SUCCESS;
 }
 
+static int atcacert_read_device_loc(const atcacert_device_loc_t* device_loc, uint8_t* data)
+{
+	if (device_loc->zone == DEVZONE_DATA && device_loc->is_genkey)
+		return atcab_get_pubkey(device_loc->slot, data);
+
+	return atcab_read_bytes_zone(device_loc->zone, device_loc->slot, device_loc->offset, data, device_loc->count);
+}
+
+int atcacert_read_cert_compiled(const atcacert_def_t* cert_def,
+	atcacert_build_func_t build,
+	const uint8_t ca_public_key[64],
+	uint8_t*              cert,
+	size_t*               cert_size)
+{
+	int ret = 0;
+	uint8_t public_key[72];
+	uint8_t comp_cert[72];
+	uint8_t cert_sn[32];
+	uint8_t device_sn[9];
+	uint8_t element_data[128];
+	const uint8_t* elements[8];
+	size_t element_offset = 0;
+	size_t i = 0;
+	atcacert_build_data_t build_data;
+
+	if (cert_def == NULL || build == NULL || cert == NULL || cert_size == NULL)
+		return ATCACERT_E_BAD_PARAMS;
+
+	if (cert_def->public_key_dev_loc.count != 64 && cert_def->public_key_dev_loc.count != 72)
+		return ATCACERT_E_BAD_CERT; // Unexpected public key size
+	if (cert_def->comp_cert_dev_loc.count != 72)
+		return ATCACERT_E_BAD_CERT; // Unexpected compressed certificate size
+	if (cert_def->cert_sn_dev_loc.count > sizeof(cert_sn))
+		return ATCACERT_E_BAD_CERT;
+	if (cert_def->cert_elements_count > sizeof(elements) / sizeof(elements[0]))
+		return ATCACERT_E_BAD_CERT;
+
+	memset(&build_data, 0, sizeof(build_data));
+	build_data.ca_public_key = ca_public_key;
+	build_data.public_key = public_key;
+	build_data.comp_cert = comp_cert;
+	build_data.elements = elements;
+
+	// Read everything the builder needs while the device stays awake
+	ret = atcab_session_begin();
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	do {
+		ret = atcacert_read_device_loc(&cert_def->public_key_dev_loc, public_key);
+		if (ret != ATCA_SUCCESS)
+			break;
+		if (cert_def->public_key_dev_loc.count == 72)
+			atcacert_public_key_remove_padding(public_key, public_key);
+
+		ret = atcacert_read_device_loc(&cert_def->comp_cert_dev_loc, comp_cert);
+		if (ret != ATCA_SUCCESS)
+			break;
+
+		if (cert_def->cert_sn_dev_loc.zone != DEVZONE_NONE && cert_def->cert_sn_dev_loc.count > 0) {
+			ret = atcacert_read_device_loc(&cert_def->cert_sn_dev_loc, cert_sn);
+			if (ret != ATCA_SUCCESS)
+				break;
+			build_data.cert_sn = cert_sn;
+		}
+
+		if (cert_def->sn_source == SNSRC_DEVICE_SN || cert_def->sn_source == SNSRC_DEVICE_SN_HASH
+		    || cert_def->sn_source == SNSRC_DEVICE_SN_HASH_POS || cert_def->sn_source == SNSRC_DEVICE_SN_HASH_RAW) {
+			ret = atcab_read_serial_number(device_sn);
+			if (ret != ATCA_SUCCESS)
+				break;
+			build_data.device_sn = device_sn;
+		}
+
+		for (i = 0; i < cert_def->cert_elements_count; i++) {
+			const atcacert_device_loc_t* device_loc = &cert_def->cert_elements[i].device_loc;
+			if (element_offset + device_loc->count > sizeof(element_data)) {
+				ret = ATCACERT_E_BUFFER_TOO_SMALL;
+				break;
+			}
+			ret = atcacert_read_device_loc(device_loc, &element_data[element_offset]);
+			if (ret != ATCA_SUCCESS)
+				break;
+			elements[i] = &element_data[element_offset];
+			element_offset += device_loc->count;
+		}
+	} while (0);
+
+	atcab_session_end();
+	if (ret != ATCACERT_E_SUCCESS)
+		return ret;
+
+	return build(&build_data, cert, cert_size);
+}
+
 int atcacert_write_cert(const atcacert_def_t* cert_def,
 						const uint8_t*        cert,
 						size_t                cert_size)
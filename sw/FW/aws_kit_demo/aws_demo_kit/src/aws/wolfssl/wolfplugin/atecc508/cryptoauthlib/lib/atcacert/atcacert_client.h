@@ -98,6 +98,30 @@ int atcacert_read_cert( const atcacert_def_t* cert_def,
                         uint8_t*              cert,
                         size_t*               cert_size);
 
+/**
+ * \brief Reads the certificate specified by the certificate definition from the
+ *        ATECC508A device and rebuilds it with a compiled builder.
+ *
+ * Same as atcacert_read_cert(), except that the dynamic cert data is handed to a builder generated
+ * from the certificate definition, which copies the template and patches its fixed offsets.
+ *
+ * \param[in]    cert_def       Certificate definition the builder was generated from.
+ * \param[in]    build          Compiled builder for cert_def.
+ * \param[in]    ca_public_key  The ECC P256 public key of the certificate authority that signed
+ *                              this certificate, as for atcacert_read_cert(). Set to NULL if it
+ *                              is not needed.
+ * \param[out]   cert           Buffer to received the certificate.
+ * \param[inout] cert_size      As input, the size of the cert buffer in bytes.
+ *                              As output, the size of the certificate returned in cert in bytes.
+ *
+ * \return 0 on success
+ */
+int atcacert_read_cert_compiled( const atcacert_def_t* cert_def,
+                                 atcacert_build_func_t build,
+                                 const uint8_t ca_public_key[64],
+                                 uint8_t*              cert,
+                                 size_t*               cert_size);
+
 /**
  * \brief Take a full certificate and write it to the ATECC508A device according to the
  *        certificate definition.
@@ -49,6 +49,45 @@
 #define ATCACERT_MIN(x, y) ((x) < (y) ? (x) : (y))
 #define ATCACERT_MAX(x, y) ((x) >= (y) ? (x) : (y))
 
+static void atcacert_fold_device_locs( atcacert_device_loc_t* device_locs,
+                                       size_t*                device_locs_count,
+                                       size_t                 index)
+{
+	atcacert_device_loc_t* dest = &device_locs[index];
+	size_t dest_end;
+	size_t src_end;
+	size_t i = 0;
+
+	while (i < *device_locs_count) {
+		atcacert_device_loc_t* src = &device_locs[i];
+
+		dest_end = dest->offset + dest->count;
+		src_end = src->offset + src->count;
+		if (i == index
+		    || src->zone != dest->zone
+		    || (dest->zone == DEVZONE_DATA && (src->slot != dest->slot || src->is_genkey != dest->is_genkey))
+		    || src_end < dest->offset || src->offset > dest_end) {
+			i++;
+			continue;
+		}
+
+		if (src->offset < dest->offset)
+			dest->offset = src->offset;
+		if (src_end > dest_end)
+			dest_end = src_end;
+		dest->count = (uint16_t)(dest_end - dest->offset);
+
+		// Remove the folded location, keeping the order of the rest
+		memmove(src, src + 1, (*device_locs_count - i - 1) * sizeof(*src));
+		(*device_locs_count)--;
+		if (i < index) {
+			index--;
+			dest = &device_locs[index];
+		}
+		i = 0; // The location grew again, start over
+	}
+}
+
 int atcacert_merge_device_loc( atcacert_device_loc_t*       device_locs,
                                size_t*                      device_locs_count,
                                size_t device_locs_max_count,
@@ -83,13 +122,16 @@ int atcacert_merge_device_loc( atcacert_device_loc_t*       device_locs,
 		if (new_end < cur_device_loc->offset || new_offset > cur_end)
 			continue;   // Same zone, but non-continuous areas
 
-		if (device_loc->offset < cur_device_loc->offset)
-			cur_device_loc->offset = device_loc->offset;
+		if (new_offset < cur_device_loc->offset)
+			cur_device_loc->offset = (uint16_t)new_offset;
 
 		if (new_end > cur_end)
 			cur_device_loc->count = (uint16_t)(new_end - cur_device_loc->offset);
 		else
 			cur_device_loc->count = (uint16_t)(cur_end - cur_device_loc->offset);
+
+		// The grown location may now touch other locations in the list, fold them in so each area is read once
+		atcacert_fold_device_locs(device_locs, device_locs_count, i);
 		break;
 	}
 
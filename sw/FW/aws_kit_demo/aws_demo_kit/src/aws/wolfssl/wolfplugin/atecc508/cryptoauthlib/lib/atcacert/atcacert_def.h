@@ -184,8 +184,28 @@ typedef struct atcacert_build_state_s {
 	uint8_t device_sn[9];                       //!< Storage for the device SN, when it's found.
 } atcacert_build_state_t;
 
+/**
+ * Device data for a compiled certificate builder, already read from the device locations of the
+ * certificate definition the builder was generated from (see app/cert_def_compile.c).
+ */
+typedef struct atcacert_build_data_s {
+	const uint8_t*        ca_public_key;        //!< CA public key (64 bytes) for the authority key ID. NULL to leave the template one.
+	const uint8_t*        public_key;           //!< Subject public key (64 bytes), without padding.
+	const uint8_t*        comp_cert;            //!< Compressed certificate (72 bytes).
+	const uint8_t*        cert_sn;              //!< Stored certificate serial number. Only used when cert_sn_dev_loc is set.
+	const uint8_t*        device_sn;            //!< Device serial number (9 bytes). Only used by the SNSRC_DEVICE_SN sources.
+	const uint8_t* const* elements;             //!< Data for each of the cert_elements, in the same order.
+} atcacert_build_data_t;
+
 #pragma pack(pop)
 
+/**
+ * Compiled certificate builder. Rebuilds the certificate from the device data in one pass and
+ * returns the same certificate as atcacert_cert_build_start(), atcacert_cert_build_process() and
+ * atcacert_cert_build_finish() would.
+ */
+typedef int (*atcacert_build_func_t)(const atcacert_build_data_t* data, uint8_t* cert, size_t* cert_size);
+
 // Inform function naming when compiling in C++
 #ifdef __cplusplus
 extern "C" {
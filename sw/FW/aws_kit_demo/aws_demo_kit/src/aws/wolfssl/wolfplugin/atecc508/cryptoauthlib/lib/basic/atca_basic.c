@@ -75,6 +75,15 @@ ATCADevice _gDevice = NULL;
 ATCACommand _gCommandObj = NULL;
 ATCAIface _gIface = NULL;
 
+static bool _gPolling = ATCA_POLLING_ENABLE;
+static uint32_t _gLastWait = 0;
+
+static uint8_t _gSessionDepth = 0;
+static bool _gSessionAwake = false;
+static bool _gSessionPending = false;
+static bool _gSessionLost = false;
+static uint32_t _gSessionTime = 0;
+
 /** \brief atcab_init is called once for the life of the application and creates a global ATCADevice object used by Basic API.
  *  This method builds a global ATCADevice instance behinds the scenes that's used for all Basic API operations
  *  \param[in] cfg is a pointer to an interface configuration.  This is usually a predefined configuration found in atca_cfgs.h
@@ -129,6 +138,8 @@ ATCA_STATUS atcab_init_device( ATCADevice cadevice )
  */
 ATCA_STATUS atcab_release( void )
 {
+	_gSessionDepth = 0;
+	_gSessionAwake = false;
 	deleteATCADevice(&_gDevice);
 	return ATCA_SUCCESS;
 }
@@ -263,12 +274,211 @@ ATCA_STATUS atcab_cfg_discover( ATCAIfaceCfg cfgArray[], int maxIfaces)
 	return ATCA_SUCCESS;
 }
 
+/** \brief common setup code which wakes the device before any command
+ *
+ *  Inside a session the device is only woken when it is not awake yet, or when the commands
+ *  sent since the last wake may have used up the watchdog window. In that case the device is
+ *  idled and woken again, which restarts the watchdog and keeps TempKey. When the last command
+ *  did not get a response, the device is assumed to have gone to sleep and is woken again too.
+ *  \return ATCA_STATUS
+ */
+static ATCA_STATUS _atcab_enter(void)
+{
+	ATCA_STATUS status;
+
+	if ( _gSessionDepth == 0 )
+		return atcab_wakeup();
+
+	if ( _gSessionAwake && _gSessionTime + ATCA_SESSION_GUARD_MS * 1000 > ATCA_SESSION_WINDOW_MS * 1000 ) {
+		atcab_idle();
+		_gSessionAwake = false;
+	}
+
+	if ( !_gSessionAwake ) {
+		if ( (status = atcab_wakeup()) != ATCA_SUCCESS )
+			return status;
+		_gSessionAwake = true;
+		_gSessionTime = 0;
+	}
+
+	_gSessionPending = true;
+	_gSessionTime += ATCA_SESSION_XFER_US;
+
+	return ATCA_SUCCESS;
+}
+
 /** \brief common cleanup code which idles the device after any operation
+ *
+ *  Inside a session the device is left awake, unless the last command did not complete.
  *  \return ATCA_STATUS
  */
 static ATCA_STATUS _atcab_exit(void)
 {
-	return atcab_idle();
+	if ( _gSessionDepth == 0 )
+		return atcab_idle();
+
+	if ( _gSessionPending ) {
+		// no valid response, the watchdog may have put the device to sleep and TempKey is lost
+		atcab_idle();
+		_gSessionAwake = false;
+		_gSessionPending = false;
+		_gSessionLost = true;
+	}
+
+	return ATCA_SUCCESS;
+}
+
+/** \brief begin a session, which keeps the device awake across several commands
+ *
+ *  Commands sent until the matching atcab_session_end() pay for one wake only. The time spent
+ *  by the device on these commands is counted, and the device is idled and woken again before
+ *  it can come close to the watchdog timeout. Time spent by the host between commands is not
+ *  counted, so keep sessions to device work. Sessions can be nested.
+ *  \return ATCA_STATUS
+ */
+ATCA_STATUS atcab_session_begin(void)
+{
+	ATCA_STATUS status;
+
+	if ( _gDevice == NULL )
+		return ATCA_GEN_FAIL;
+
+	if ( _gSessionDepth++ > 0 )
+		return ATCA_SUCCESS;
+
+	_gSessionPending = false;
+	_gSessionLost = false;
+	if ( (status = atcab_wakeup()) != ATCA_SUCCESS ) {
+		_gSessionDepth = 0;
+		_gSessionAwake = false;
+		return status;
+	}
+	_gSessionAwake = true;
+	_gSessionTime = 0;
+
+	return ATCA_SUCCESS;
+}
+
+/** \brief end a session and idle the device
+ *  \return ATCA_SUCCESS when the device stayed awake for the whole session, ATCA_RESYNC_WITH_WAKEUP
+ *          when a command failed and the device had to be woken again, so state held in TempKey
+ *          by earlier commands of the session may be lost, otherwise the idle status.
+ */
+ATCA_STATUS atcab_session_end(void)
+{
+	ATCA_STATUS status = ATCA_SUCCESS;
+
+	if ( _gSessionDepth == 0 )
+		return ATCA_FUNC_FAIL;
+
+	if ( --_gSessionDepth > 0 )
+		return ATCA_SUCCESS;
+
+	if ( _gSessionAwake )
+		status = atcab_idle();
+	_gSessionAwake = false;
+
+	return _gSessionLost ? ATCA_RESYNC_WITH_WAKEUP : status;
+}
+
+/** \brief note whether a command got a response from an awake device, for the session
+ *  \param[in] status    status of the receive
+ *  \param[in] rxdata    response
+ *  \param[in] rxlength  length of the response
+ */
+static void _atcab_received(ATCA_STATUS status, const uint8_t *rxdata, uint16_t rxlength)
+{
+	// a wake status instead of a response means the device had gone to sleep
+	if ( status == ATCA_SUCCESS && rxlength >= 4 && !(rxdata[0] == 0x04 && rxdata[1] == 0x11) )
+		_gSessionPending = false;
+}
+
+/** \brief wait for the device to execute a command, and receive the response
+ *
+ *  With polling, the response is first tried after a delay learned for each command, and then
+ *  every ATCA_POLLING_INTERVAL_US until the device acknowledges its address. The delay moves
+ *  towards one poll before the observed completion, so most commands are picked up by the first
+ *  or second poll. Without polling, the worst case execution time is always waited.
+ *  Either way the device is given no longer than the execution time of the command.
+ *
+ *  \param[in]    cmd       command which was sent
+ *  \param[out]   rxdata    buffer for the response
+ *  \param[inout] rxlength  size of rxdata as input, length of the response as output
+ *  \return ATCA_STATUS
+ */
+static ATCA_STATUS _atcab_receive(ATCA_CmdMap cmd, uint8_t *rxdata, uint16_t *rxlength)
+{
+	ATCA_STATUS status;
+	ATCAIfaceCfg *cfg = atgetifacecfg(_gIface);
+	uint32_t max_time = (uint32_t)atGetExecTime(_gCommandObj, cmd) * 1000;
+	uint32_t delay, waited, target;
+	uint16_t rxsize = *rxlength;
+	int retries;
+
+	if ( !_gPolling || cfg->iface_type != ATCA_I2C_IFACE ) {
+		atca_delay_ms(max_time / 1000);
+		_gLastWait = max_time;
+		_gSessionTime += max_time;
+		status = atreceive(_gIface, rxdata, rxlength);
+		_atcab_received(status, rxdata, *rxlength);
+		return status;
+	}
+
+	delay = atGetPollDelay(_gCommandObj, cmd);
+	if ( delay > max_time )
+		delay = max_time;
+	atca_delay_us(delay);
+	waited = delay;
+
+	// a busy device does not acknowledge its address, so try once per poll
+	retries = cfg->rx_retries;
+	cfg->rx_retries = 1;
+	while ( (status = atreceive(_gIface, rxdata, rxlength)) == ATCA_COMM_FAIL && waited < max_time ) {
+		atca_delay_us(ATCA_POLLING_INTERVAL_US);
+		waited += ATCA_POLLING_INTERVAL_US;
+		*rxlength = rxsize;
+	}
+	cfg->rx_retries = retries;
+
+	// out of time, last try with the usual retries
+	if ( status == ATCA_COMM_FAIL ) {
+		*rxlength = rxsize;
+		status = atreceive(_gIface, rxdata, rxlength);
+	}
+
+	if ( status == ATCA_SUCCESS ) {
+		if ( waited == delay ) {
+			// done before the first poll, it may have been done much earlier
+			delay -= delay / 4;
+		}else {
+			target = waited - ATCA_POLLING_INTERVAL_US;
+			delay += (target - delay) / 2;
+		}
+		atSetPollDelay(_gCommandObj, cmd, delay);
+	}
+	_gLastWait = waited;
+	_gSessionTime += waited;
+	_atcab_received(status, rxdata, *rxlength);
+
+	return status;
+}
+
+/** \brief select how the Basic API waits for commands to execute
+ *  \param[in] enable  true to poll the device for completion, false to wait the worst case execution time
+ *  \return ATCA_STATUS
+ */
+ATCA_STATUS atcab_set_polling(bool enable)
+{
+	_gPolling = enable;
+	return ATCA_SUCCESS;
+}
+
+/** \brief time waited for the last command to execute, not including the bus transfers
+ *  \return time in microseconds
+ */
+uint32_t atcab_get_last_wait(void)
+{
+	return _gLastWait;
 }
 
 
@@ -281,7 +491,6 @@ ATCA_STATUS atcab_info(uint8_t *revision )
 {
 	ATCAPacket packet;
 	ATCA_STATUS status = ATCA_GEN_FAIL;
-	uint32_t execution_time;
 
 	if ( !_gDevice )
 		return ATCA_GEN_FAIL;
@@ -300,20 +509,15 @@ ATCA_STATUS atcab_info(uint8_t *revision )
 		if ( (status = atInfo( _gCommandObj, &packet )) != ATCA_SUCCESS )
 			BREAK(status, "Failed to construct Info command");
 
-		execution_time = atGetExecTime( _gCommandObj, CMD_INFO);
-
-		if ( (status = atcab_wakeup()) != ATCA_SUCCESS )
+		if ( (status = _atcab_enter()) != ATCA_SUCCESS )
 			BREAK(status, "Failed to wakeup");
 
 		// send the command
 		if ( (status = atsend( _gIface, (uint8_t*)&packet, packet.txsize )) != ATCA_SUCCESS )
 			BREAK(status, "Failed to send Info command");
 
-		// delay the appropriate amount of time for command to execute
-		atca_delay_ms(execution_time);
-
 		// receive the response
-		if ( (status = atreceive( _gIface, &(packet.info[0]), &(packet.rxsize) )) != ATCA_SUCCESS )
+		if ( (status = _atcab_receive(CMD_INFO, &(packet.info[0]), &(packet.rxsize) )) != ATCA_SUCCESS )
 			BREAK(status, "Failed to receive Info command");
 
 		// Check response size
@@ -345,7 +549,6 @@ ATCA_STATUS atcab_random(uint8_t *rand_out)
 {
 	ATCA_STATUS status = ATCA_GEN_FAIL;
 	ATCAPacket packet;
-	uint16_t execution_time = 0;
 
 	if ( !_gDevice )
 		return ATCA_GEN_FAIL;
@@ -357,20 +560,15 @@ ATCA_STATUS atcab_random(uint8_t *rand_out)
         if ( (status = atRandom( _gCommandObj, &packet )) != ATCA_SUCCESS )
             break;
         
-        execution_time = atGetExecTime( _gCommandObj, CMD_RANDOM);
-        
-		if ( (status = atcab_wakeup()) != ATCA_SUCCESS )
+		if ( (status = _atcab_enter()) != ATCA_SUCCESS )
 			break;
 
 		// send the command
 		if ( (status = atsend( _gIface, (uint8_t*)&packet, packet.txsize )) != ATCA_SUCCESS)
 			break;
 
-		// delay the appropriate amount of time for command to execute
-		atca_delay_ms(execution_time);
-
 		// receive the response
-		if ( (status = atreceive( _gIface, packet.info, &packet.rxsize)) != ATCA_SUCCESS)
+		if ( (status = _atcab_receive(CMD_RANDOM, packet.info, &packet.rxsize)) != ATCA_SUCCESS)
 			break;
 
 		// Check response size
@@ -427,7 +625,6 @@ ATCA_STATUS atcab_random(uint8_t *rand_out)
 ATCA_STATUS atcab_genkey_base(uint8_t mode, uint16_t key_id, const uint8_t* other_data, uint8_t* public_key)
 {
     ATCAPacket packet;
-    uint16_t execution_time = 0;
     ATCA_STATUS status = ATCA_GEN_FAIL;
 
     if ( !_gDevice )
@@ -442,20 +639,15 @@ ATCA_STATUS atcab_genkey_base(uint8_t mode, uint16_t key_id, const uint8_t* othe
         if ((status = atGenKey( _gCommandObj, &packet)) != ATCA_SUCCESS)
             break;
 
-        execution_time = atGetExecTime(_gCommandObj, CMD_GENKEY);
-
-        if ((status = atcab_wakeup()) != ATCA_SUCCESS)
+        if ((status = _atcab_enter()) != ATCA_SUCCESS)
             break;
 
         // send the command
         if ((status = atsend(_gIface, (uint8_t*)&packet, packet.txsize )) != ATCA_SUCCESS)
             break;
 
-        // delay the appropriate amount of time for command to execute
-        atca_delay_ms(execution_time);
-
         // receive the response
-        if ((status = atreceive(_gIface, packet.info, &(packet.rxsize))) != ATCA_SUCCESS)
+        if ((status = _atcab_receive(CMD_GENKEY, packet.info, &(packet.rxsize))) != ATCA_SUCCESS)
             break;
 
         // Check response size
@@ -520,7 +712,6 @@ ATCA_STATUS atcab_challenge(const uint8_t *challenge)
 {
 	ATCA_STATUS status = ATCA_GEN_FAIL;
 	ATCAPacket packet;
-	uint16_t execution_time = 0;
 
 	do {
 		// Verify the inputs
@@ -537,20 +728,15 @@ ATCA_STATUS atcab_challenge(const uint8_t *challenge)
 		if ((status = atNonce( _gCommandObj, &packet )) != ATCA_SUCCESS )
 			break;
 
-		execution_time = atGetExecTime( _gCommandObj, CMD_NONCE);
-
-		if ((status = atcab_wakeup()) != ATCA_SUCCESS )
+		if ((status = _atcab_enter()) != ATCA_SUCCESS )
 			break;
 
 		// send the command
 		if ((status = atsend( _gIface, (uint8_t*)&packet, packet.txsize)) != ATCA_SUCCESS )
 			break;
 
-		// delay the appropriate amount of time for command to execute
-		atca_delay_ms(execution_time);
-
 		// receive the response
-		if ((status = atreceive( _gIface, packet.info, &(packet.rxsize))) != ATCA_SUCCESS )
+		if ((status = _atcab_receive(CMD_NONCE, packet.info, &(packet.rxsize))) != ATCA_SUCCESS )
 			break;
 
 		// Check response size
@@ -580,7 +766,6 @@ ATCA_STATUS atcab_challenge_seed_update( const uint8_t *seed, uint8_t* rand_out
 {
 	ATCA_STATUS status = ATCA_GEN_FAIL;
 	ATCAPacket packet;
-	uint16_t execution_time = 0;
 
 	do {
 		// Verify the inputs
@@ -596,18 +781,13 @@ ATCA_STATUS atcab_challenge_seed_update( const uint8_t *seed, uint8_t* rand_out
 
 		if ((status = atNonce(_gCommandObj, &packet)) != ATCA_SUCCESS) break;
 
-		execution_time = atGetExecTime(_gCommandObj, CMD_NONCE);
-
-		if ((status = atcab_wakeup()) != ATCA_SUCCESS ) break;
+		if ((status = _atcab_enter()) != ATCA_SUCCESS ) break;
 
 		// send the command
 		if ( (status = atsend( _gIface, (uint8_t*)&packet, packet.txsize)) != ATCA_SUCCESS ) break;
 
-		// delay the appropriate amount of time for command to execute
-		atca_delay_ms(execution_time);
-
 		// receive the response
-		if ((status = atreceive(_gIface, packet.info, &(packet.rxsize))) != ATCA_SUCCESS) break;
+		if ((status = _atcab_receive(CMD_NONCE, packet.info, &(packet.rxsize))) != ATCA_SUCCESS) break;
 
 		// Check response size
 		if (packet.rxsize < 4) {
@@ -637,7 +817,6 @@ ATCA_STATUS atcab_nonce_base(uint8_t mode, const uint8_t *num_in, uint8_t* rand_
 {
 	ATCA_STATUS status = ATCA_GEN_FAIL;
 	ATCAPacket packet;
-	uint16_t execution_time = 0;
 
 	do {
 
@@ -652,18 +831,13 @@ ATCA_STATUS atcab_nonce_base(uint8_t mode, const uint8_t *num_in, uint8_t* rand_
 
 		if ((status = atNonce(_gCommandObj, &packet)) != ATCA_SUCCESS) break;
 
-		execution_time = atGetExecTime(_gCommandObj, CMD_NONCE);
-
-		if ((status = atcab_wakeup()) != ATCA_SUCCESS) break;
+		if ((status = _atcab_enter()) != ATCA_SUCCESS) break;
 
 		// send the command
 		if ((status = atsend(_gIface, (uint8_t*)&packet, packet.txsize)) != ATCA_SUCCESS) break;
 
-		// delay the appropriate amount of time for command to execute
-		atca_delay_ms(execution_time);
-
 		// receive the response
-		if ((status = atreceive(_gIface, packet.info, &(packet.rxsize))) != ATCA_SUCCESS) break;
+		if ((status = _atcab_receive(CMD_NONCE, packet.info, &(packet.rxsize))) != ATCA_SUCCESS) break;
 
 		// Check response size
 		if (packet.rxsize < 4) {
@@ -738,7 +912,6 @@ ATCA_STATUS atcab_verify(uint8_t mode, uint16_t key_id, const uint8_t* signature
 {
     ATCA_STATUS status = ATCA_GEN_FAIL;
     ATCAPacket packet;
-    uint16_t execution_time = 0;
 
     if ( !_gDevice )
         return ATCA_GEN_FAIL;
@@ -764,20 +937,15 @@ ATCA_STATUS atcab_verify(uint8_t mode, uint16_t key_id, const uint8_t* signature
         if ( (status = atVerify( _gCommandObj, &packet )) != ATCA_SUCCESS )
             break;
 
-        execution_time = atGetExecTime( _gCommandObj, CMD_VERIFY );
-
-        if ( (status = atcab_wakeup()) != ATCA_SUCCESS )
+        if ( (status = _atcab_enter()) != ATCA_SUCCESS )
             break;
 
         // send the command
         if ( (status = atsend( _gIface, (uint8_t*)&packet, packet.txsize )) != ATCA_SUCCESS )
             break;
 
-        // delay the appropriate amount of time for command to execute
-        atca_delay_ms(execution_time);
-
         // receive the response
-        if ( (status = atreceive( _gIface, packet.info, &(packet.rxsize) )) != ATCA_SUCCESS )
+        if ( (status = _atcab_receive(CMD_VERIFY, packet.info, &(packet.rxsize) )) != ATCA_SUCCESS )
             break;
 
         // Check response size
@@ -820,6 +988,9 @@ ATCA_STATUS atcab_verify_extern(const uint8_t *message, const uint8_t *signature
 	if (signature == NULL || message == NULL || public_key == NULL || is_verified == NULL)
 		return ATCA_BAD_PARAM;
 
+	if ( (status = atcab_session_begin()) != ATCA_SUCCESS )
+		return status;
+
 	do {
 		// nonce passthrough
 		if ( (status = atcab_challenge(message)) != ATCA_SUCCESS )
@@ -831,7 +1002,7 @@ ATCA_STATUS atcab_verify_extern(const uint8_t *message, const uint8_t *signature
 			status = ATCA_SUCCESS; // Verify failed, but command succeeded
 	} while (0);
 
-	_atcab_exit();
+	atcab_session_end();
 	return status;
 }
 
@@ -859,6 +1030,9 @@ ATCA_STATUS atcab_verify_stored(const uint8_t *message, const uint8_t *signature
 	if (signature == NULL || message == NULL || is_verified == NULL)
 		return ATCA_BAD_PARAM;
 
+	if ( (status = atcab_session_begin()) != ATCA_SUCCESS )
+		return status;
+
 	do {
 		// nonce passthrough
 		if ( (status = atcab_challenge(message)) != ATCA_SUCCESS )
@@ -870,7 +1044,7 @@ ATCA_STATUS atcab_verify_stored(const uint8_t *message, const uint8_t *signature
 			status = ATCA_SUCCESS; // Verify failed, but command succeeded
 	} while (0);
 
-	_atcab_exit();
+	atcab_session_end();
 	return status;
 }
 
@@ -955,7 +1129,6 @@ ATCA_STATUS atcab_ecdh(uint16_t key_id, const uint8_t* pubkey, uint8_t* pms)
 {
 	ATCA_STATUS status;
 	ATCAPacket packet;
-	uint16_t execution_time = 0;
 
 	do {
 		if (pubkey == NULL || pms == NULL) {
@@ -971,15 +1144,11 @@ ATCA_STATUS atcab_ecdh(uint16_t key_id, const uint8_t* pubkey, uint8_t* pms)
 
 		if ( (status = atECDH( _gCommandObj, &packet )) != ATCA_SUCCESS ) break;
 
-		execution_time = atGetExecTime( _gCommandObj, CMD_ECDH);
-
-		if ( (status = atcab_wakeup()) != ATCA_SUCCESS ) break;
+		if ( (status = _atcab_enter()) != ATCA_SUCCESS ) break;
 
 		if ( (status = atsend(_gIface, (uint8_t*)&packet, packet.txsize)) != ATCA_SUCCESS ) break;
 
-		atca_delay_ms(execution_time);
-
-		if ((status = atreceive(_gIface, packet.info, &packet.rxsize)) != ATCA_SUCCESS) break;
+		if ((status = _atcab_receive(CMD_ECDH, packet.info, &packet.rxsize)) != ATCA_SUCCESS) break;
 
 		// Check response size
 		if (packet.rxsize < 4) {
@@ -1229,7 +1398,6 @@ ATCA_STATUS atcab_write(uint8_t zone, uint16_t address, const uint8_t *value, co
 {
 	ATCA_STATUS status = ATCA_GEN_FAIL;
 	ATCAPacket packet;
-	uint16_t execution_time = 0;
 
 	if (value == NULL)
 		return ATCA_BAD_PARAM;
@@ -1254,20 +1422,15 @@ ATCA_STATUS atcab_write(uint8_t zone, uint16_t address, const uint8_t *value, co
         if ((status = atWrite(_gCommandObj, &packet, mac && (zone & ATCA_ZONE_READWRITE_32))) != ATCA_SUCCESS)
 			break;
         
-		execution_time = atGetExecTime(_gCommandObj, CMD_WRITEMEM);
-
-		if ((status = atcab_wakeup()) != ATCA_SUCCESS)
+		if ((status = _atcab_enter()) != ATCA_SUCCESS)
 			break;
 
 		// send the command
 		if ((status = atsend(_gIface, (uint8_t*)&packet, packet.txsize)) != ATCA_SUCCESS)
 			break;
 
-		// delay the appropriate amount of time for command to execute
-		atca_delay_ms(execution_time);
-
 		// receive the response
-		if ((status = atreceive(_gIface, packet.info, &(packet.rxsize))) != ATCA_SUCCESS)
+		if ((status = _atcab_receive(CMD_WRITEMEM, packet.info, &(packet.rxsize))) != ATCA_SUCCESS)
 			break;
 
 		// Check response size
@@ -1348,7 +1511,6 @@ ATCA_STATUS atcab_read_zone(uint8_t zone, uint16_t slot, uint8_t block, uint8_t
 	ATCA_STATUS status = ATCA_SUCCESS;
 	ATCAPacket packet;
 	uint16_t addr;
-	uint16_t execution_time = 0;
 
 	do {
 		// Check the input parameters
@@ -1373,19 +1535,14 @@ ATCA_STATUS atcab_read_zone(uint8_t zone, uint16_t slot, uint8_t block, uint8_t
 		if ( (status = atRead( _gCommandObj, &packet )) != ATCA_SUCCESS )
 			break;
 
-		execution_time = atGetExecTime( _gCommandObj, CMD_READMEM);
-
-		if ( (status = atcab_wakeup()) != ATCA_SUCCESS ) break;
+		if ( (status = _atcab_enter()) != ATCA_SUCCESS ) break;
 
 		// send the command
 		if ( (status = atsend( _gIface, (uint8_t*)&packet, packet.txsize )) != ATCA_SUCCESS )
 			break;
 
-		// delay the appropriate amount of time for command to execute
-		atca_delay_ms(execution_time);
-
 		// receive the response
-		if ( (status = atreceive( _gIface, packet.info, &(packet.rxsize) )) != ATCA_SUCCESS )
+		if ( (status = _atcab_receive(CMD_READMEM, packet.info, &(packet.rxsize) )) != ATCA_SUCCESS )
 			break;
 
 		// Check response size
@@ -1572,11 +1729,13 @@ ATCA_STATUS atcab_read_ecc_config_zone(uint8_t* config_data)
 {
 	ATCA_STATUS status = ATCA_GEN_FAIL;
 	ATCAPacket packet;
-	uint16_t execution_time = 0;
 	uint8_t zone = 0, block = 0, offset = 0, slot = 0, index = 0;
 	uint16_t addr = 0x0000;
 
 	//reading the zone block by block until word 16 (block 2, offset 6)
+	if ( (status = atcab_session_begin()) != ATCA_SUCCESS )
+		return status;
+
 	do {
 		if ((block == 2) && (offset <= 7)) {
 			// read 32 bytes at once
@@ -1588,22 +1747,18 @@ ATCA_STATUS atcab_read_ecc_config_zone(uint8_t* config_data)
 
 			packet.param2 =  addr;
 			status = atRead(_gCommandObj, &packet);
-			execution_time = atGetExecTime( _gCommandObj, CMD_READMEM);
 
-			if ( (status = atcab_wakeup()) != ATCA_SUCCESS )
+			if ( (status = _atcab_enter()) != ATCA_SUCCESS )
 				break;
 
 			// send the command
 			if ( (status = atsend( _gIface, (uint8_t*)&packet, packet.txsize )) != ATCA_SUCCESS )
 				break;
 
-			// delay the appropriate amount of time for command to execute
-			atca_delay_ms(execution_time);
-
 			memset(packet.info, 0x00, 130);
 
 			// receive the response
-			if ( (status = atreceive( _gIface, packet.info, &packet.rxsize)) != ATCA_SUCCESS )
+			if ( (status = _atcab_receive(CMD_READMEM, packet.info, &packet.rxsize)) != ATCA_SUCCESS )
 				break;
 
 			// Check response size
@@ -1615,7 +1770,7 @@ ATCA_STATUS atcab_read_ecc_config_zone(uint8_t* config_data)
 				break;
 			}
 
-			if ( (status = atcab_idle()) != ATCA_SUCCESS )
+			if ( (status = _atcab_exit()) != ATCA_SUCCESS )
 				break;
 
 			// check for error in response
@@ -1642,21 +1797,17 @@ ATCA_STATUS atcab_read_ecc_config_zone(uint8_t* config_data)
 
 			packet.param2 =  addr;
 			status = atRead(_gCommandObj, &packet);
-			execution_time = atGetExecTime( _gCommandObj, CMD_READMEM);
 
-			if ( (status = atcab_wakeup()) != ATCA_SUCCESS ) break;
+			if ( (status = _atcab_enter()) != ATCA_SUCCESS ) break;
 
 			// send the command
 			if ( (status = atsend( _gIface, (uint8_t*)&packet, packet.txsize )) != ATCA_SUCCESS )
 				break;
 
-			// delay the appropriate amount of time for command to execute
-			atca_delay_ms(execution_time);
-
 			memset(packet.info, 0x00, sizeof(packet.info));
 
 			// receive the response
-			if ( (status = atreceive( _gIface, packet.info, &packet.rxsize)) != ATCA_SUCCESS )
+			if ( (status = _atcab_receive(CMD_READMEM, packet.info, &packet.rxsize)) != ATCA_SUCCESS )
 				break;
 
 			// Check response size
@@ -1668,7 +1819,7 @@ ATCA_STATUS atcab_read_ecc_config_zone(uint8_t* config_data)
 				break;
 			}
 
-			if ( (status = atcab_idle()) != ATCA_SUCCESS )
+			if ( (status = _atcab_exit()) != ATCA_SUCCESS )
 				break;
 
 			// check for error in response
@@ -1685,7 +1836,7 @@ ATCA_STATUS atcab_read_ecc_config_zone(uint8_t* config_data)
 
 	} while (block <= 3);
 
-	_atcab_exit();
+	atcab_session_end();
 	return status;
 }
 
@@ -1697,12 +1848,14 @@ ATCA_STATUS atcab_write_ecc_config_zone(const uint8_t* config_data)
 {
 	ATCA_STATUS status = ATCA_GEN_FAIL;
 	ATCAPacket packet;
-	uint16_t execution_time = 0;
 	uint8_t zone = 0, block = 0, offset = 0, slot = 0, index = 0;
 	uint16_t addr = 0;
 
 	// write the ecc zone one block at a time starting after address 0x04 (block 0, offset 4)
 	offset = 4;
+	if ( (status = atcab_session_begin()) != ATCA_SUCCESS )
+		return status;
+
 	do {
 		if ((block == 0) || (block == 2)) {
 
@@ -1718,19 +1871,15 @@ ATCA_STATUS atcab_write_ecc_config_zone(const uint8_t* config_data)
 				memcpy(&packet.info[0], &config_data[index + 16], ATCA_WORD_SIZE);
 				index += ATCA_WORD_SIZE;
 				status = atWrite(_gCommandObj, &packet, false);
-				execution_time = atGetExecTime( _gCommandObj, CMD_WRITEMEM);
 
-				if ( (status = atcab_wakeup()) != ATCA_SUCCESS ) break;
+				if ( (status = _atcab_enter()) != ATCA_SUCCESS ) break;
 
 				// send the command
 				if ( (status = atsend( _gIface, (uint8_t*)&packet, packet.txsize )) != ATCA_SUCCESS )
 					break;
 
-				// delay the appropriate amount of time for command to execute
-				atca_delay_ms(execution_time);
-
 				// receive the response
-				if ( (status = atreceive( _gIface, packet.info, &packet.rxsize)) != ATCA_SUCCESS )
+				if ( (status = _atcab_receive(CMD_WRITEMEM, packet.info, &packet.rxsize)) != ATCA_SUCCESS )
 					break;
 
 				// Check response size
@@ -1742,7 +1891,7 @@ ATCA_STATUS atcab_write_ecc_config_zone(const uint8_t* config_data)
 					break;
 				}
 
-				if ( (status = atcab_idle()) != ATCA_SUCCESS ) break;
+				if ( (status = _atcab_exit()) != ATCA_SUCCESS ) break;
 
 				if ( (status = isATCAError(packet.info)) != ATCA_SUCCESS )
 					break;
@@ -1769,19 +1918,14 @@ ATCA_STATUS atcab_write_ecc_config_zone(const uint8_t* config_data)
 			if ( (status = atWrite(_gCommandObj, &packet, false)) != ATCA_SUCCESS )
 				break;
 
-			execution_time = atGetExecTime( _gCommandObj, CMD_WRITEMEM);
-
-			if ( (status = atcab_wakeup()) != ATCA_SUCCESS ) break;
+			if ( (status = _atcab_enter()) != ATCA_SUCCESS ) break;
 
 			// send the command
 			if ( (status = atsend( _gIface, (uint8_t*)&packet, packet.txsize )) != ATCA_SUCCESS )
 				break;
 
-			// delay the appropriate amount of time for command to execute
-			atca_delay_ms(execution_time);
-
 			// receive the response
-			if ( (status = atreceive( _gIface, packet.info, &packet.rxsize)) != ATCA_SUCCESS )
+			if ( (status = _atcab_receive(CMD_WRITEMEM, packet.info, &packet.rxsize)) != ATCA_SUCCESS )
 				break;
 
 			// Check response size
@@ -1793,7 +1937,7 @@ ATCA_STATUS atcab_write_ecc_config_zone(const uint8_t* config_data)
 				break;
 			}
 
-			if ( (status = atcab_idle()) != ATCA_SUCCESS ) break;
+			if ( (status = _atcab_exit()) != ATCA_SUCCESS ) break;
 
 			if ( (status = isATCAError(packet.info)) != ATCA_SUCCESS )
 				break;
@@ -1804,7 +1948,73 @@ ATCA_STATUS atcab_write_ecc_config_zone(const uint8_t* config_data)
 
 	} while (block <= 3);
 
-	_atcab_exit();
+	atcab_session_end();
+	return status;
+}
+
+/** \brief given an ECC configuration zone buffer, write only the words which differ from the device's config zone
+ *
+ *  Words the Write command cannot change, the first 16 bytes and UserExtra to LockConfig, are left alone.
+ *  A block of which several words differ is written with one 32-byte write, other words with 4-byte writes.
+ *  All writes run in one session.
+ *  \param[in] config_data pointer to the 128 bytes the config zone should hold
+ *  \param[inout] device_config pointer to the 128 bytes the config zone holds, read by the caller, updated with
+ *                 the bytes written, so it can be used to compute the CRC of the lock
+ *  \param[out] words_written number of 4-byte words written, a 32-byte write counts as eight, may be NULL
+ *  \returns ATCA_STATUS
+ */
+ATCA_STATUS atcab_update_ecc_config_zone(const uint8_t* config_data, uint8_t* device_config, uint8_t* words_written)
+{
+	// writable words of each block of the config zone
+	static const uint8_t writable[ATCA_CONFIG_SIZE / ATCA_BLOCK_SIZE] = { 0xF0, 0xFF, 0xDF, 0xFF };
+	ATCA_STATUS status = ATCA_SUCCESS;
+	uint8_t block, word, diff, count, written = 0;
+	size_t index;
+
+	if ( config_data == NULL || device_config == NULL )
+		return ATCA_BAD_PARAM;
+
+	if ( (status = atcab_session_begin()) != ATCA_SUCCESS )
+		return status;
+
+	for (block = 0; block < ATCA_CONFIG_SIZE / ATCA_BLOCK_SIZE && status == ATCA_SUCCESS; block++) {
+		diff = 0;
+		count = 0;
+		for (word = 0; word < ATCA_BLOCK_SIZE / ATCA_WORD_SIZE; word++) {
+			index = block * ATCA_BLOCK_SIZE + word * ATCA_WORD_SIZE;
+			if ( (writable[block] & (1 << word)) && memcmp(&device_config[index], &config_data[index], ATCA_WORD_SIZE) != 0 ) {
+				diff |= 1 << word;
+				count++;
+			}
+		}
+		if (count == 0)
+			continue;
+
+		index = block * ATCA_BLOCK_SIZE;
+		if (count > 1 && writable[block] == 0xFF) {
+			if ( (status = atcab_write_zone(ATCA_ZONE_CONFIG, 0, block, 0, &config_data[index], ATCA_BLOCK_SIZE)) != ATCA_SUCCESS )
+				break;
+			memcpy(&device_config[index], &config_data[index], ATCA_BLOCK_SIZE);
+			written += ATCA_BLOCK_SIZE / ATCA_WORD_SIZE;
+			continue;
+		}
+
+		for (word = 0; word < ATCA_BLOCK_SIZE / ATCA_WORD_SIZE; word++) {
+			if ( !(diff & (1 << word)) )
+				continue;
+			index = block * ATCA_BLOCK_SIZE + word * ATCA_WORD_SIZE;
+			if ( (status = atcab_write_zone(ATCA_ZONE_CONFIG, 0, block, word, &config_data[index], ATCA_WORD_SIZE)) != ATCA_SUCCESS )
+				break;
+			memcpy(&device_config[index], &config_data[index], ATCA_WORD_SIZE);
+			written++;
+		}
+	}
+
+	if (words_written)
+		*words_written = written;
+
+	// writes do not depend on TempKey, a session which had to wake the device again does not matter
+	atcab_session_end();
 	return status;
 }
 
@@ -1967,7 +2177,6 @@ ATCA_STATUS atcab_lock(uint8_t mode, uint16_t summary, uint8_t* lock_response)
 {
     ATCA_STATUS status = ATCA_GEN_FAIL;
     ATCAPacket packet;
-    uint16_t execution_time = 0;
 
     // build command for lock zone and send
     memset(&packet, 0, sizeof(packet));
@@ -1977,19 +2186,14 @@ ATCA_STATUS atcab_lock(uint8_t mode, uint16_t summary, uint8_t* lock_response)
     do {
         if ((status = atLock(_gCommandObj, &packet)) != ATCA_SUCCESS) break;
 
-        execution_time = atGetExecTime(_gCommandObj, CMD_LOCK);
-
-        if ((status = atcab_wakeup()) != ATCA_SUCCESS) break;
+        if ((status = _atcab_enter()) != ATCA_SUCCESS) break;
 
         // send the command
         if ((status = atsend(_gIface, (uint8_t*)&packet, packet.txsize)) != ATCA_SUCCESS)
             break;
 
-        // delay the appropriate amount of time for command to execute
-        atca_delay_ms(execution_time);
-
         // receive the response
-        if ((status = atreceive(_gIface, packet.info, &packet.rxsize)) != ATCA_SUCCESS)
+        if ((status = _atcab_receive(CMD_LOCK, packet.info, &packet.rxsize)) != ATCA_SUCCESS)
             break;
 
         // Check response size
@@ -2116,7 +2320,6 @@ ATCA_STATUS atcab_sign_base(uint8_t mode, uint16_t key_id, uint8_t *signature)
 {
     ATCA_STATUS status = ATCA_GEN_FAIL;
     ATCAPacket packet;
-    uint16_t execution_time = 0;
     
     if (signature == NULL)
         return ATCA_BAD_PARAM;
@@ -2131,20 +2334,15 @@ ATCA_STATUS atcab_sign_base(uint8_t mode, uint16_t key_id, uint8_t *signature)
         if ((status = atSign(_gCommandObj, &packet)) != ATCA_SUCCESS)
             break;
 
-        execution_time = atGetExecTime(_gCommandObj, CMD_SIGN);
-
-        if ((status != atcab_wakeup()) != ATCA_SUCCESS)
+        if ((status = _atcab_enter()) != ATCA_SUCCESS)
             break;
 
         // send the command
         if ((status = atsend(_gIface, (uint8_t*)&packet, packet.txsize)) != ATCA_SUCCESS)
             break;
 
-        // delay the appropriate amount of time for command to execute
-        atca_delay_ms(execution_time);
-
         // receive the response
-        if ((status = atreceive(_gIface, packet.info, &(packet.rxsize))) != ATCA_SUCCESS)
+        if ((status = _atcab_receive(CMD_SIGN, packet.info, &(packet.rxsize))) != ATCA_SUCCESS)
             break;
 
         // Check response size
@@ -2183,7 +2381,10 @@ ATCA_STATUS atcab_sign_base(uint8_t mode, uint16_t key_id, uint8_t *signature)
 ATCA_STATUS atcab_sign(uint16_t key_id, const uint8_t *msg, uint8_t *signature)
 {
 	ATCA_STATUS status = ATCA_GEN_FAIL;
-    
+
+	if ( (status = atcab_session_begin()) != ATCA_SUCCESS )
+		return status;
+
 	do {
         // Make sure RNG has updated its seed
 		if ( (status = atcab_random(NULL)) != ATCA_SUCCESS )
@@ -2195,7 +2396,8 @@ ATCA_STATUS atcab_sign(uint16_t key_id, const uint8_t *msg, uint8_t *signature)
         if ( (status = atcab_sign_base(SIGN_MODE_EXTERNAL, key_id, signature)) != ATCA_SUCCESS)
             break;
 	} while (0);
-    
+
+	atcab_session_end();
 	return status;
 }
 
@@ -2246,7 +2448,6 @@ ATCA_STATUS atcab_gendig(uint8_t zone, uint16_t key_id, const uint8_t *other_dat
 {
 	ATCA_STATUS status = ATCA_GEN_FAIL;
 	ATCAPacket packet;
-	uint16_t execution_time = 0;
 	bool hasMACKey = 0;
 
 	if ( !_gDevice)
@@ -2270,19 +2471,14 @@ ATCA_STATUS atcab_gendig(uint8_t zone, uint16_t key_id, const uint8_t *other_dat
 		if ( (status = atGenDig( _gCommandObj, &packet, hasMACKey)) != ATCA_SUCCESS )
 			break;
 
-		execution_time = atGetExecTime( _gCommandObj, CMD_GENDIG);
-
-		if ( (status != atcab_wakeup()) != ATCA_SUCCESS ) break;
+		if ( (status = _atcab_enter()) != ATCA_SUCCESS ) break;
 
 		// send the command
 		if ( (status = atsend( _gIface, (uint8_t*)&packet, packet.txsize )) != ATCA_SUCCESS )
 			break;
 
-		// delay the appropriate amount of time for command to execute
-		atca_delay_ms(execution_time);
-
 		// receive the response
-		if ( (status = atreceive( _gIface, packet.info, &(packet.rxsize))) != ATCA_SUCCESS )
+		if ( (status = _atcab_receive(CMD_GENDIG, packet.info, &(packet.rxsize))) != ATCA_SUCCESS )
 			break;
 
 		// Check response size
@@ -2378,7 +2574,6 @@ ATCA_STATUS atcab_priv_write(uint16_t key_id, const uint8_t priv_key[36], uint8_
 	uint8_t randout[RANDOM_NUM_SIZE] = { 0 };
 	uint8_t cipher_text[36] = { 0 };
 	uint8_t host_mac[MAC_SIZE] = { 0 };
-	uint16_t execution_time = 0;
 
 	if (key_id > 15 || priv_key == NULL)
 		return ATCA_BAD_PARAM;
@@ -2445,19 +2640,14 @@ ATCA_STATUS atcab_priv_write(uint16_t key_id, const uint8_t priv_key[36], uint8_
 		if ((status = atPrivWrite(_gCommandObj, &packet)) != ATCA_SUCCESS)
 			break;
 
-		execution_time = atGetExecTime(_gCommandObj, CMD_PRIVWRITE);
-
-		if ( (status = atcab_wakeup()) != ATCA_SUCCESS ) break;
+		if ( (status = _atcab_enter()) != ATCA_SUCCESS ) break;
 
 		// send the command
 		if ((status = atsend(_gIface, (uint8_t*)&packet, packet.txsize)) != ATCA_SUCCESS)
 			break;
 
-		// delay the appropriate amount of time for command to execute
-		atca_delay_ms(execution_time);
-
 		// receive the response
-		if ((status = atreceive(_gIface, packet.info, &packet.rxsize)) != ATCA_SUCCESS)
+		if ((status = _atcab_receive(CMD_PRIVWRITE, packet.info, &packet.rxsize)) != ATCA_SUCCESS)
 			break;
 
 		// Check response size
@@ -2574,6 +2764,9 @@ ATCA_STATUS atcab_read_pubkey(uint16_t slot8toF, uint8_t *pubkey)
 	if (slot8toF < 8 || slot8toF > 0xF)
 		return ATCA_BAD_PARAM;
 
+	if ( (ret = atcab_session_begin()) != ATCA_SUCCESS )
+		return ret;
+
 	do {
 		// The 64 byte P256 public key gets written to a 72 byte slot in the following pattern
 		// | Block 1                     | Block 2                                      | Block 3       |
@@ -2618,6 +2811,7 @@ ATCA_STATUS atcab_read_pubkey(uint16_t slot8toF, uint8_t *pubkey)
 
 	} while (0);
 
+	atcab_session_end();
 	return ret;
 }
 
@@ -2658,13 +2852,19 @@ ATCA_STATUS atcab_write_bytes_zone(uint8_t zone, uint16_t slot, size_t offset_by
     if (offset_bytes % ATCA_WORD_SIZE != 0 || length % ATCA_WORD_SIZE != 0)
         return ATCA_BAD_PARAM;
     
+    if ( (status = atcab_session_begin()) != ATCA_SUCCESS )
+        return status;
+
     do 
     {
         status = atcab_get_zone_size(zone, slot, &zone_size);
         if (status != ATCA_SUCCESS)
             break;
         if (offset_bytes + length > zone_size)
-            return ATCA_BAD_PARAM;
+        {
+            status = ATCA_BAD_PARAM;
+            break;
+        }
             
         cur_block = offset_bytes / ATCA_BLOCK_SIZE;
         cur_word = (offset_bytes % ATCA_BLOCK_SIZE) / ATCA_WORD_SIZE;
@@ -2709,7 +2909,8 @@ ATCA_STATUS atcab_write_bytes_zone(uint8_t zone, uint16_t slot, size_t offset_by
             }
         }
     } while (false);
-    
+
+    atcab_session_end();
 	return status;
 }
 
@@ -2748,13 +2949,19 @@ ATCA_STATUS atcab_read_bytes_zone(uint8_t zone, uint16_t slot, size_t offset_byt
     if (data == NULL)
         return ATCA_BAD_PARAM;
     
+	if ( (status = atcab_session_begin()) != ATCA_SUCCESS )
+		return status;
+
 	do
 	{
     	status = atcab_get_zone_size(zone, slot, &zone_size);
     	if (status != ATCA_SUCCESS)
     	    break;
     	if (offset_bytes + length > zone_size)
-    	    return ATCA_BAD_PARAM;
+    	{
+    	    status = ATCA_BAD_PARAM;
+    	    break;
+    	}
     	
         cur_block = offset_bytes / ATCA_BLOCK_SIZE;
         
@@ -2796,7 +3003,8 @@ ATCA_STATUS atcab_read_bytes_zone(uint8_t zone, uint16_t slot, size_t offset_byt
                 cur_offset += 1;
         }
 	} while (false);
-	
+
+	atcab_session_end();
 	return status;
 }
 
@@ -2812,7 +3020,6 @@ ATCA_STATUS atcab_mac( uint8_t mode, uint16_t key_id, const uint8_t* challenge,
 {
 	ATCA_STATUS status = ATCA_GEN_FAIL;
 	ATCAPacket packet;
-	uint16_t execution_time = 0;
 
 	do {
 
@@ -2835,19 +3042,14 @@ ATCA_STATUS atcab_mac( uint8_t mode, uint16_t key_id, const uint8_t* challenge,
 		if ( (status = atMAC( _gCommandObj, &packet )) != ATCA_SUCCESS )
 			break;
 
-		execution_time = atGetExecTime( _gCommandObj, CMD_MAC);
-
-		if ( (status != atcab_wakeup()) != ATCA_SUCCESS ) break;
+		if ( (status = _atcab_enter()) != ATCA_SUCCESS ) break;
 
 		// send the command
 		if ( (status = atsend( _gIface, (uint8_t*)&packet, packet.txsize )) != ATCA_SUCCESS )
 			break;
 
-		// delay the appropriate amount of time for command to execute
-		atca_delay_ms(execution_time);
-
 		// receive the response
-		if ( (status = atreceive( _gIface, packet.info, &(packet.rxsize))) != ATCA_SUCCESS )
+		if ( (status = _atcab_receive(CMD_MAC, packet.info, &(packet.rxsize))) != ATCA_SUCCESS )
 			break;
 
 		// Check response size
@@ -2883,7 +3085,6 @@ ATCA_STATUS atcab_checkmac( uint8_t mode, uint16_t key_id, const uint8_t *challe
 {
 	ATCA_STATUS status = ATCA_GEN_FAIL;
 	ATCAPacket packet;
-	uint16_t execution_time = 0;
 
     // Verify the inputs
     if (response == NULL || other_data == NULL)
@@ -2905,19 +3106,14 @@ ATCA_STATUS atcab_checkmac( uint8_t mode, uint16_t key_id, const uint8_t *challe
 		if ( (status = atCheckMAC( _gCommandObj, &packet )) != ATCA_SUCCESS )
 			break;
 
-		execution_time = atGetExecTime( _gCommandObj, CMD_CHECKMAC);
-
-		if ( (status != atcab_wakeup()) != ATCA_SUCCESS ) break;
+		if ( (status = _atcab_enter()) != ATCA_SUCCESS ) break;
 
 		// send the command
 		if ( (status = atsend( _gIface, (uint8_t*)&packet, packet.txsize )) != ATCA_SUCCESS )
 			break;
 
-		// delay the appropriate amount of time for command to execute
-		atca_delay_ms( execution_time );
-
 		// receive the response
-		if ( (status = atreceive( _gIface, packet.info, &(packet.rxsize))) != ATCA_SUCCESS )
+		if ( (status = _atcab_receive(CMD_CHECKMAC, packet.info, &(packet.rxsize))) != ATCA_SUCCESS )
 			break;
 
 		// Check response size
@@ -2955,7 +3151,6 @@ ATCA_STATUS atcab_hmac(uint8_t mode, uint16_t key_id, uint8_t *digest)
 {
     ATCA_STATUS status = ATCA_GEN_FAIL;
     ATCAPacket packet;
-    uint16_t execution_time = 0;
     
     do {
         if (digest == NULL) {
@@ -2969,20 +3164,15 @@ ATCA_STATUS atcab_hmac(uint8_t mode, uint16_t key_id, uint8_t *digest)
         if ( (status = atHMAC( _gCommandObj, &packet )) != ATCA_SUCCESS )
             break;
 
-        execution_time = atGetExecTime( _gCommandObj, CMD_DERIVEKEY);
-
-        if ( (status != atcab_wakeup()) != ATCA_SUCCESS )
+        if ( (status = _atcab_enter()) != ATCA_SUCCESS )
             break;
 
         // send the command
         if ( (status = atsend( _gIface, (uint8_t*)&packet, packet.txsize )) != ATCA_SUCCESS )
             break;
 
-        // delay the appropriate amount of time for command to execute
-        atca_delay_ms( execution_time );
-
         // receive the response
-        if ( (status = atreceive( _gIface, packet.info, &(packet.rxsize))) != ATCA_SUCCESS )
+        if ( (status = _atcab_receive(CMD_DERIVEKEY, packet.info, &(packet.rxsize))) != ATCA_SUCCESS )
             break;
 
         // Check response size
@@ -3023,7 +3213,6 @@ ATCA_STATUS atcab_derivekey(uint8_t random, uint16_t key_id, uint8_t* mac)
 {
 	ATCA_STATUS status = ATCA_GEN_FAIL;
 	ATCAPacket packet;
-	uint16_t execution_time = 0;
 
 	do {
 
@@ -3035,18 +3224,13 @@ ATCA_STATUS atcab_derivekey(uint8_t random, uint16_t key_id, uint8_t* mac)
 
 		if ((status = atNonce(_gCommandObj, &packet)) != ATCA_SUCCESS) break;
 
-		execution_time = atGetExecTime(_gCommandObj, CMD_NONCE);
-
-		if ((status = atcab_wakeup()) != ATCA_SUCCESS) break;
+		if ((status = _atcab_enter()) != ATCA_SUCCESS) break;
 
 		// send the command
 		if ((status = atsend(_gIface, (uint8_t*)&packet, packet.txsize)) != ATCA_SUCCESS) break;
 
-		// delay the appropriate amount of time for command to execute
-		atca_delay_ms(execution_time);
-
 		// receive the response
-		if ((status = atreceive(_gIface, packet.info, &(packet.rxsize))) != ATCA_SUCCESS) break;
+		if ((status = _atcab_receive(CMD_NONCE, packet.info, &(packet.rxsize))) != ATCA_SUCCESS) break;
 
 		// Check response size
 		if (packet.rxsize < 4) {
@@ -3089,7 +3273,6 @@ ATCA_STATUS atcab_sha_base(uint8_t mode, uint16_t length, const uint8_t* message
 {
 	ATCA_STATUS status = ATCA_GEN_FAIL;
 	ATCAPacket packet;
-	uint16_t execution_time = 0;
 
 	if (length > 0 && message == NULL)
 		return ATCA_BAD_PARAM;
@@ -3105,20 +3288,15 @@ ATCA_STATUS atcab_sha_base(uint8_t mode, uint16_t length, const uint8_t* message
 		if ((status = atSHA(_gCommandObj, &packet)) != ATCA_SUCCESS)
 			break;
 
-		execution_time = atGetExecTime(_gCommandObj, CMD_SHA);
-
-		if ((status != atcab_wakeup()) != ATCA_SUCCESS)
+		if ((status = _atcab_enter()) != ATCA_SUCCESS)
 			break;
 
 		// send the command
 		if ((status = atsend(_gIface, (uint8_t*)&packet, packet.txsize)) != ATCA_SUCCESS)
 			break;
 
-		// delay the appropriate amount of time for command to execute
-		atca_delay_ms(execution_time);
-
 		// receive the response
-		if ((status = atreceive(_gIface, packet.info, &(packet.rxsize))) != ATCA_SUCCESS)
+		if ((status = _atcab_receive(CMD_SHA, packet.info, &(packet.rxsize))) != ATCA_SUCCESS)
 			break;
 
 		// Check response size
@@ -3331,7 +3509,6 @@ ATCA_STATUS atcab_updateextra(uint8_t mode, uint16_t new_value)
 {
     ATCA_STATUS status = ATCA_GEN_FAIL;
     ATCAPacket packet;
-    uint16_t execution_time = 0;
 
     do {
         // Build command
@@ -3342,20 +3519,15 @@ ATCA_STATUS atcab_updateextra(uint8_t mode, uint16_t new_value)
         if ((status = atUpdateExtra(_gCommandObj, &packet)) != ATCA_SUCCESS)
             break;
 
-        execution_time = atGetExecTime(_gCommandObj, CMD_UPDATEEXTRA);
-
-        if ((status != atcab_wakeup()) != ATCA_SUCCESS)
+        if ((status = _atcab_enter()) != ATCA_SUCCESS)
             break;
 
         // send the command
         if ((status = atsend(_gIface, (uint8_t*)&packet, packet.txsize)) != ATCA_SUCCESS)
             break;
 
-        // delay the appropriate amount of time for command to execute
-        atca_delay_ms(execution_time);
-
         // receive the response
-        if ((status = atreceive(_gIface, packet.info, &(packet.rxsize))) != ATCA_SUCCESS)
+        if ((status = _atcab_receive(CMD_UPDATEEXTRA, packet.info, &(packet.rxsize))) != ATCA_SUCCESS)
             break;
 
         // Check response size
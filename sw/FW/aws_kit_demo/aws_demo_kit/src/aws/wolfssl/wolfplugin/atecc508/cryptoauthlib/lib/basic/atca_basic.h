@@ -49,6 +49,32 @@
 
 #define TBD   void
 
+/** \brief poll the device for command completion instead of waiting the worst case execution time */
+#ifndef ATCA_POLLING_ENABLE
+#define ATCA_POLLING_ENABLE         true
+#endif
+
+/** \brief interval between two polls of a busy device, in microseconds */
+#ifndef ATCA_POLLING_INTERVAL_US
+#define ATCA_POLLING_INTERVAL_US    500
+#endif
+
+/** \brief part of the watchdog timeout a session may use before the device is idled and woken again, in
+ *  milliseconds. The ATECC508A watchdog puts the device to sleep between 0.7 and 1.7 seconds after a wake. */
+#ifndef ATCA_SESSION_WINDOW_MS
+#define ATCA_SESSION_WINDOW_MS      600
+#endif
+
+/** \brief room left in the window for the next command, longer than any single command, in milliseconds */
+#ifndef ATCA_SESSION_GUARD_MS
+#define ATCA_SESSION_GUARD_MS       150
+#endif
+
+/** \brief time allowed for the bus transfers of one command, in microseconds */
+#ifndef ATCA_SESSION_XFER_US
+#define ATCA_SESSION_XFER_US        5000
+#endif
+
 /** \defgroup atcab_ Basic Crypto API methods (atcab_)
  *
  * \brief
@@ -74,6 +100,14 @@ ATCA_STATUS atcab_sleep(void);
 // discovery
 ATCA_STATUS atcab_cfg_discover( ATCAIfaceCfg cfgArray[], int max);
 
+// command completion
+ATCA_STATUS atcab_set_polling(bool enable);
+uint32_t atcab_get_last_wait(void);
+
+// sessions
+ATCA_STATUS atcab_session_begin(void);
+ATCA_STATUS atcab_session_end(void);
+
 // basic crypto API
 ATCA_STATUS atcab_info(uint8_t *revision);
 ATCA_STATUS atcab_challenge(const uint8_t *challenge);
@@ -100,6 +134,7 @@ ATCA_STATUS atcab_write_pubkey(uint16_t slot8toF, const uint8_t *pubkey);
 ATCA_STATUS atcab_read_sig(uint8_t slot8toF, uint8_t *sig);
 ATCA_STATUS atcab_read_ecc_config_zone(uint8_t* config_data);
 ATCA_STATUS atcab_write_ecc_config_zone(const uint8_t* config_data);
+ATCA_STATUS atcab_update_ecc_config_zone(const uint8_t* config_data, uint8_t* device_config, uint8_t* words_written);
 ATCA_STATUS atcab_read_sha_config_zone( uint8_t* config_data);
 ATCA_STATUS atcab_write_sha_config_zone(const uint8_t* config_data);
 ATCA_STATUS atcab_read_config_zone(uint8_t* config_data);
@@ -40,6 +40,8 @@
  */
 
 #include "atca_crypto_sw_rand.h"
+#include "atca_crypto_sw_sha2.h"
+#include <string.h>
 
 /** \brief return software generated random number
  * \param[out] data       ptr to space to receive the random number
@@ -50,4 +52,267 @@
 int atcac_sw_random(uint8_t* data, size_t data_size)
 {
 	return ATCA_UNIMPLEMENTED;
+}
+
+// Hash_DRBG KAT from the NIST CAVP vectors, SHA-256 without prediction resistance: instantiate,
+// reseed, then the second of two 128 bytes generate requests is checked.
+static const uint8_t drbg_kat_entropy[] = {
+	0x63, 0x36, 0x33, 0x77, 0xe4, 0x1e, 0x86, 0x46, 0x8d, 0xeb, 0x0a, 0xb4, 0xa8, 0xed, 0x68, 0x3f,
+	0x6a, 0x13, 0x4e, 0x47, 0xe0, 0x14, 0xc7, 0x00, 0x45, 0x4e, 0x81, 0xe9, 0x53, 0x58, 0xa5, 0x69
+};
+static const uint8_t drbg_kat_nonce[] = {
+	0x80, 0x8a, 0xa3, 0x8f, 0x2a, 0x72, 0xa6, 0x23, 0x59, 0x91, 0x5a, 0x9f, 0x8a, 0x04, 0xca, 0x68
+};
+static const uint8_t drbg_kat_reseed_entropy[] = {
+	0xe6, 0x2b, 0x8a, 0x8e, 0xe8, 0xf1, 0x41, 0xb6, 0x98, 0x05, 0x66, 0xe3, 0xbf, 0xe3, 0xc0, 0x49,
+	0x03, 0xda, 0xd4, 0xac, 0x2c, 0xdf, 0x9f, 0x22, 0x80, 0x01, 0x0a, 0x67, 0x39, 0xbc, 0x83, 0xd3
+};
+static const uint8_t drbg_kat_output[] = {
+	0x04, 0xee, 0xc6, 0x3b, 0xb2, 0x31, 0xdf, 0x2c, 0x63, 0x0a, 0x1a, 0xfb, 0xe7, 0x24, 0x94, 0x9d,
+	0x00, 0x5a, 0x58, 0x78, 0x51, 0xe1, 0xaa, 0x79, 0x5e, 0x47, 0x73, 0x47, 0xc8, 0xb0, 0x56, 0x62,
+	0x1c, 0x18, 0xbd, 0xdc, 0xdd, 0x8d, 0x99, 0xfc, 0x5f, 0xc2, 0xb9, 0x20, 0x53, 0xd8, 0xcf, 0xac,
+	0xfb, 0x0b, 0xb8, 0x83, 0x12, 0x05, 0xfa, 0xd1, 0xdd, 0xd6, 0xc0, 0x71, 0x31, 0x8a, 0x60, 0x18,
+	0xf0, 0x3b, 0x73, 0xf5, 0xed, 0xe4, 0xd4, 0xd0, 0x71, 0xf9, 0xde, 0x03, 0xfd, 0x7a, 0xea, 0x10,
+	0x5d, 0x92, 0x99, 0xb8, 0xaf, 0x99, 0xaa, 0x07, 0x5b, 0xdb, 0x4d, 0xb9, 0xaa, 0x28, 0xc1, 0x8d,
+	0x17, 0x4b, 0x56, 0xee, 0x2a, 0x01, 0x4d, 0x09, 0x88, 0x96, 0xff, 0x22, 0x82, 0xc9, 0x55, 0xa8,
+	0x19, 0x69, 0xe0, 0x69, 0xfa, 0x8c, 0xe0, 0x07, 0xa1, 0x80, 0x18, 0x3a, 0x07, 0xdf, 0xae, 0x17
+};
+
+/** \brief clear memory holding DRBG state, without the compiler dropping the stores */
+static void drbg_zero(void* data, size_t data_size)
+{
+	volatile uint8_t* p = (volatile uint8_t*)data;
+
+	while (data_size--)
+		*p++ = 0;
+}
+
+/** \brief add a big endian value to V, modulo 2^seedlen */
+static void drbg_add(uint8_t v[ATCA_DRBG_SEED_SIZE], const uint8_t* value, size_t value_size)
+{
+	uint16_t carry = 0;
+	size_t i;
+
+	for (i = 0; i < ATCA_DRBG_SEED_SIZE; i++) {
+		carry += v[ATCA_DRBG_SEED_SIZE - 1 - i];
+		if (i < value_size)
+			carry += value[value_size - 1 - i];
+		v[ATCA_DRBG_SEED_SIZE - 1 - i] = (uint8_t)carry;
+		carry >>= 8;
+	}
+}
+
+/** \brief Hash_df derivation function, returns seedlen bytes derived from the concatenation of
+ *         a prefix byte (unless negative) and up to three byte strings
+ */
+static void drbg_hash_df(uint8_t out[ATCA_DRBG_SEED_SIZE], int prefix,
+                         const uint8_t* in1, size_t in1_size,
+                         const uint8_t* in2, size_t in2_size,
+                         const uint8_t* in3, size_t in3_size)
+{
+	static const uint8_t bits[4] = { 0x00, 0x00, (ATCA_DRBG_SEED_SIZE * 8) >> 8, (uint8_t)(ATCA_DRBG_SEED_SIZE * 8) };
+	atcac_sha2_256_ctx ctx;
+	uint8_t digest[ATCA_SHA2_256_DIGEST_SIZE];
+	uint8_t counter, prefix_byte = (uint8_t)prefix;
+	size_t offset, copy;
+
+	for (counter = 1, offset = 0; offset < ATCA_DRBG_SEED_SIZE; counter++, offset += copy) {
+		atcac_sw_sha2_256_init(&ctx);
+		atcac_sw_sha2_256_update(&ctx, &counter, 1);
+		atcac_sw_sha2_256_update(&ctx, bits, sizeof(bits));
+		if (prefix >= 0)
+			atcac_sw_sha2_256_update(&ctx, &prefix_byte, 1);
+		if (in1_size)
+			atcac_sw_sha2_256_update(&ctx, in1, in1_size);
+		if (in2_size)
+			atcac_sw_sha2_256_update(&ctx, in2, in2_size);
+		if (in3_size)
+			atcac_sw_sha2_256_update(&ctx, in3, in3_size);
+		atcac_sw_sha2_256_finish(&ctx, digest);
+
+		copy = ATCA_DRBG_SEED_SIZE - offset;
+		if (copy > sizeof(digest))
+			copy = sizeof(digest);
+		memcpy(&out[offset], digest, copy);
+	}
+	drbg_zero(digest, sizeof(digest));
+	drbg_zero(&ctx, sizeof(ctx));
+}
+
+/** \brief derive C from a new V and restart the reseed counter */
+static void drbg_seeded(atcac_drbg_ctx* ctx)
+{
+	drbg_hash_df(ctx->c, 0x00, ctx->v, sizeof(ctx->v), NULL, 0, NULL, 0);
+	ctx->reseed_counter = 1;
+}
+
+/** \brief instantiates a Hash_DRBG with SHA-256 (NIST SP 800-90A)
+ * \param[out] ctx              DRBG state
+ * \param[in]  entropy          entropy input, at least ATCA_DRBG_ENTROPY_SIZE bytes
+ * \param[in]  entropy_size     size of entropy in bytes
+ * \param[in]  nonce            nonce, at least ATCA_DRBG_NONCE_SIZE bytes
+ * \param[in]  nonce_size       size of nonce in bytes
+ * \param[in]  pers             optional personalization string, NULL if none
+ * \param[in]  pers_size        size of pers in bytes
+ * \param[in]  reseed_interval  generate requests allowed before a reseed is required
+ * \return ATCA_STATUS
+ */
+
+int atcac_sw_drbg_instantiate(atcac_drbg_ctx* ctx, const uint8_t* entropy, size_t entropy_size,
+                              const uint8_t* nonce, size_t nonce_size,
+                              const uint8_t* pers, size_t pers_size, uint32_t reseed_interval)
+{
+	if (ctx == NULL || entropy == NULL || nonce == NULL || (pers == NULL && pers_size > 0))
+		return ATCA_BAD_PARAM;
+	if (entropy_size < ATCA_DRBG_ENTROPY_SIZE || nonce_size < ATCA_DRBG_NONCE_SIZE)
+		return ATCA_INVALID_SIZE;
+	if (reseed_interval == 0 || reseed_interval > ATCA_DRBG_MAX_INTERVAL)
+		return ATCA_BAD_PARAM;
+
+	drbg_hash_df(ctx->v, -1, entropy, entropy_size, nonce, nonce_size, pers, pers_size);
+	drbg_seeded(ctx);
+	ctx->reseed_interval = reseed_interval;
+
+	return ATCA_SUCCESS;
+}
+
+/** \brief reseeds an instantiated Hash_DRBG with fresh entropy
+ * \param[inout] ctx           DRBG state
+ * \param[in]    entropy       entropy input, at least ATCA_DRBG_ENTROPY_SIZE bytes
+ * \param[in]    entropy_size  size of entropy in bytes
+ * \param[in]    addl          optional additional input, NULL if none
+ * \param[in]    addl_size     size of addl in bytes
+ * \return ATCA_STATUS
+ */
+
+int atcac_sw_drbg_reseed(atcac_drbg_ctx* ctx, const uint8_t* entropy, size_t entropy_size,
+                         const uint8_t* addl, size_t addl_size)
+{
+	uint8_t v[ATCA_DRBG_SEED_SIZE];
+
+	if (ctx == NULL || entropy == NULL || (addl == NULL && addl_size > 0))
+		return ATCA_BAD_PARAM;
+	if (entropy_size < ATCA_DRBG_ENTROPY_SIZE)
+		return ATCA_INVALID_SIZE;
+	if (ctx->reseed_counter == 0)
+		return ATCA_FUNC_FAIL;
+
+	drbg_hash_df(v, 0x01, ctx->v, sizeof(ctx->v), entropy, entropy_size, addl, addl_size);
+	memcpy(ctx->v, v, sizeof(v));
+	drbg_zero(v, sizeof(v));
+	drbg_seeded(ctx);
+
+	return ATCA_SUCCESS;
+}
+
+/** \brief generates random bytes from an instantiated Hash_DRBG
+ * \param[inout] ctx        DRBG state
+ * \param[out]   data       receives the random bytes
+ * \param[in]    data_size  number of bytes requested, up to ATCA_DRBG_MAX_REQUEST_SIZE
+ * \param[in]    addl       optional additional input, NULL if none
+ * \param[in]    addl_size  size of addl in bytes
+ * \return ATCA_SUCCESS, or ATCA_FUNC_FAIL when the DRBG is not instantiated or has to be
+ *         reseeded first because the reseed interval has been reached
+ */
+
+int atcac_sw_drbg_generate(atcac_drbg_ctx* ctx, uint8_t* data, size_t data_size,
+                           const uint8_t* addl, size_t addl_size)
+{
+	atcac_sha2_256_ctx sha;
+	uint8_t block[ATCA_DRBG_SEED_SIZE];
+	uint8_t digest[ATCA_SHA2_256_DIGEST_SIZE];
+	uint8_t prefix, counter[4];
+	size_t copy;
+
+	if (ctx == NULL || (data == NULL && data_size > 0) || (addl == NULL && addl_size > 0))
+		return ATCA_BAD_PARAM;
+	if (data_size > ATCA_DRBG_MAX_REQUEST_SIZE)
+		return ATCA_INVALID_SIZE;
+	if (ctx->reseed_counter == 0 || ctx->reseed_counter > ctx->reseed_interval)
+		return ATCA_FUNC_FAIL;
+
+	if (addl_size > 0) {
+		// w = Hash(0x02 || V || additional_input), V = (V + w) mod 2^seedlen
+		prefix = 0x02;
+		atcac_sw_sha2_256_init(&sha);
+		atcac_sw_sha2_256_update(&sha, &prefix, 1);
+		atcac_sw_sha2_256_update(&sha, ctx->v, sizeof(ctx->v));
+		atcac_sw_sha2_256_update(&sha, addl, addl_size);
+		atcac_sw_sha2_256_finish(&sha, digest);
+		drbg_add(ctx->v, digest, sizeof(digest));
+	}
+
+	// Hashgen, hash successive values of V
+	memcpy(block, ctx->v, sizeof(block));
+	while (data_size > 0) {
+		atcac_sw_sha2_256(block, sizeof(block), digest);
+		copy = data_size < sizeof(digest) ? data_size : sizeof(digest);
+		memcpy(data, digest, copy);
+		data += copy;
+		data_size -= copy;
+		prefix = 1;
+		drbg_add(block, &prefix, 1);
+	}
+
+	// V = (V + Hash(0x03 || V) + C + reseed_counter) mod 2^seedlen
+	prefix = 0x03;
+	atcac_sw_sha2_256_init(&sha);
+	atcac_sw_sha2_256_update(&sha, &prefix, 1);
+	atcac_sw_sha2_256_update(&sha, ctx->v, sizeof(ctx->v));
+	atcac_sw_sha2_256_finish(&sha, digest);
+	drbg_add(ctx->v, digest, sizeof(digest));
+	drbg_add(ctx->v, ctx->c, sizeof(ctx->c));
+	counter[0] = (uint8_t)(ctx->reseed_counter >> 24);
+	counter[1] = (uint8_t)(ctx->reseed_counter >> 16);
+	counter[2] = (uint8_t)(ctx->reseed_counter >> 8);
+	counter[3] = (uint8_t)(ctx->reseed_counter);
+	drbg_add(ctx->v, counter, sizeof(counter));
+	ctx->reseed_counter++;
+
+	drbg_zero(block, sizeof(block));
+	drbg_zero(digest, sizeof(digest));
+	drbg_zero(&sha, sizeof(sha));
+
+	return ATCA_SUCCESS;
+}
+
+/** \brief clears the DRBG state, it has to be instantiated again before use
+ * \param[inout] ctx  DRBG state
+ */
+
+void atcac_sw_drbg_uninstantiate(atcac_drbg_ctx* ctx)
+{
+	if (ctx != NULL)
+		drbg_zero(ctx, sizeof(*ctx));
+}
+
+/** \brief known answer test of the Hash_DRBG, to run before instantiating it for use
+ * \return ATCA_SUCCESS when all of instantiate, reseed and generate return the expected values,
+ *         ATCA_ASSERT_FAILURE otherwise
+ */
+
+int atcac_sw_drbg_self_test(void)
+{
+	int ret;
+	atcac_drbg_ctx ctx;
+	uint8_t output[sizeof(drbg_kat_output)];
+
+	ret = atcac_sw_drbg_instantiate(&ctx, drbg_kat_entropy, sizeof(drbg_kat_entropy),
+	                                drbg_kat_nonce, sizeof(drbg_kat_nonce), NULL, 0, 2);
+	if (ret == ATCA_SUCCESS)
+		ret = atcac_sw_drbg_reseed(&ctx, drbg_kat_reseed_entropy, sizeof(drbg_kat_reseed_entropy), NULL, 0);
+	if (ret == ATCA_SUCCESS)
+		ret = atcac_sw_drbg_generate(&ctx, output, sizeof(output), NULL, 0);
+	if (ret == ATCA_SUCCESS)
+		ret = atcac_sw_drbg_generate(&ctx, output, sizeof(output), NULL, 0);
+	// The interval of 2 requests is reached, a third one must be refused
+	if (ret == ATCA_SUCCESS && atcac_sw_drbg_generate(&ctx, output, 1, NULL, 0) != ATCA_FUNC_FAIL)
+		ret = ATCA_ASSERT_FAILURE;
+	if (ret == ATCA_SUCCESS && memcmp(output, drbg_kat_output, sizeof(output)) != 0)
+		ret = ATCA_ASSERT_FAILURE;
+
+	atcac_sw_drbg_uninstantiate(&ctx);
+	drbg_zero(output, sizeof(output));
+
+	return ret == ATCA_SUCCESS ? ATCA_SUCCESS : ATCA_ASSERT_FAILURE;
 }
\ No newline at end of file
@@ -53,12 +53,37 @@
  * algorithms
  *
    @{ */
+
+#define ATCA_DRBG_SEED_SIZE         (55)         //!< seedlen of Hash_DRBG with SHA-256, 440 bits
+#define ATCA_DRBG_ENTROPY_SIZE      (32)         //!< entropy input for the 256 bits security strength
+#define ATCA_DRBG_NONCE_SIZE        (16)         //!< nonce at instantiation, half the security strength
+#define ATCA_DRBG_MAX_REQUEST_SIZE  (0x10000)    //!< max_number_of_bits_per_request, in bytes
+#define ATCA_DRBG_MAX_INTERVAL      (0x7FFFFFFF) //!< largest reseed interval accepted
+
+/** \brief Hash_DRBG state from NIST SP 800-90A, instantiated with SHA-256. */
+typedef struct {
+	uint8_t  v[ATCA_DRBG_SEED_SIZE];  //!< V, updated on every generate
+	uint8_t  c[ATCA_DRBG_SEED_SIZE];  //!< C, constant between reseeds
+	uint32_t reseed_counter;          //!< generate requests since the last (re)seed plus one, 0 when not instantiated
+	uint32_t reseed_interval;         //!< generate requests allowed between reseeds
+} atcac_drbg_ctx;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 int atcac_sw_random(uint8_t* data, size_t data_size);
 
+int atcac_sw_drbg_instantiate(atcac_drbg_ctx* ctx, const uint8_t* entropy, size_t entropy_size,
+                              const uint8_t* nonce, size_t nonce_size,
+                              const uint8_t* pers, size_t pers_size, uint32_t reseed_interval);
+int atcac_sw_drbg_reseed(atcac_drbg_ctx* ctx, const uint8_t* entropy, size_t entropy_size,
+                         const uint8_t* addl, size_t addl_size);
+int atcac_sw_drbg_generate(atcac_drbg_ctx* ctx, uint8_t* data, size_t data_size,
+                           const uint8_t* addl, size_t addl_size);
+void atcac_sw_drbg_uninstantiate(atcac_drbg_ctx* ctx);
+int atcac_sw_drbg_self_test(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -44,23 +44,74 @@
 
 #define rotate_right(value, places) ((value >> places) | (value << (32 - places)))
 
+#define SHA256_CH(x, y, z)  ((z) ^ ((x) & ((y) ^ (z))))
+#define SHA256_MAJ(x, y, z) (((x) & (y)) | ((z) & ((x) | (y))))
+#define SHA256_SIGMA0(x)    (rotate_right((x), 2) ^ rotate_right((x), 13) ^ rotate_right((x), 22))
+#define SHA256_SIGMA1(x)    (rotate_right((x), 6) ^ rotate_right((x), 11) ^ rotate_right((x), 25))
+#define SHA256_GAMMA0(x)    (rotate_right((x), 7) ^ rotate_right((x), 18) ^ ((x) >> 3))
+#define SHA256_GAMMA1(x)    (rotate_right((x), 17) ^ rotate_right((x), 19) ^ ((x) >> 10))
+
+// Message schedule kept as a rolling window of the last 16 words
+#define SHA256_SCHEDULE(w, i) \
+	(w[(i) & 15] += SHA256_GAMMA1(w[((i) - 2) & 15]) + w[((i) - 7) & 15] + SHA256_GAMMA0(w[((i) - 15) & 15]))
+
+// One round, the caller rotates the working variables by renaming them instead of moving them
+#define SHA256_ROUND(a, b, c, d, e, f, g, h, i, wi) \
+	do { \
+		uint32_t t1 = (h) + SHA256_SIGMA1(e) + SHA256_CH((e), (f), (g)) + k[i] + (wi); \
+		(d) += t1; \
+		(h) = t1 + SHA256_SIGMA0(a) + SHA256_MAJ((a), (b), (c)); \
+	} while (0)
+
+// Eight rounds, after which the working variables are back in their original roles
+#define SHA256_ROUNDS8(i, W) \
+	do { \
+		SHA256_ROUND(a, b, c, d, e, f, g, h, (i) + 0, W((i) + 0)); \
+		SHA256_ROUND(h, a, b, c, d, e, f, g, (i) + 1, W((i) + 1)); \
+		SHA256_ROUND(g, h, a, b, c, d, e, f, (i) + 2, W((i) + 2)); \
+		SHA256_ROUND(f, g, h, a, b, c, d, e, (i) + 3, W((i) + 3)); \
+		SHA256_ROUND(e, f, g, h, a, b, c, d, (i) + 4, W((i) + 4)); \
+		SHA256_ROUND(d, e, f, g, h, a, b, c, (i) + 5, W((i) + 5)); \
+		SHA256_ROUND(c, d, e, f, g, h, a, b, (i) + 6, W((i) + 6)); \
+		SHA256_ROUND(b, c, d, e, f, g, h, a, (i) + 7, W((i) + 7)); \
+	} while (0)
+
+#define SHA256_W_LOAD(i)     (w[i] = sw_sha256_load_be32(&cur_msg_block[(i) * 4]))
+#define SHA256_W_EXPAND(i)   SHA256_SCHEDULE(w, i)
+
 /**
- * \brief Processes whole blocks (64 bytes) of data.
+ * \brief Loads a big-endian word from a message block.
  *
- * \param[in] ctx          SAH256 hash context
- * \param[in] blocks       Raw blocks to be processed
- * \param[in] block_count  Number of 64-byte blocks to process
+ * On little-endian GCC targets this is a single word load and byte reverse (LDR + REV on the
+ * Cortex-M4, which also handles unaligned loads). Other targets assemble the word bytewise.
+ *
+ * \param[in] p  First byte of the word
+ * \return Word value
  */
-static void sw_sha256_process(sw_sha256_ctx* ctx, const uint8_t* blocks, uint32_t block_count)
+static inline uint32_t sw_sha256_load_be32(const uint8_t* p)
 {
-	int i = 0;
-	uint32_t block = 0;
-
-	union {
-		uint32_t w_word[SHA256_BLOCK_SIZE];
-		uint8_t w_byte[SHA256_BLOCK_SIZE * sizeof(uint32_t)];
-	} w_union;
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	uint32_t word;
+	memcpy(&word, p, sizeof(word));
+	return __builtin_bswap32(word);
+#else
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+#endif
+}
 
+/**
+ * \brief Processes whole blocks (64 bytes) of data.
+ *
+ * This is the SHA-256 compression function shared by the cryptoauthlib software hash and
+ * wolfCrypt. The rounds are unrolled eight at a time so the working variables stay in
+ * registers, and the message schedule only keeps 16 words on the stack.
+ *
+ * \param[inout] hash         Hash state, 8 words in native byte order
+ * \param[in]    blocks       Raw blocks to be processed, any alignment
+ * \param[in]    block_count  Number of 64-byte blocks to process
+ */
+void sw_sha256_transform(uint32_t hash[8], const uint8_t* blocks, uint32_t block_count)
+{
 	static const uint32_t k[] = {
 		0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
 		0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
@@ -71,72 +122,29 @@ static void sw_sha256_process(sw_sha256_ctx* ctx, const uint8_t* blocks, uint32_
 		0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
 		0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
 	};
+	uint32_t w[16];
+	uint32_t a, b, c, d, e, f, g, h;
+	int i;
 
 	// Loop through all the blocks to process
-	for (block = 0; block < block_count; block++) {
-		uint32_t w_index;
-		uint32_t word_value;
-		uint32_t s0, s1;
-		uint32_t t1, t2;
-		uint32_t maj, ch;
-		uint32_t rotate_register[8];
-		const uint8_t* cur_msg_block = &blocks[block * SHA256_BLOCK_SIZE];
-
-		// Swap word bytes
-		for (i = 0; i < SHA256_BLOCK_SIZE; i += 4) {
-			w_union.w_byte[i + 3] = cur_msg_block[i + 0];
-			w_union.w_byte[i + 2] = cur_msg_block[i + 1];
-			w_union.w_byte[i + 1] = cur_msg_block[i + 2];
-			w_union.w_byte[i + 0] = cur_msg_block[i + 3];
-		}
-
-		w_index = 16;
-		while (w_index < SHA256_BLOCK_SIZE) {
-			// right rotate for 32-bit variable in C: (value >> places) | (value << 32 - places)
-			word_value = w_union.w_word[w_index - 15];
-			s0 = rotate_right(word_value, 7) ^ rotate_right(word_value, 18) ^ (word_value >> 3);
-
-			word_value = w_union.w_word[w_index - 2];
-			s1 = rotate_right(word_value, 17) ^ rotate_right(word_value, 19) ^ (word_value >> 10);
-
-			w_union.w_word[w_index] = w_union.w_word[w_index - 16] + s0 + w_union.w_word[w_index - 7] + s1;
-
-			w_index++;
-		}
+	for (; block_count > 0; block_count--, blocks += SHA256_BLOCK_SIZE) {
+		const uint8_t* cur_msg_block = blocks;
 
 		// Initialize hash value for this chunk.
-		for (i = 0; i < 8; i++)
-			rotate_register[i] = ctx->hash[i];
-
-		// hash calculation loop
-		for (i = 0; i < SHA256_BLOCK_SIZE; i++) {
-			s0 = rotate_right(rotate_register[0], 2)
-			     ^ rotate_right(rotate_register[0], 13)
-			     ^ rotate_right(rotate_register[0], 22);
-			maj = (rotate_register[0] & rotate_register[1])
-			      ^ (rotate_register[0] & rotate_register[2])
-			      ^ (rotate_register[1] & rotate_register[2]);
-			t2 = s0 + maj;
-			s1 = rotate_right(rotate_register[4], 6)
-			     ^ rotate_right(rotate_register[4], 11)
-			     ^ rotate_right(rotate_register[4], 25);
-			ch = (rotate_register[4] & rotate_register[5])
-			     ^ (~rotate_register[4] & rotate_register[6]);
-			t1 = rotate_register[7] + s1 + ch + k[i] + w_union.w_word[i];
-
-			rotate_register[7] = rotate_register[6];
-			rotate_register[6] = rotate_register[5];
-			rotate_register[5] = rotate_register[4];
-			rotate_register[4] = rotate_register[3] + t1;
-			rotate_register[3] = rotate_register[2];
-			rotate_register[2] = rotate_register[1];
-			rotate_register[1] = rotate_register[0];
-			rotate_register[0] = t1 + t2;
-		}
+		a = hash[0]; b = hash[1]; c = hash[2]; d = hash[3];
+		e = hash[4]; f = hash[5]; g = hash[6]; h = hash[7];
+
+		// The first 16 rounds use the message words directly
+		SHA256_ROUNDS8(0, SHA256_W_LOAD);
+		SHA256_ROUNDS8(8, SHA256_W_LOAD);
+
+		// The remaining rounds extend the schedule in place
+		for (i = 16; i < 64; i += 8)
+			SHA256_ROUNDS8(i, SHA256_W_EXPAND);
 
 		// Add the hash of this block to current result.
-		for (i = 0; i < 8; i++)
-			ctx->hash[i] += rotate_register[i];
+		hash[0] += a; hash[1] += b; hash[2] += c; hash[3] += d;
+		hash[4] += e; hash[5] += f; hash[6] += g; hash[7] += h;
 	}
 }
 
@@ -169,12 +177,12 @@ void sw_sha256_update(sw_sha256_ctx* ctx, const uint8_t* msg, uint32_t msg_size)
 	}
 
 	// Process the current block
-	sw_sha256_process(ctx, ctx->block, 1);
+	sw_sha256_transform(ctx->hash, ctx->block, 1);
 
 	// Process any additional blocks
 	msg_size -= copy_size; // Adjust to the remaining message bytes
 	block_count = msg_size / SHA256_BLOCK_SIZE;
-	sw_sha256_process(ctx, &msg[copy_size], block_count);
+	sw_sha256_transform(ctx->hash, &msg[copy_size], block_count);
 
 	// Save any remaining data
 	ctx->total_msg_size += (block_count + 1) * SHA256_BLOCK_SIZE;
@@ -209,7 +217,7 @@ void sw_sha256_final(sw_sha256_ctx* ctx, uint8_t digest[SHA256_DIGEST_SIZE])
 	ctx->block[ctx->block_size++] = (uint8_t)(msg_size_bits >> 8);
 	ctx->block[ctx->block_size++] = (uint8_t)(msg_size_bits >> 0);
 
-	sw_sha256_process(ctx, ctx->block, ctx->block_size / SHA256_BLOCK_SIZE);
+	sw_sha256_transform(ctx->hash, ctx->block, ctx->block_size / SHA256_BLOCK_SIZE);
 
 	// All blocks have been processed.
 	// Concatenate the hashes to produce digest, MSB of every hash first.
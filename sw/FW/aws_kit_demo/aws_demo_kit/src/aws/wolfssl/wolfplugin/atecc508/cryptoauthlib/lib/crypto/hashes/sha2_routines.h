@@ -58,6 +58,8 @@ typedef struct {
 	uint32_t hash[8];                       //!< Hash state
 } sw_sha256_ctx;
 
+void sw_sha256_transform(uint32_t hash[8], const uint8_t* blocks, uint32_t block_count);
+
 void sw_sha256_init(sw_sha256_ctx* ctx);
 
 void sw_sha256_update(sw_sha256_ctx* ctx, const uint8_t* message, uint32_t len);
@@ -96,6 +96,14 @@ extern ATCA_STATUS hal_iface_release(ATCAIfaceType, void* hal_data);
 //#define ATCA_HAL_KIT_HID
 //#define ATCA_HAL_KIT_CDC
 
+// Define ATCA_STATIC_DEVICE as well when the application talks to a single ATECC108A or ATECC508A over I2C.
+// The device, command and interface objects are then static instead of allocated, the interface calls go
+// straight to the I2C HAL instead of through function pointers and the execution times are looked up in a
+// constant table. Only one ATCADevice can exist at a time in such a build.
+
+// Define ATCA_CRC_NIBBLE_TABLE to compute the packet CRC with a 32 byte nibble table instead of the 512 byte
+// byte table, for builds that are short of flash.
+
 // forward declare known physical layer APIs that must be implemented by the HAL layer (./hal/xyz) for this interface type
 
 #ifdef ATCA_HAL_I2C
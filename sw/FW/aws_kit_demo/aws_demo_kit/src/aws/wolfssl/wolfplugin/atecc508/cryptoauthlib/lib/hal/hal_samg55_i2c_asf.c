@@ -68,6 +68,9 @@
   * Logical to physical bus mapping structure
   */
   ATCAI2CMaster_t *i2c_hal_data[MAX_I2C_BUSES];   // map logical, 0-based bus number to index
+  #ifdef ATCA_STATIC_DEVICE
+  static ATCAI2CMaster_t i2c_hal_buses[MAX_I2C_BUSES];  // a static build allocates nothing
+  #endif
   int i2c_bus_ref_ct = 0;                         // total in-use count across buses
   twi_options_t opt_twi_master;
 
@@ -155,7 +158,11 @@
       //// if this is the first time this bus and interface has been created, do the physical work of enabling it
       if (i2c_hal_data[bus] == NULL) 
       {
+        #ifdef ATCA_STATIC_DEVICE
+        i2c_hal_data[bus] = &i2c_hal_buses[bus];
+        #else
         i2c_hal_data[bus] = malloc(sizeof(ATCAI2CMaster_t));
+        #endif
         i2c_hal_data[bus]->ref_ct = 1;  // buses are shared, this is the first instance
 
         switch (bus) 
@@ -480,7 +487,9 @@
     // if the use count for this bus has gone to 0 references, disable it.  protect against an unbracketed release
     if (hal && --(hal->ref_ct) <= 0 && i2c_hal_data[hal->bus_index] != NULL) {
       twi_reset(hal->twi_master_instance);
+      #ifndef ATCA_STATIC_DEVICE
       free(i2c_hal_data[hal->bus_index]);
+      #endif
       i2c_hal_data[hal->bus_index] = NULL;
     }
 
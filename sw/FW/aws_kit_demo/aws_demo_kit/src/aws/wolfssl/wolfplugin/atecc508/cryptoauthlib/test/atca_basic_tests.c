@@ -261,6 +261,7 @@ void atca_ecc108a_basic_tests(ATCADeviceType deviceType)
 	RUN_TEST(test_basic_challenge );
 	RUN_TEST(test_write_bytes_zone_config);
 	RUN_TEST(test_basic_write_ecc_config_zone);
+	RUN_TEST(test_basic_update_ecc_config_zone);
 	RUN_TEST(test_basic_read_ecc_config_zone);
 	RUN_TEST(test_basic_lock_config_zone);
 	RUN_TEST(test_write_boundary_conditions);
@@ -305,6 +306,8 @@ void atca_ecc508a_basic_tests(ATCADeviceType deviceType)
 	atca_ecc108a_basic_tests(deviceType);
 	// add 508a specific tests here...for example,
 	RUN_TEST(test_basic_ecdh);
+	RUN_TEST(test_basic_poll_latency);
+	RUN_TEST(test_basic_session);
 }
 
 extern ATCADevice _gDevice;
@@ -489,6 +492,42 @@ void test_basic_write_ecc_config_zone(void)
 	TEST_ASSERT_EQUAL( ATCA_SUCCESS, status );
 }
 
+void test_basic_update_ecc_config_zone(void)
+{
+	ATCA_STATUS status = ATCA_SUCCESS;
+	bool isLocked = false;
+	uint8_t config_data[ATCA_CONFIG_SIZE];
+	uint8_t words_written = 0xFF;
+
+	status = atcab_init( gCfg );
+	TEST_ASSERT_EQUAL( ATCA_SUCCESS, status );
+
+	status = atcab_is_locked( LOCK_ZONE_CONFIG, &isLocked );
+
+	if ((isLocked == false) && (status == ATCA_SUCCESS)) {
+		status = atcab_read_config_zone( config_data );
+		TEST_ASSERT_EQUAL( ATCA_SUCCESS, status );
+
+		status = atcab_update_ecc_config_zone( test_ecc_configdata, config_data, NULL );
+		TEST_ASSERT_EQUAL( ATCA_SUCCESS, status );
+
+		// the device holds the image now, nothing is written again
+		status = atcab_read_config_zone( config_data );
+		TEST_ASSERT_EQUAL( ATCA_SUCCESS, status );
+		status = atcab_update_ecc_config_zone( test_ecc_configdata, config_data, &words_written );
+		TEST_ASSERT_EQUAL( ATCA_SUCCESS, status );
+		TEST_ASSERT_EQUAL( 0, words_written );
+		TEST_ASSERT_EQUAL_MEMORY( &test_ecc_configdata[16], &config_data[16], 84 - 16 );
+		TEST_ASSERT_EQUAL_MEMORY( &test_ecc_configdata[88], &config_data[88], ATCA_CONFIG_SIZE - 88 );
+	}else {
+		status = atcab_release();
+		TEST_IGNORE_MESSAGE("Configuration zone must be unlocked for this test to succeed." );
+	}
+
+	status = atcab_release();
+	TEST_ASSERT_EQUAL( ATCA_SUCCESS, status );
+}
+
 void test_basic_read_ecc_config_zone(void)
 {
 	ATCA_STATUS status = ATCA_SUCCESS;
@@ -2519,4 +2558,140 @@ void test_basic_hw_sha2_256_nist_monte(void)
 	status = atcab_release();
 	TEST_ASSERT_EQUAL(ATCA_SUCCESS, status);
 #endif
-}
\ No newline at end of file
+}
+
+#define POLL_BENCH_RUNS     50
+#define POLL_BENCH_CMDS     5
+
+static int poll_bench_cmp(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+
+	return (x > y) - (x < y);
+}
+
+static void poll_bench_report(const char *name, bool polling, uint32_t *waits, int count)
+{
+	qsort(waits, count, sizeof(uint32_t), poll_bench_cmp);
+	printf("%-8s %-7s p50 %6lu us  p99 %6lu us\r\n", name, polling ? "polled" : "fixed",
+	       (unsigned long)waits[count / 2], (unsigned long)waits[(count * 99) / 100]);
+}
+
+/** \brief compares the time spent waiting for commands to execute, with the worst case
+ *         execution times and with completion polling. Both runs report p50 and p99.
+ */
+void test_basic_poll_latency(void)
+{
+	ATCA_STATUS status;
+	static uint32_t waits[POLL_BENCH_CMDS][POLL_BENCH_RUNS];
+	const char *names[POLL_BENCH_CMDS] = { "sign", "ecdh", "nonce", "read", "genkey" };
+	uint8_t msg[ATCA_SHA_DIGEST_SIZE], num_in[20], rand_out[ATCA_KEY_SIZE];
+	uint8_t public_key[ATCA_PUB_KEY_SIZE], signature[ATCA_SIG_SIZE], pms[ECDH_KEY_SIZE];
+	uint8_t data[ATCA_BLOCK_SIZE];
+	uint16_t sign_key_id = 0, ecdh_key_id = 2;
+	bool is_locked;
+	int mode, i, cmd;
+
+	status = atcab_init( gCfg );
+	TEST_ASSERT_EQUAL( ATCA_SUCCESS, status );
+
+	status = atcab_is_locked( LOCK_ZONE_DATA, &is_locked );
+	TEST_ASSERT_EQUAL( ATCA_SUCCESS, status );
+	if ( !is_locked )
+		TEST_IGNORE_MESSAGE("Data zone must be locked for this test to succeed.");
+
+	memset(num_in, 0x5A, sizeof(num_in));
+
+	status = atcab_genkey( sign_key_id, public_key );
+	TEST_ASSERT_EQUAL( ATCA_SUCCESS, status );
+
+	for (mode = 0; mode < 2; mode++) {
+		atcab_set_polling( mode == 1 );
+
+		for (i = 0; i < POLL_BENCH_RUNS; i++) {
+			status = atcab_random( msg );
+			TEST_ASSERT_EQUAL( ATCA_SUCCESS, status );
+
+			status = atcab_sign( sign_key_id, msg, signature );
+			TEST_ASSERT_EQUAL( ATCA_SUCCESS, status );
+			waits[0][i] = atcab_get_last_wait();
+
+			status = atcab_ecdh( ecdh_key_id, public_key, pms );
+			TEST_ASSERT_EQUAL( ATCA_SUCCESS, status );
+			waits[1][i] = atcab_get_last_wait();
+
+			status = atcab_nonce_rand( num_in, rand_out );
+			TEST_ASSERT_EQUAL( ATCA_SUCCESS, status );
+			waits[2][i] = atcab_get_last_wait();
+
+			status = atcab_read_zone( ATCA_ZONE_CONFIG, 0, 0, 0, data, sizeof(data) );
+			TEST_ASSERT_EQUAL( ATCA_SUCCESS, status );
+			waits[3][i] = atcab_get_last_wait();
+
+			status = atcab_genkey( ecdh_key_id, public_key );
+			TEST_ASSERT_EQUAL( ATCA_SUCCESS, status );
+			waits[4][i] = atcab_get_last_wait();
+		}
+
+		for (cmd = 0; cmd < POLL_BENCH_CMDS; cmd++)
+			poll_bench_report( names[cmd], mode == 1, waits[cmd], POLL_BENCH_RUNS );
+	}
+
+	atcab_set_polling( ATCA_POLLING_ENABLE );
+
+	status = atcab_release();
+	TEST_ASSERT_EQUAL( ATCA_SUCCESS, status );
+}
+
+/** \brief runs a sign and more commands than fit into one watchdog period in a single session
+ */
+void test_basic_session(void)
+{
+	ATCA_STATUS status;
+	uint8_t msg[ATCA_SHA_DIGEST_SIZE], signature[ATCA_SIG_SIZE], public_key[ATCA_PUB_KEY_SIZE];
+	uint8_t data[ATCA_BLOCK_SIZE];
+	bool is_locked, is_verified = false;
+	int i;
+
+	status = atcab_init( gCfg );
+	TEST_ASSERT_EQUAL( ATCA_SUCCESS, status );
+
+	status = atcab_is_locked( LOCK_ZONE_DATA, &is_locked );
+	TEST_ASSERT_EQUAL( ATCA_SUCCESS, status );
+	if ( !is_locked )
+		TEST_IGNORE_MESSAGE("Data zone must be locked for this test to succeed.");
+
+	status = atcab_session_begin();
+	TEST_ASSERT_EQUAL( ATCA_SUCCESS, status );
+
+	status = atcab_genkey( 0, public_key );
+	TEST_ASSERT_EQUAL( ATCA_SUCCESS, status );
+
+	status = atcab_random( msg );
+	TEST_ASSERT_EQUAL( ATCA_SUCCESS, status );
+
+	status = atcab_sign( 0, msg, signature );
+	TEST_ASSERT_EQUAL( ATCA_SUCCESS, status );
+
+	status = atcab_verify_extern( msg, signature, public_key, &is_verified );
+	TEST_ASSERT_EQUAL( ATCA_SUCCESS, status );
+	TEST_ASSERT( is_verified );
+
+	// well past the watchdog timeout, the session has to wake the device again on its own
+	for (i = 0; i < 40; i++) {
+		status = atcab_genkey( 2, public_key );
+		TEST_ASSERT_EQUAL( ATCA_SUCCESS, status );
+
+		status = atcab_read_zone( ATCA_ZONE_CONFIG, 0, 0, 0, data, sizeof(data) );
+		TEST_ASSERT_EQUAL( ATCA_SUCCESS, status );
+	}
+
+	status = atcab_session_end();
+	TEST_ASSERT_EQUAL( ATCA_SUCCESS, status );
+
+	status = atcab_session_end();
+	TEST_ASSERT_EQUAL( ATCA_FUNC_FAIL, status );
+
+	status = atcab_release();
+	TEST_ASSERT_EQUAL( ATCA_SUCCESS, status );
+}
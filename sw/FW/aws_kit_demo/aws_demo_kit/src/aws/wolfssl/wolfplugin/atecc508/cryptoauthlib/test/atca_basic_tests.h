@@ -69,6 +69,7 @@ void test_write_bytes_zone_config(void);
 void test_write_bytes_zone_slot8(void);
 void test_basic_write_enc(void);
 void test_basic_write_ecc_config_zone(void);
+void test_basic_update_ecc_config_zone(void);
 void test_basic_read_config_zone(void);
 void test_basic_write_config_zone(void);
 void test_basic_read_ecc_config_zone(void);
@@ -93,6 +94,8 @@ void test_basic_verify_stored(void);
 void test_basic_verify_validate(void);
 void test_basic_verify_invalidate(void);
 void test_basic_ecdh(void);
+void test_basic_poll_latency(void);
+void test_basic_session(void);
 void test_basic_gendig(void);
 void test_basic_mac(void);
 void test_basic_checkmac(void);
@@ -42,10 +42,19 @@
 #include "atca_crypto_sw_tests.h"
 #include "crypto/atca_crypto_sw_sha1.h"
 #include "crypto/atca_crypto_sw_sha2.h"
-#ifdef WIN32
+#include "crypto/atca_crypto_sw_rand.h"
+#include "atca_command.h"
 #include <stdio.h>
-#include <stdlib.h>
 #include <string.h>
+#ifdef WIN32
+#include <stdlib.h>
+#endif
+
+// Millisecond time source for the throughput tests. Targets without a usable clock() define
+// ATCA_TEST_TIME_MS to a free running timer, e.g. the RTT on the SAMG55.
+#ifndef ATCA_TEST_TIME_MS
+#include <time.h>
+#define ATCA_TEST_TIME_MS() ((uint32_t)((uint64_t)clock() * 1000 / CLOCKS_PER_SEC))
 #endif
 
 static const uint8_t nist_hash_msg1[] = "abc";
@@ -70,6 +79,16 @@ void atca_crypto_sw_tests(void)
 	RUN_TEST(test_atcac_sw_sha2_256_nist_short);
 	RUN_TEST(test_atcac_sw_sha2_256_nist_long);
 	RUN_TEST(test_atcac_sw_sha2_256_nist_monte);
+	RUN_TEST(test_atcac_sw_sha2_256_split);
+	RUN_TEST(test_atcac_sw_sha2_256_throughput);
+
+	RUN_TEST(test_atcrc_vectors);
+	RUN_TEST(test_atcrc_throughput);
+
+	RUN_TEST(test_atcac_sw_drbg_self_test);
+	RUN_TEST(test_atcac_sw_drbg_vectors);
+	RUN_TEST(test_atcac_sw_drbg_reseed_interval);
+	RUN_TEST(test_atcac_sw_drbg_bad_params);
     
     UnityEnd();
 }
@@ -448,4 +467,277 @@ void test_atcac_sw_sha2_256_nist_monte(void)
 		memcpy(seed, &md[2], sizeof(seed));
 	}
 #endif
-}
\ No newline at end of file
+}
+
+void test_atcac_sw_sha2_256_split(void)
+{
+	const uint8_t digest_ref[] = {
+		0x1E, 0x9B, 0xC3, 0x8C, 0xBF, 0x86, 0x0B, 0x9E, 0xC3, 0x19, 0x18, 0xB0, 0x65, 0xF9, 0xB5, 0x24,
+		0x76, 0xC5, 0x49, 0xA7, 0x82, 0xE0, 0xE7, 0x99, 0x0B, 0xED, 0x8C, 0xE3, 0x86, 0x8D, 0x23, 0x71
+	};
+	static uint8_t msg[1000 + 3];
+	uint8_t digest[ATCA_SHA2_256_DIGEST_SIZE];
+	atcac_sha2_256_ctx ctx;
+	size_t offset, len, i;
+	int ret;
+
+	// Hash the message from every alignment, in one piece and in uneven pieces crossing blocks
+	for (offset = 0; offset < 4; offset++) {
+		for (i = 0; i < 1000; i++)
+			msg[offset + i] = (uint8_t)(i * 7 + 3);
+
+		ret = atcac_sw_sha2_256(&msg[offset], 1000, digest);
+		TEST_ASSERT_EQUAL(ATCA_SUCCESS, ret);
+		TEST_ASSERT_EQUAL_MEMORY(digest_ref, digest, sizeof(digest_ref));
+
+		ret = atcac_sw_sha2_256_init(&ctx);
+		TEST_ASSERT_EQUAL(ATCA_SUCCESS, ret);
+		for (i = 0, len = 1; i < 1000; i += len, len = len * 3 + 1) {
+			if (len > 1000 - i)
+				len = 1000 - i;
+			ret = atcac_sw_sha2_256_update(&ctx, &msg[offset + i], len);
+			TEST_ASSERT_EQUAL(ATCA_SUCCESS, ret);
+		}
+		ret = atcac_sw_sha2_256_finish(&ctx, digest);
+		TEST_ASSERT_EQUAL(ATCA_SUCCESS, ret);
+		TEST_ASSERT_EQUAL_MEMORY(digest_ref, digest, sizeof(digest_ref));
+	}
+}
+
+#define SHA2_BENCH_SIZE     4096
+#define SHA2_BENCH_MIN_MS   500
+
+/** \brief reports the throughput of the software SHA-256 on a long message and on the 100
+ *         byte messages typical for the host side nonce and MAC calculations.
+ */
+void test_atcac_sw_sha2_256_throughput(void)
+{
+	static uint8_t msg[SHA2_BENCH_SIZE];
+	uint8_t digest[ATCA_SHA2_256_DIGEST_SIZE];
+	const size_t sizes[] = { SHA2_BENCH_SIZE, 100 };
+	uint32_t start, elapsed, bytes;
+	size_t i;
+	int ret;
+
+	memset(msg, 0xA5, sizeof(msg));
+
+	for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+		bytes = 0;
+		start = ATCA_TEST_TIME_MS();
+		do {
+			ret = atcac_sw_sha2_256(msg, sizes[i], digest);
+			TEST_ASSERT_EQUAL(ATCA_SUCCESS, ret);
+			bytes += sizes[i];
+			elapsed = ATCA_TEST_TIME_MS() - start;
+		} while (elapsed < SHA2_BENCH_MIN_MS);
+
+		printf("sha256 %4lu byte messages: %6lu KB/s\r\n", (unsigned long)sizes[i],
+		       (unsigned long)((uint64_t)bytes * 1000 / 1024 / elapsed));
+	}
+}
+
+// Device CRC the way the datasheet describes it, one bit at a time
+static void atcrc_bitwise(size_t length, const uint8_t *data, uint8_t *crc_le)
+{
+	size_t counter;
+	uint16_t crc_register = 0;
+	uint8_t shift_register;
+	uint8_t data_bit, crc_bit;
+
+	for (counter = 0; counter < length; counter++) {
+		for (shift_register = 0x01; shift_register > 0x00; shift_register <<= 1) {
+			data_bit = (data[counter] & shift_register) ? 1 : 0;
+			crc_bit = crc_register >> 15;
+			crc_register <<= 1;
+			if (data_bit != crc_bit)
+				crc_register ^= 0x8005;
+		}
+	}
+	crc_le[0] = (uint8_t)(crc_register & 0x00FF);
+	crc_le[1] = (uint8_t)(crc_register >> 8);
+}
+
+void test_atcrc_vectors(void)
+{
+	static const uint8_t wake_response[] = { 0x04, 0x11 };
+	static const uint8_t info_command[] = { 0x07, 0x30, 0x00, 0x00, 0x00 };
+	static const uint8_t check[] = "123456789";
+	static uint8_t data[300];
+	uint8_t crc[ATCA_CRC_SIZE];
+	uint8_t crc_ref[ATCA_CRC_SIZE];
+	size_t i;
+
+	atCRC(0, check, crc);
+	TEST_ASSERT_EQUAL_HEX8(0x00, crc[0]);
+	TEST_ASSERT_EQUAL_HEX8(0x00, crc[1]);
+
+	atCRC(sizeof(wake_response), wake_response, crc);
+	TEST_ASSERT_EQUAL_HEX8(0x33, crc[0]);
+	TEST_ASSERT_EQUAL_HEX8(0x43, crc[1]);
+
+	atCRC(sizeof(info_command), info_command, crc);
+	TEST_ASSERT_EQUAL_HEX8(0x03, crc[0]);
+	TEST_ASSERT_EQUAL_HEX8(0x5D, crc[1]);
+
+	atCRC(sizeof(check) - 1, check, crc);
+	TEST_ASSERT_EQUAL_HEX8(0xDD, crc[0]);
+	TEST_ASSERT_EQUAL_HEX8(0xBC, crc[1]);
+
+	// Every length up to a full Write with MAC and every byte value against the bitwise CRC
+	for (i = 0; i < sizeof(data); i++)
+		data[i] = (uint8_t)(i * 167 + 13);
+	for (i = 0; i <= sizeof(data); i++) {
+		atCRC(i, data, crc);
+		atcrc_bitwise(i, data, crc_ref);
+		TEST_ASSERT_EQUAL_MEMORY(crc_ref, crc, sizeof(crc));
+	}
+}
+
+#define CRC_BENCH_MIN_MS    500
+
+void test_atcrc_throughput(void)
+{
+	static uint8_t packet[ATCA_CMD_SIZE_MAX];
+	uint8_t crc[ATCA_CRC_SIZE];
+	uint32_t start, elapsed, bytes;
+	int i;
+
+	memset(packet, 0xA5, sizeof(packet));
+
+	for (i = 0; i < 2; i++) {
+		bytes = 0;
+		start = ATCA_TEST_TIME_MS();
+		do {
+			if (i == 0)
+				atcrc_bitwise(sizeof(packet), packet, crc);
+			else
+				atCRC(sizeof(packet), packet, crc);
+			bytes += sizeof(packet);
+			elapsed = ATCA_TEST_TIME_MS() - start;
+		} while (elapsed < CRC_BENCH_MIN_MS);
+
+		printf("crc16 %-8s %3lu byte packets: %6lu KB/s\r\n", i == 0 ? "bitwise" : "atCRC", (unsigned long)sizeof(packet),
+		       (unsigned long)((uint64_t)bytes * 1000 / 1024 / elapsed));
+	}
+}
+
+void test_atcac_sw_drbg_self_test(void)
+{
+	TEST_ASSERT_EQUAL(ATCA_SUCCESS, atcac_sw_drbg_self_test());
+}
+
+static void drbg_test_instantiate(atcac_drbg_ctx* ctx, uint32_t reseed_interval)
+{
+	static const uint8_t pers[] = "aws kit personalization";
+	uint8_t entropy[ATCA_DRBG_ENTROPY_SIZE];
+	uint8_t nonce[ATCA_DRBG_NONCE_SIZE];
+	size_t i;
+
+	for (i = 0; i < sizeof(entropy); i++)
+		entropy[i] = (uint8_t)i;
+	for (i = 0; i < sizeof(nonce); i++)
+		nonce[i] = (uint8_t)(100 + i);
+	TEST_ASSERT_EQUAL(ATCA_SUCCESS, atcac_sw_drbg_instantiate(ctx, entropy, sizeof(entropy), nonce, sizeof(nonce),
+	                                                          pers, sizeof(pers) - 1, reseed_interval));
+}
+
+/** \brief personalization string, additional input on reseed and generate, and request sizes that
+ *         are not a multiple of the hash size, against a reference model of SP 800-90A Hash_DRBG.
+ */
+void test_atcac_sw_drbg_vectors(void)
+{
+	static const uint8_t expected1[] = {
+		0xc0, 0x9f, 0xe6, 0xd7, 0xde, 0xdb, 0x77, 0xe7, 0xb0, 0x31, 0xdb, 0x71, 0x82, 0x2a, 0x53, 0x4f,
+		0x1f, 0xb6, 0x3a, 0x40, 0xa7, 0x2c, 0x30, 0x15, 0xad, 0xc6, 0x57, 0x9a, 0x8e, 0xa9, 0xbf, 0x93,
+		0x46, 0xdb, 0x38, 0x99, 0x5b, 0x41, 0x12, 0xd7, 0x04, 0xe6, 0xd1, 0xab, 0xd9, 0x7c, 0xe8, 0xbc,
+		0xa0, 0xe4, 0xff, 0xd5, 0x58, 0xe9, 0xcd, 0x50, 0x98, 0x69, 0x68, 0x22, 0xa7, 0xa4, 0xc7, 0x58,
+		0x0a, 0x82, 0x1f, 0x78, 0x3d, 0xd3, 0x89, 0xfe, 0xd6, 0xc5, 0x00, 0xe4, 0x31,
+	};
+	static const uint8_t expected2[] = {
+		0xbb, 0x3c, 0xa2, 0x0f, 0x9b, 0x6e, 0xf0, 0x29, 0x12, 0xa9, 0xd9, 0x8e, 0xc9, 0xa1, 0x87, 0x36,
+		0x4e, 0x6a, 0xf9, 0x82, 0x2a, 0x63, 0xc7, 0xbd, 0xba, 0x8a, 0xbb, 0x95, 0x46, 0x37, 0xde, 0x26,
+		0x99, 0x60, 0x98, 0x25, 0x6d, 0x90, 0xa0, 0x5d, 0x6a, 0x2e, 0xc3, 0x85, 0x4e, 0x24, 0x91, 0x3c,
+		0x4a, 0xa5, 0xff, 0x12, 0x03, 0xd7, 0x3d, 0x78, 0x82, 0x1a, 0xbf, 0xa8, 0x0f, 0x8c, 0x47, 0x16,
+		0x8b, 0x4d, 0x01, 0x62, 0xa4, 0x0f, 0x1b, 0x9d, 0x26, 0x49, 0x62, 0xce, 0xd9, 0xbe, 0x3b, 0x43,
+		0xd9, 0xe0, 0x51, 0xde, 0x3f, 0x1e, 0x25, 0x3e, 0xcc, 0xa0, 0x16, 0x7d, 0xb9, 0x6b, 0x22, 0x83,
+		0x5f, 0x51, 0x94, 0xf3,
+	};
+	static const uint8_t expected3[] = {
+		0x6f, 0x38, 0xf2, 0x09, 0x38, 0xbb, 0x25, 0x76, 0x71, 0xcd, 0x52, 0x74, 0xee, 0x52, 0xcb, 0x13,
+		0x58, 0x60, 0x25, 0xbb, 0x09, 0x7a, 0xfe, 0x2e, 0xa0, 0x64, 0x06, 0x9c, 0xf7, 0xca, 0x6b, 0xa1,
+		0x6a,
+	};
+	static const uint8_t addl[] = "addl one";
+	uint8_t reseed_entropy[ATCA_DRBG_ENTROPY_SIZE];
+	uint8_t reseed_addl[40];
+	uint8_t output[100];
+	atcac_drbg_ctx ctx;
+	size_t i;
+
+	for (i = 0; i < sizeof(reseed_entropy); i++)
+		reseed_entropy[i] = (uint8_t)(200 + i);
+	memset(reseed_addl, 0, sizeof(reseed_addl));
+
+	drbg_test_instantiate(&ctx, 10);
+	TEST_ASSERT_EQUAL(ATCA_SUCCESS, atcac_sw_drbg_generate(&ctx, output, sizeof(expected1), addl, sizeof(addl) - 1));
+	TEST_ASSERT_EQUAL_MEMORY(expected1, output, sizeof(expected1));
+
+	TEST_ASSERT_EQUAL(ATCA_SUCCESS, atcac_sw_drbg_reseed(&ctx, reseed_entropy, sizeof(reseed_entropy), reseed_addl, sizeof(reseed_addl)));
+	TEST_ASSERT_EQUAL(ATCA_SUCCESS, atcac_sw_drbg_generate(&ctx, output, sizeof(expected2), NULL, 0));
+	TEST_ASSERT_EQUAL_MEMORY(expected2, output, sizeof(expected2));
+
+	TEST_ASSERT_EQUAL(ATCA_SUCCESS, atcac_sw_drbg_generate(&ctx, output, sizeof(expected3), addl, sizeof(addl) - 1));
+	TEST_ASSERT_EQUAL_MEMORY(expected3, output, sizeof(expected3));
+}
+
+void test_atcac_sw_drbg_reseed_interval(void)
+{
+	uint8_t entropy[ATCA_DRBG_ENTROPY_SIZE];
+	uint8_t output[ATCA_SHA2_256_DIGEST_SIZE];
+	uint8_t previous[ATCA_SHA2_256_DIGEST_SIZE];
+	atcac_drbg_ctx ctx;
+	int i;
+
+	memset(entropy, 0x5A, sizeof(entropy));
+	memset(previous, 0, sizeof(previous));
+	drbg_test_instantiate(&ctx, 3);
+
+	for (i = 0; i < 3; i++) {
+		TEST_ASSERT_EQUAL(ATCA_SUCCESS, atcac_sw_drbg_generate(&ctx, output, sizeof(output), NULL, 0));
+		TEST_ASSERT(memcmp(previous, output, sizeof(output)) != 0);
+		memcpy(previous, output, sizeof(output));
+	}
+	TEST_ASSERT_EQUAL(ATCA_FUNC_FAIL, atcac_sw_drbg_generate(&ctx, output, sizeof(output), NULL, 0));
+
+	TEST_ASSERT_EQUAL(ATCA_SUCCESS, atcac_sw_drbg_reseed(&ctx, entropy, sizeof(entropy), NULL, 0));
+	TEST_ASSERT_EQUAL(ATCA_SUCCESS, atcac_sw_drbg_generate(&ctx, output, sizeof(output), NULL, 0));
+	TEST_ASSERT(memcmp(previous, output, sizeof(output)) != 0);
+
+	atcac_sw_drbg_uninstantiate(&ctx);
+	TEST_ASSERT_EQUAL(ATCA_FUNC_FAIL, atcac_sw_drbg_generate(&ctx, output, sizeof(output), NULL, 0));
+	TEST_ASSERT_EQUAL(ATCA_FUNC_FAIL, atcac_sw_drbg_reseed(&ctx, entropy, sizeof(entropy), NULL, 0));
+}
+
+void test_atcac_sw_drbg_bad_params(void)
+{
+	uint8_t entropy[ATCA_DRBG_ENTROPY_SIZE];
+	uint8_t nonce[ATCA_DRBG_NONCE_SIZE];
+	uint8_t output[ATCA_SHA2_256_DIGEST_SIZE];
+	atcac_drbg_ctx ctx;
+
+	memset(entropy, 0x5A, sizeof(entropy));
+	memset(nonce, 0xA5, sizeof(nonce));
+
+	TEST_ASSERT_EQUAL(ATCA_BAD_PARAM, atcac_sw_drbg_instantiate(NULL, entropy, sizeof(entropy), nonce, sizeof(nonce), NULL, 0, 1));
+	TEST_ASSERT_EQUAL(ATCA_BAD_PARAM, atcac_sw_drbg_instantiate(&ctx, NULL, sizeof(entropy), nonce, sizeof(nonce), NULL, 0, 1));
+	TEST_ASSERT_EQUAL(ATCA_BAD_PARAM, atcac_sw_drbg_instantiate(&ctx, entropy, sizeof(entropy), nonce, sizeof(nonce), NULL, 1, 1));
+	TEST_ASSERT_EQUAL(ATCA_BAD_PARAM, atcac_sw_drbg_instantiate(&ctx, entropy, sizeof(entropy), nonce, sizeof(nonce), NULL, 0, 0));
+	TEST_ASSERT_EQUAL(ATCA_INVALID_SIZE, atcac_sw_drbg_instantiate(&ctx, entropy, sizeof(entropy) - 1, nonce, sizeof(nonce), NULL, 0, 1));
+	TEST_ASSERT_EQUAL(ATCA_INVALID_SIZE, atcac_sw_drbg_instantiate(&ctx, entropy, sizeof(entropy), nonce, sizeof(nonce) - 1, NULL, 0, 1));
+
+	TEST_ASSERT_EQUAL(ATCA_SUCCESS, atcac_sw_drbg_instantiate(&ctx, entropy, sizeof(entropy), nonce, sizeof(nonce), NULL, 0, 1));
+	TEST_ASSERT_EQUAL(ATCA_INVALID_SIZE, atcac_sw_drbg_reseed(&ctx, entropy, sizeof(entropy) - 1, NULL, 0));
+	TEST_ASSERT_EQUAL(ATCA_BAD_PARAM, atcac_sw_drbg_generate(&ctx, NULL, sizeof(output), NULL, 0));
+	TEST_ASSERT_EQUAL(ATCA_INVALID_SIZE, atcac_sw_drbg_generate(&ctx, output, ATCA_DRBG_MAX_REQUEST_SIZE + 1, NULL, 0));
+	TEST_ASSERT_EQUAL(ATCA_SUCCESS, atcac_sw_drbg_generate(&ctx, output, sizeof(output), NULL, 0));
+}
@@ -58,6 +58,14 @@ void test_atcac_sw_sha2_256_nist3(void);
 void test_atcac_sw_sha2_256_nist_short(void);
 void test_atcac_sw_sha2_256_nist_long(void);
 void test_atcac_sw_sha2_256_nist_monte(void);
+void test_atcac_sw_sha2_256_split(void);
+void test_atcac_sw_sha2_256_throughput(void);
+void test_atcrc_vectors(void);
+void test_atcrc_throughput(void);
+void test_atcac_sw_drbg_self_test(void);
+void test_atcac_sw_drbg_vectors(void);
+void test_atcac_sw_drbg_reseed_interval(void);
+void test_atcac_sw_drbg_bad_params(void);
 
 
 #endif
\ No newline at end of file
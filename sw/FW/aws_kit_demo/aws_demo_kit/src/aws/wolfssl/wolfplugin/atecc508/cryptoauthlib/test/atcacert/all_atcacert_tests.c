@@ -101,6 +101,7 @@ void RunAllCertDataTests(void)
 	RUN_TEST_GROUP(atcacert_merge_device_loc);
 	RUN_TEST_GROUP(atcacert_get_device_locs);
 	RUN_TEST_GROUP(atcacert_cert_build);
+	RUN_TEST_GROUP(atcacert_build_compiled);
 	RUN_TEST_GROUP(atcacert_is_device_loc_overlap);
 	RUN_TEST_GROUP(atcacert_get_device_data);
 }
@@ -0,0 +1,285 @@
+/**
+ * \file
+ * \brief cert definition tests
+ *
+ * \copyright Copyright (c) 2015 Atmel Corporation. All rights reserved.
+ *
+ * \atmel_crypto_device_library_license_start
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ *    Atmel integrated circuit.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \atmel_crypto_device_library_license_stop
+ */
+
+
+#include "atcacert/atcacert_def.h"
+#include "test/unity.h"
+#include "test/unity_fixture.h"
+#include "test_cert_def_0_device.h"
+#include "test_cert_def_1_signer.h"
+#include "test_cert_def_0_device_build.h"
+#include "test_cert_def_1_signer_build.h"
+#include <string.h>
+
+static const uint8_t g_build_ca_public_key[64] = {
+	0x8F, 0x8D, 0x18, 0x2B, 0xD8, 0x19, 0x04, 0x85, 0x82, 0xA9, 0x92, 0x7E, 0x73, 0x45, 0x44, 0x62,
+	0xD3, 0x6C, 0x71, 0x0E, 0x5C, 0xD3, 0xE0, 0x10, 0x2A, 0x07, 0x33, 0x6E, 0x9F, 0xC5, 0x42, 0xAD,
+	0x3D, 0x81, 0x5E, 0x9B, 0x29, 0x0A, 0x0C, 0x10, 0x96, 0xA0, 0xC5, 0x1F, 0xFD, 0x72, 0x66, 0x83,
+	0x1A, 0x33, 0x1E, 0x0A, 0x51, 0x4B, 0x11, 0xC1, 0x23, 0x5A, 0x4C, 0x97, 0x3D, 0xE7, 0x74, 0xFB
+};
+
+static const uint8_t g_build_public_key[64] = {
+	0x9F, 0x61, 0xEB, 0xA0, 0xD7, 0x9E, 0xF2, 0xC4, 0x96, 0xF1, 0x32, 0xF2, 0x50, 0x29, 0x01, 0xEF,
+	0xD1, 0xE8, 0x6D, 0x45, 0x1A, 0xAC, 0x59, 0x70, 0xBE, 0x62, 0xF3, 0xE5, 0xFC, 0x53, 0xF1, 0xD9,
+	0x20, 0x2D, 0x21, 0x9B, 0x3B, 0x66, 0x53, 0xC5, 0x5F, 0xD8, 0x1F, 0xAA, 0x99, 0x8C, 0x1F, 0x6C,
+	0x42, 0x14, 0x2C, 0x61, 0xB2, 0x83, 0x9E, 0x71, 0x40, 0x06, 0xF2, 0x52, 0x7C, 0xFE, 0xA2, 0x3E
+};
+
+static const uint8_t g_build_config32[32] = {
+	0x01, 0x23, 0x76, 0xAB, 0x00, 0x04, 0x05, 0x00, 0x0C, 0x8F, 0xB7, 0xBD, 0xEE, 0x55, 0x01, 0x00,
+	0xC0, 0x00, 0x55, 0x00, 0x8F, 0x2F, 0xC4, 0x44, 0x87, 0x20, 0xC4, 0xF4, 0x8F, 0x0F, 0x8F, 0x8F
+};
+
+static const atcacert_device_loc_t g_build_config_dev_loc = {
+	.zone		= DEVZONE_CONFIG,
+	.slot		= 0,
+	.is_genkey	= FALSE,
+	.offset		= 0,
+	.count		= 32
+};
+
+static void build_comp_cert(const atcacert_def_t* cert_def, uint32_t seed, uint8_t comp_cert[72])
+{
+	int ret = 0;
+	size_t i = 0;
+	atcacert_tm_utc_t issue_date = {
+		.tm_year	= 2016 - 1900 + (int)(seed % 10),
+		.tm_mon		= (int)(seed % 12),
+		.tm_mday	= 1 + (int)(seed % 28),
+		.tm_hour	= (int)(seed % 24),
+		.tm_min		= 0,
+		.tm_sec		= 0
+	};
+
+	// Signature bytes from a simple LCG, with the leading bytes varied to get every DER integer size
+	for (i = 0; i < 64; i++) {
+		seed = seed * 1103515245 + 12345;
+		comp_cert[i] = (uint8_t)(seed >> 16);
+	}
+	switch (seed % 4) {
+	case 0: comp_cert[0] = 0x00; comp_cert[1] = 0x00; comp_cert[32] = 0x00; break;
+	case 1: comp_cert[0] |= 0x80; comp_cert[32] |= 0x80; break;
+	case 2: comp_cert[0] &= 0x7F; comp_cert[32] |= 0x80; break;
+	default: memset(&comp_cert[32], 0, 32); break;
+	}
+
+	ret = atcacert_date_enc_compcert(&issue_date, cert_def->expire_years, &comp_cert[64]);
+	TEST_ASSERT_EQUAL(ATCACERT_E_SUCCESS, ret);
+	comp_cert[67] = (uint8_t)(seed >> 8);
+	comp_cert[68] = (uint8_t)seed;
+	comp_cert[69] = (uint8_t)((cert_def->template_id << 4) | cert_def->chain_id);
+	comp_cert[70] = (uint8_t)(cert_def->sn_source << 4);
+	comp_cert[71] = 0;
+}
+
+static int build_cert(const atcacert_def_t* cert_def, const uint8_t* ca_public_key, const uint8_t comp_cert[72], uint8_t* cert, size_t* cert_size)
+{
+	int ret = 0;
+	atcacert_build_state_t build_state;
+	uint8_t padded_public_key[72];
+
+	ret = atcacert_cert_build_start(&build_state, cert_def, cert, cert_size, ca_public_key);
+	if (ret != ATCACERT_E_SUCCESS)
+		return ret;
+
+	if (cert_def->public_key_dev_loc.count == 72) {
+		atcacert_public_key_add_padding(g_build_public_key, padded_public_key);
+		ret = atcacert_cert_build_process(&build_state, &cert_def->public_key_dev_loc, padded_public_key);
+	}else
+		ret = atcacert_cert_build_process(&build_state, &cert_def->public_key_dev_loc, g_build_public_key);
+	if (ret != ATCACERT_E_SUCCESS)
+		return ret;
+
+	ret = atcacert_cert_build_process(&build_state, &cert_def->comp_cert_dev_loc, comp_cert);
+	if (ret != ATCACERT_E_SUCCESS)
+		return ret;
+
+	ret = atcacert_cert_build_process(&build_state, &g_build_config_dev_loc, g_build_config32);
+	if (ret != ATCACERT_E_SUCCESS)
+		return ret;
+
+	return atcacert_cert_build_finish(&build_state);
+}
+
+static void build_data(atcacert_build_data_t* data, const uint8_t* ca_public_key, const uint8_t comp_cert[72], uint8_t device_sn[9])
+{
+	memcpy(&device_sn[0], &g_build_config32[0], 4);
+	memcpy(&device_sn[4], &g_build_config32[8], 5);
+
+	memset(data, 0, sizeof(*data));
+	data->ca_public_key = ca_public_key;
+	data->public_key = g_build_public_key;
+	data->comp_cert = comp_cert;
+	data->device_sn = device_sn;
+}
+
+static void test_build_identical(const atcacert_def_t* cert_def, atcacert_build_func_t build, const uint8_t* ca_public_key)
+{
+	int ret = 0;
+	uint32_t seed = 0;
+	uint8_t comp_cert[72];
+	uint8_t device_sn[9];
+	uint8_t cert_ref[512];
+	size_t cert_ref_size = 0;
+	uint8_t cert[512];
+	size_t cert_size = 0;
+	atcacert_build_data_t data;
+
+	for (seed = 1; seed <= 64; seed++) {
+		build_comp_cert(cert_def, seed, comp_cert);
+
+		cert_ref_size = sizeof(cert_ref);
+		ret = build_cert(cert_def, ca_public_key, comp_cert, cert_ref, &cert_ref_size);
+		TEST_ASSERT_EQUAL(ATCACERT_E_SUCCESS, ret);
+
+		build_data(&data, ca_public_key, comp_cert, device_sn);
+		memset(cert, 0xA5, sizeof(cert));
+		cert_size = sizeof(cert);
+		ret = build(&data, cert, &cert_size);
+		TEST_ASSERT_EQUAL(ATCACERT_E_SUCCESS, ret);
+		TEST_ASSERT_EQUAL(cert_ref_size, cert_size);
+		TEST_ASSERT_EQUAL_MEMORY(cert_ref, cert, cert_size);
+	}
+}
+
+TEST_GROUP(atcacert_build_compiled);
+
+TEST_SETUP(atcacert_build_compiled)
+{
+}
+
+TEST_TEAR_DOWN(atcacert_build_compiled)
+{
+}
+
+TEST(atcacert_build_compiled, signer)
+{
+	test_build_identical(&g_test_cert_def_1_signer, test_cert_def_1_signer_build, g_build_ca_public_key);
+}
+
+TEST(atcacert_build_compiled, signer_no_ca_key)
+{
+	test_build_identical(&g_test_cert_def_1_signer, test_cert_def_1_signer_build, NULL);
+}
+
+TEST(atcacert_build_compiled, device)
+{
+	test_build_identical(&g_test_cert_def_0_device, test_cert_def_0_device_build, g_build_ca_public_key);
+}
+
+TEST(atcacert_build_compiled, small_buf)
+{
+	int ret = 0;
+	uint8_t comp_cert[72];
+	uint8_t device_sn[9];
+	uint8_t cert[512];
+	size_t cert_ref_size = TEST_CERT_DEF_0_DEVICE_MAX_SIZE - 1;
+	size_t cert_size = TEST_CERT_DEF_0_DEVICE_MAX_SIZE - 1;
+	atcacert_build_data_t data;
+
+	build_comp_cert(&g_test_cert_def_0_device, 1, comp_cert);
+
+	ret = build_cert(&g_test_cert_def_0_device, g_build_ca_public_key, comp_cert, cert, &cert_ref_size);
+	TEST_ASSERT_EQUAL(ATCACERT_E_BUFFER_TOO_SMALL, ret);
+
+	build_data(&data, g_build_ca_public_key, comp_cert, device_sn);
+	ret = test_cert_def_0_device_build(&data, cert, &cert_size);
+	TEST_ASSERT_EQUAL(ATCACERT_E_BUFFER_TOO_SMALL, ret);
+	TEST_ASSERT_EQUAL(cert_ref_size, cert_size);
+}
+
+TEST(atcacert_build_compiled, wrong_cert_def)
+{
+	int ret = 0;
+	uint8_t comp_cert[72];
+	uint8_t device_sn[9];
+	uint8_t cert[512];
+	size_t cert_size = sizeof(cert);
+	atcacert_build_data_t data;
+
+	// Compressed certificate of the signer
+	build_comp_cert(&g_test_cert_def_1_signer, 1, comp_cert);
+	build_data(&data, g_build_ca_public_key, comp_cert, device_sn);
+	ret = test_cert_def_0_device_build(&data, cert, &cert_size);
+	TEST_ASSERT_EQUAL(ATCACERT_E_WRONG_CERT_DEF, ret);
+
+	// Unknown format
+	build_comp_cert(&g_test_cert_def_0_device, 1, comp_cert);
+	comp_cert[70] |= 0x01;
+	ret = test_cert_def_0_device_build(&data, cert, &cert_size);
+	TEST_ASSERT_EQUAL(ATCACERT_E_DECODING_ERROR, ret);
+}
+
+TEST(atcacert_build_compiled, bad_params)
+{
+	int ret = 0;
+	uint8_t comp_cert[72];
+	uint8_t device_sn[9];
+	uint8_t cert[512];
+	size_t cert_size = sizeof(cert);
+	atcacert_build_data_t data;
+
+	build_comp_cert(&g_test_cert_def_0_device, 1, comp_cert);
+	build_data(&data, g_build_ca_public_key, comp_cert, device_sn);
+
+	ret = test_cert_def_0_device_build(NULL, cert, &cert_size);
+	TEST_ASSERT_EQUAL(ATCACERT_E_BAD_PARAMS, ret);
+
+	ret = test_cert_def_0_device_build(&data, NULL, &cert_size);
+	TEST_ASSERT_EQUAL(ATCACERT_E_BAD_PARAMS, ret);
+
+	ret = test_cert_def_0_device_build(&data, cert, NULL);
+	TEST_ASSERT_EQUAL(ATCACERT_E_BAD_PARAMS, ret);
+
+	data.device_sn = NULL;
+	ret = test_cert_def_0_device_build(&data, cert, &cert_size);
+	TEST_ASSERT_EQUAL(ATCACERT_E_BAD_PARAMS, ret);
+
+	data.device_sn = device_sn;
+	data.comp_cert = NULL;
+	ret = test_cert_def_0_device_build(&data, cert, &cert_size);
+	TEST_ASSERT_EQUAL(ATCACERT_E_BAD_PARAMS, ret);
+
+	data.comp_cert = comp_cert;
+	data.public_key = NULL;
+	ret = test_cert_def_0_device_build(&data, cert, &cert_size);
+	TEST_ASSERT_EQUAL(ATCACERT_E_BAD_PARAMS, ret);
+}
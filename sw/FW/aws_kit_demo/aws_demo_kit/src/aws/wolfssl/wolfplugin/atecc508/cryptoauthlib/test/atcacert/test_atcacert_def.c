@@ -4246,6 +4246,109 @@ TEST(atcacert_merge_device_loc, 32block_round_up_merge)
 	TEST_ASSERT_EQUAL_MEMORY(&ref_device_loc, &device_locs[0], sizeof(device_locs[0]));
 }
 
+TEST(atcacert_merge_device_loc, 32block_round_down_before)
+{
+	int ret = 0;
+	atcacert_device_loc_t device_locs[1] = {
+		{
+			.zone = DEVZONE_DATA,
+			.slot = 8,
+			.is_genkey = FALSE,
+			.offset = 64,
+			.count = 32
+		}
+	};
+	size_t device_locs_count = 1;
+	size_t device_locs_max_count = sizeof(device_locs) / sizeof(device_locs[0]);
+	static const atcacert_device_loc_t new_device_loc = {
+		.zone		= DEVZONE_DATA,
+		.slot		= 8,
+		.is_genkey	= FALSE,
+		.offset		= 40,
+		.count		= 10
+	};
+	static const atcacert_device_loc_t ref_device_loc = {
+		.zone		= DEVZONE_DATA,
+		.slot		= 8,
+		.is_genkey	= FALSE,
+		.offset		= 32,
+		.count		= 64
+	};
+
+	ret = atcacert_merge_device_loc(
+	    device_locs,
+	    &device_locs_count,
+	    device_locs_max_count,
+	    &new_device_loc,
+	    32);
+	TEST_ASSERT_EQUAL(ATCACERT_E_SUCCESS, ret);
+	TEST_ASSERT_EQUAL(1, device_locs_count);
+	TEST_ASSERT_EQUAL_MEMORY(&ref_device_loc, &device_locs[0], sizeof(device_locs[0]));
+}
+
+TEST(atcacert_merge_device_loc, 32block_bridge)
+{
+	int ret = 0;
+	atcacert_device_loc_t device_locs[3] = {
+		{
+			.zone = DEVZONE_DATA,
+			.slot = 8,
+			.is_genkey = FALSE,
+			.offset = 0,
+			.count = 32
+		},
+		{
+			.zone = DEVZONE_DATA,
+			.slot = 10,
+			.is_genkey = FALSE,
+			.offset = 0,
+			.count = 72
+		},
+		{
+			.zone = DEVZONE_DATA,
+			.slot = 8,
+			.is_genkey = FALSE,
+			.offset = 96,
+			.count = 32
+		}
+	};
+	size_t device_locs_count = 3;
+	size_t device_locs_max_count = sizeof(device_locs) / sizeof(device_locs[0]);
+	static const atcacert_device_loc_t new_device_loc = {
+		.zone		= DEVZONE_DATA,
+		.slot		= 8,
+		.is_genkey	= FALSE,
+		.offset		= 40,
+		.count		= 40
+	};
+	static const atcacert_device_loc_t ref_device_locs[2] = {
+		{
+			.zone = DEVZONE_DATA,
+			.slot = 8,
+			.is_genkey = FALSE,
+			.offset = 0,
+			.count = 128
+		},
+		{
+			.zone = DEVZONE_DATA,
+			.slot = 10,
+			.is_genkey = FALSE,
+			.offset = 0,
+			.count = 72
+		}
+	};
+
+	ret = atcacert_merge_device_loc(
+	    device_locs,
+	    &device_locs_count,
+	    device_locs_max_count,
+	    &new_device_loc,
+	    32);
+	TEST_ASSERT_EQUAL(ATCACERT_E_SUCCESS, ret);
+	TEST_ASSERT_EQUAL(2, device_locs_count);
+	TEST_ASSERT_EQUAL_MEMORY(ref_device_locs, device_locs, sizeof(ref_device_locs));
+}
+
 TEST(atcacert_merge_device_loc, data_diff_slot)
 {
 	int ret = 0;
@@ -268,6 +268,8 @@ TEST_GROUP_RUNNER(atcacert_merge_device_loc)
 	RUN_TEST_CASE(atcacert_merge_device_loc, 32block_round_both);
 	RUN_TEST_CASE(atcacert_merge_device_loc, 32block_round_down_merge);
 	RUN_TEST_CASE(atcacert_merge_device_loc, 32block_round_up_merge);
+	RUN_TEST_CASE(atcacert_merge_device_loc, 32block_round_down_before);
+	RUN_TEST_CASE(atcacert_merge_device_loc, 32block_bridge);
 	RUN_TEST_CASE(atcacert_merge_device_loc, data_diff_slot);
 	RUN_TEST_CASE(atcacert_merge_device_loc, data_diff_genkey);
 	RUN_TEST_CASE(atcacert_merge_device_loc, config);
@@ -0,0 +1,72 @@
+// Generated by cert_def_compile from g_test_cert_def_0_device, do not edit.
+
+#include <string.h>
+#include "test_cert_def_0_device_build.h"
+#include "test_cert_def_0_device.h"
+#include "atcacert/atcacert_der.h"
+#include "atcacert/atcacert_date.h"
+
+static const char g_hex_digits[] = "0123456789ABCDEF";
+
+int test_cert_def_0_device_build(const atcacert_build_data_t* data, uint8_t* cert, size_t* cert_size)
+{
+	int ret = 0;
+	size_t sig_size = 75;
+	size_t cert_length = 0;
+	atcacert_tm_utc_t issue_date;
+	atcacert_tm_utc_t expire_date;
+
+	if (data == NULL || data->public_key == NULL || data->comp_cert == NULL || cert == NULL || cert_size == NULL)
+		return ATCACERT_E_BAD_PARAMS;
+	if (data->device_sn == NULL)
+		return ATCACERT_E_BAD_PARAMS;
+
+	if (*cert_size < TEST_CERT_DEF_0_DEVICE_MAX_SIZE) {
+		*cert_size = TEST_CERT_DEF_0_DEVICE_MAX_SIZE;
+		return ATCACERT_E_BUFFER_TOO_SMALL;
+	}
+
+	// Format 0, template ID 0, chain ID 0, SN source 0x8
+	if ((data->comp_cert[70] & 0x0F) != 0)
+		return ATCACERT_E_DECODING_ERROR;
+	if (data->comp_cert[69] != 0x00 || (data->comp_cert[70] >> 4) != 0x8)
+		return ATCACERT_E_WRONG_CERT_DEF;
+
+	// Everything in front of the signature comes from the template
+	memcpy(cert, g_test_cert_def_0_device.cert_template, 324);
+	ret = atcacert_der_enc_ecdsa_sig_value(&data->comp_cert[0], &cert[324], &sig_size);
+	if (ret != ATCACERT_E_SUCCESS)
+		return ret;
+	*cert_size = 324 + sig_size;
+	cert_length = *cert_size - 4;
+	cert[2] = (uint8_t)(cert_length >> 8);
+	cert[3] = (uint8_t)(cert_length & 0xFF);
+
+	if (data->ca_public_key != NULL) {
+		ret = atcacert_get_key_id(data->ca_public_key, &cert[292]);
+		if (ret != ATCACERT_E_SUCCESS)
+			return ret;
+	}
+
+	memcpy(&cert[211], data->public_key, 64);
+
+	ret = atcacert_date_dec_compcert(&data->comp_cert[64], DATEFMT_RFC5280_UTC, &issue_date, &expire_date);
+	if (ret != ATCACERT_E_SUCCESS)
+		return ret;
+	ret = atcacert_date_enc_rfc5280_utc(&issue_date, &cert[101]);
+	if (ret != ATCACERT_E_SUCCESS)
+		return ret;
+	ret = atcacert_date_enc_rfc5280_utc(&expire_date, &cert[116]);
+	if (ret != ATCACERT_E_SUCCESS)
+		return ret;
+	cert[93] = g_hex_digits[data->comp_cert[67] >> 4];
+	cert[94] = g_hex_digits[data->comp_cert[67] & 0x0F];
+	cert[95] = g_hex_digits[data->comp_cert[68] >> 4];
+	cert[96] = g_hex_digits[data->comp_cert[68] & 0x0F];
+
+	// Serial number is 0x40 + device SN
+	cert[15] = 0x40;
+	memcpy(&cert[16], data->device_sn, 9);
+
+	return ATCACERT_E_SUCCESS;
+}
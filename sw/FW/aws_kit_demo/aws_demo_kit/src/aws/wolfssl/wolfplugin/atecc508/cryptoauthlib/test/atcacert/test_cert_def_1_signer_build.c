@@ -0,0 +1,74 @@
+// Generated by cert_def_compile from g_test_cert_def_1_signer, do not edit.
+
+#include <string.h>
+#include "test_cert_def_1_signer_build.h"
+#include "test_cert_def_1_signer.h"
+#include "atcacert/atcacert_der.h"
+#include "atcacert/atcacert_date.h"
+
+static const char g_hex_digits[] = "0123456789ABCDEF";
+
+int test_cert_def_1_signer_build(const atcacert_build_data_t* data, uint8_t* cert, size_t* cert_size)
+{
+	int ret = 0;
+	size_t sig_size = 75;
+	size_t cert_length = 0;
+	atcacert_tm_utc_t issue_date;
+	atcacert_tm_utc_t expire_date;
+
+	if (data == NULL || data->public_key == NULL || data->comp_cert == NULL || cert == NULL || cert_size == NULL)
+		return ATCACERT_E_BAD_PARAMS;
+
+	if (*cert_size < TEST_CERT_DEF_1_SIGNER_MAX_SIZE) {
+		*cert_size = TEST_CERT_DEF_1_SIGNER_MAX_SIZE;
+		return ATCACERT_E_BUFFER_TOO_SMALL;
+	}
+
+	// Format 0, template ID 1, chain ID 0, SN source 0x9
+	if ((data->comp_cert[70] & 0x0F) != 0)
+		return ATCACERT_E_DECODING_ERROR;
+	if (data->comp_cert[69] != 0x10 || (data->comp_cert[70] >> 4) != 0x9)
+		return ATCACERT_E_WRONG_CERT_DEF;
+
+	// Everything in front of the signature comes from the template
+	memcpy(cert, g_test_cert_def_1_signer.cert_template, 363);
+	ret = atcacert_der_enc_ecdsa_sig_value(&data->comp_cert[0], &cert[363], &sig_size);
+	if (ret != ATCACERT_E_SUCCESS)
+		return ret;
+	*cert_size = 363 + sig_size;
+	cert_length = *cert_size - 4;
+	cert[2] = (uint8_t)(cert_length >> 8);
+	cert[3] = (uint8_t)(cert_length & 0xFF);
+
+	if (data->ca_public_key != NULL) {
+		ret = atcacert_get_key_id(data->ca_public_key, &cert[331]);
+		if (ret != ATCACERT_E_SUCCESS)
+			return ret;
+	}
+
+	memcpy(&cert[205], data->public_key, 64);
+	ret = atcacert_get_key_id(data->public_key, &cert[298]);
+	if (ret != ATCACERT_E_SUCCESS)
+		return ret;
+
+	ret = atcacert_date_dec_compcert(&data->comp_cert[64], DATEFMT_RFC5280_UTC, &issue_date, &expire_date);
+	if (ret != ATCACERT_E_SUCCESS)
+		return ret;
+	ret = atcacert_date_enc_rfc5280_utc(&issue_date, &cert[90]);
+	if (ret != ATCACERT_E_SUCCESS)
+		return ret;
+	ret = atcacert_date_enc_rfc5280_utc(&expire_date, &cert[105]);
+	if (ret != ATCACERT_E_SUCCESS)
+		return ret;
+	cert[174] = g_hex_digits[data->comp_cert[67] >> 4];
+	cert[175] = g_hex_digits[data->comp_cert[67] & 0x0F];
+	cert[176] = g_hex_digits[data->comp_cert[68] >> 4];
+	cert[177] = g_hex_digits[data->comp_cert[68] & 0x0F];
+
+	// Serial number is 0x40 + signer ID
+	cert[15] = 0x40;
+	cert[16] = data->comp_cert[67];
+	cert[17] = data->comp_cert[68];
+
+	return ATCACERT_E_SUCCESS;
+}
@@ -0,0 +1,31 @@
+// Generated by cert_def_compile from g_test_cert_def_1_signer, do not edit.
+
+#ifndef TEST_CERT_DEF_1_SIGNER_BUILD_H
+#define TEST_CERT_DEF_1_SIGNER_BUILD_H
+
+#include "atcacert/atcacert_def.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! Buffer size that holds the certificate with the largest signature
+#define TEST_CERT_DEF_1_SIGNER_MAX_SIZE (363 + 75)
+
+/**
+ * \brief Rebuilds the g_test_cert_def_1_signer certificate from the device data.
+ *
+ * \param[in]    data       Device data of the certificate.
+ * \param[out]   cert       Buffer to received the certificate.
+ * \param[inout] cert_size  As input, the size of the cert buffer in bytes.
+ *                          As output, the size of the certificate returned in cert in bytes.
+ *
+ * \return 0 on success
+ */
+int test_cert_def_1_signer_build(const atcacert_build_data_t* data, uint8_t* cert, size_t* cert_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_CERT_DEF_1_SIGNER_BUILD_H
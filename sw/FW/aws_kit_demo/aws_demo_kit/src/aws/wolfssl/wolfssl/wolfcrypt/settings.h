@@ -166,13 +166,23 @@
 	#define NO_DES3
 	#define NO_PWDBASED
 	#define NO_SKID
-	#define NO_SESSION_CACHE
+	/* the client keeps the session of its last connection for an abbreviated handshake */
+	#define SMALL_SESSION_CACHE
+	#define NO_CLIENT_CACHE
+	/* only for the supported_curves extension, which names the one curve the ATECC508A computes.
+	   HAVE_SESSION_TICKET stays off, reconnects resume by session ID */
+	#define HAVE_TLS_EXTENSIONS
+	#define HAVE_SUPPORTED_CURVES
 	#define WOLFSSL_USER_IO
 	#define WOLFSSL_STATIC_DH
 	#define WOLFSSL_CERT_GEN
 	#define WOLFSSL_SMALL_STACK
 	#define DEBUG_WOLFSSL
 	#define NO_WOLFSSL_SERVER	
+	#define WOLFSSL_ATCA_SHA256
+	/* one Hash_DRBG seeded by the ATECC508A serves all RNG instances, see atecc508cb.c */
+	#define CUSTOM_RAND_GENERATE_BLOCK atca_tls_random_block
+	extern int atca_tls_random_block(unsigned char* output, unsigned int sz);
 #endif
 
 #ifdef WOLFSSL_USER_SETTINGS
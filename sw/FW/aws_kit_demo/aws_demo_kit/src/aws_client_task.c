@@ -50,12 +50,38 @@
 #include "aws_main_task.h"
 #include "aws_user_task.h"
 #include "aws_client_task.h"
+#include "aws_kit_queue.h"
+#include "aws_kit_store.h"
+#include "aws_kit_crypto.h"
+#include "aws_kit_user_data.h"
 #include "aws/jsonlib/parson.h"
 #include "MQTTClient.h"
 
 
 Network mqtt_network;
 
+/** \brief Asynchronous connection context, the client task drives one connection at a time. */
+static struct {
+	uint8_t					state;
+	const char*				host;
+	uint16_t				port;
+	int						timeout_ms;
+	MqttTlsCb				cb;
+	uint32_t				startTick;
+	Timer					timer;
+	t_aws_crypto_request	prefetch;
+	bool					resumed;		/**< The last handshake resumed a session. */
+	bool					published;		/**< Something has been published on this connection. */
+	bool					sessionValid;	/**< session holds a session to offer. */
+	/* Kept in RAM only. It holds the master secret, and the key/value store is the unprotected WINC SPI
+	   flash, so the first connection after a reset always runs the full handshake. */
+	WOLFSSL_SESSION			session;		/**< Session of the last full handshake, offered on reconnect. */
+	uint32_t				heapInUse;		/**< Heap WolfSSL holds right now. */
+	uint32_t				heapPeak;		/**< Most heap WolfSSL held since the connection was set up. */
+	bool					registered;		/**< AWS IoT has accepted the Device certificate, it knows the Signer. */
+	bool					signerSent;		/**< The Signer certificate is sent on this connection. */
+} gConn;
+
 
 /**
  * \brief Returns packet ID.
@@ -83,16 +109,15 @@ bool aws_client_scan_button(t_aws_kit* kit)
 }
 
 /**
- * \brief This function initializes MQTT client, and tries to connect to destination address depending on a user AWS account.
+ * \brief This function initializes MQTT client, and starts to connect to destination address depending on a user AWS account.
  * The host address should be installed in ATECC508A through Insight GUI.
  *
  * \param kit[inout]          Pointer to an instance of AWS Kit
- * \return AWS_E_SUCCESS      On success
+ * \return AWS_E_NET_WANT_READ Once the connection has been started
  */
 int aws_client_init_mqtt_client(t_aws_kit* kit)
 {
 	int ret = AWS_E_FAILURE;	
-	MQTTPacket_connectData options = MQTTPacket_connectData_initializer;
 
 	do {
 		/* Set the network MQTT functions. */
@@ -111,16 +136,28 @@ int aws_client_init_mqtt_client(t_aws_kit* kit)
 		MQTTClientInit(&kit->client, &mqtt_network, AWS_MQTT_CMD_TIMEOUT_MS, kit->buffer.mqttTxBuf, 
 					   sizeof(kit->buffer.mqttTxBuf), kit->buffer.mqttRxBuf, sizeof(kit->buffer.mqttRxBuf));
 					   
-		/* Connect to AWS IoT over TLS handshaking with ECDHE-ECDSA-AES128-GCM-SHA256 cipher suite. 
-		   If TLS connection fails by AWS IoT during JITR, then return normal failure for the retry. */
+		/* Start connecting to AWS IoT over TLS handshaking with ECDHE-ECDSA-AES128-GCM-SHA256 cipher suite,
+		   aws_client_mqtt_connect_poll() moves it on from the next pass of the state machine. */
 		ret = aws_client_mqtt_connect(kit, (const char *)kit->user.host, AWS_IOT_MQTT_PORT,
 									  AWS_NET_CONN_TIMEOUT_MS, aws_client_net_tls_cb);
-		if (ret != SUCCESS) {
-			ret = AWS_E_NET_CONN_FAILURE;
-			AWS_ERROR("Error(%d) : Failed to connect to Host!", ret);
-			break;
-		}
+	} while(0);
 
+	return ret;
+}
+
+/**
+ * \brief Send the MQTT CONN packet over the established TLS session, and start the keep-alive timer.
+ *
+ * \param kit[inout]          Pointer to an instance of AWS Kit
+ * \return AWS_E_SUCCESS      On success
+ */
+int aws_client_mqtt_session(t_aws_kit* kit)
+{
+	int ret = AWS_E_FAILURE;
+	t_aws_crypto_stats cryptoStats;
+	MQTTPacket_connectData options = MQTTPacket_connectData_initializer;
+
+	do {
 		/* If both JITR and TLS session establishment have been successfully made, Send MQTT CONN packet. */
 		options.keepAliveInterval = AWS_IOT_KEEP_ALIVE_SEC;
 		options.cleansession = 1;
@@ -130,8 +167,17 @@ int aws_client_init_mqtt_client(t_aws_kit* kit)
 		if (ret != SUCCESS) {
 			ret = AWS_E_NET_TLS_FAILURE;
 			AWS_ERROR("Error(%d) : Failed to receive CONNACK!", ret);
+			/* Send the whole chain again, in case the Device certificate has to be registered again. */
+			gConn.registered = false;
 			break;
 		}
+		gConn.registered = true;
+		AWS_INFO("Connected in %lu ms%s", rtt_read_timer_value(RTT) - gConn.startTick,
+				 gConn.resumed ? ", session resumed" : "");
+		aws_kit_crypto_get_stats(&cryptoStats);
+		AWS_INFO("Crypto since boot: %lu TLS requests, %lu contended, longest TLS wait %lu ms, busy %lu ms",
+				 cryptoStats.requests[AWS_CRYPTO_PRIO_HIGH], cryptoStats.contended,
+				 cryptoStats.maxWait[AWS_CRYPTO_PRIO_HIGH], cryptoStats.busy);
 		
 		/* According to AWS message broker requirements, by default, MQTT client connection is disconnected 
 		   after 30 minutes of inactivity. When the client sends a PUBLISH, SUBSCRIBE, PING, or PUBACK message, 
@@ -145,44 +191,133 @@ int aws_client_init_mqtt_client(t_aws_kit* kit)
 	return ret;
 }
 
+/**
+ * \brief Start connecting to the host. Only the DNS query is sent here, nothing is waited for.
+ *
+ * \param kit[inout]          Pointer to an instance of AWS Kit
+ * \param host[in]            Host name
+ * \param port[in]            Host port
+ * \param timeout_ms[in]      Timeout of the DNS query and of the TCP connection
+ * \param cb[in]              Callback to set up the TLS context, or NULL
+ * \return AWS_E_NET_WANT_READ While the connection is in progress
+ */
 int aws_client_mqtt_connect(t_aws_kit* kit, const char *host, uint16_t port,
 							int timeout_ms, MqttTlsCb cb)
 {
-	int ret = AWS_E_SUCCESS;
-	Timer conTimer;
-	struct sockaddr_in dest_addr;
-	
+	gConn.host = host;
+	gConn.port = port;
+	gConn.timeout_ms = timeout_ms;
+	gConn.cb = cb;
+	gConn.startTick = rtt_read_timer_value(RTT);
+	gConn.resumed = false;
+	gConn.published = false;
+
 	/* Connect to the host */
 	registerSocketCallback(aws_net_socket_cb, aws_net_dns_resolve_cb);
 	delay_ms(50);
 	gethostbyname((uint8*)host);
-	TimerInit(&conTimer);
-	TimerCountdownMS(&conTimer, timeout_ms);
-	
-	while (!aws_net_get_host_addr()) {
-		if(TimerIsExpired(&conTimer)) {
-			ret = AWS_E_NET_DNS_TIMEOUT;
-			AWS_ERROR("Expired DNS timer!(%d)", ret);
-			return ret;
-		}
-		m2m_wifi_handle_events(NULL);
-	}
-	
-	/* Connect to the network socket */
-	ret = network_socket_connect(kit->socket, aws_net_get_host_addr(), port, timeout_ms);
-	if (ret != SOCK_ERR_NO_ERROR) {
-		AWS_ERROR("Failed to connect to host!(%d)(%x)", ret, aws_net_get_host_addr());
-		return AWS_E_NET_CONN_FAILURE;
-	}
+	TimerInit(&gConn.timer);
+	TimerCountdownMS(&gConn.timer, timeout_ms);
+	gConn.state = AWS_CLIENT_CONN_STATE_RESOLVE;
+
+	/* The ATECC508A reads the Device public key while the network is busy, rather than in the handshake */
+	if (!gConn.prefetch.pending && atca_tls_prefetch_device_pubkey(&gConn.prefetch) != ATCA_SUCCESS)
+		gConn.prefetch.pending = false;
+
+	return AWS_E_NET_WANT_READ;
+}
+
+#if AWS_IOT_TLS_HEAP_STATS
+/**
+ * \brief WolfSSL allocator which keeps the size of each block in a header, to count the heap WolfSSL holds.
+ *
+ * \param size[in]            Requested size
+ * \return Pointer to the block, NULL when out of heap
+ */
+static void* aws_client_tls_malloc(size_t size)
+{
+	uint8_t* block = malloc(size + AWS_CLIENT_TLS_HEAP_HDR_SIZE);
+
+	if (block == NULL)
+		return NULL;
+
+	*(size_t*)block = size;
+	gConn.heapInUse += size;
+	if (gConn.heapInUse > gConn.heapPeak)
+		gConn.heapPeak = gConn.heapInUse;
+
+	return block + AWS_CLIENT_TLS_HEAP_HDR_SIZE;
+}
+
+/**
+ * \brief WolfSSL deallocator, counterpart of aws_client_tls_malloc().
+ *
+ * \param ptr[in]             Block to release, or NULL
+ */
+static void aws_client_tls_free(void* ptr)
+{
+	uint8_t* block = (uint8_t*)ptr;
+
+	if (block == NULL)
+		return;
+
+	block -= AWS_CLIENT_TLS_HEAP_HDR_SIZE;
+	gConn.heapInUse -= *(size_t*)block;
+	free(block);
+}
+
+/**
+ * \brief WolfSSL reallocator, counterpart of aws_client_tls_malloc().
+ *
+ * \param ptr[in]             Block to resize, or NULL
+ * \param size[in]            New size
+ * \return Pointer to the resized block, NULL when out of heap
+ */
+static void* aws_client_tls_realloc(void* ptr, size_t size)
+{
+	uint8_t* block = (uint8_t*)ptr;
+	size_t oldSize;
+
+	if (block == NULL)
+		return aws_client_tls_malloc(size);
+
+	block -= AWS_CLIENT_TLS_HEAP_HDR_SIZE;
+	oldSize = *(size_t*)block;
+	block = realloc(block, size + AWS_CLIENT_TLS_HEAP_HDR_SIZE);
+	if (block == NULL)
+		return NULL;
+
+	*(size_t*)block = size;
+	gConn.heapInUse = gConn.heapInUse - oldSize + size;
+	if (gConn.heapInUse > gConn.heapPeak)
+		gConn.heapPeak = gConn.heapInUse;
+
+	return block + AWS_CLIENT_TLS_HEAP_HDR_SIZE;
+}
+#endif
+
+/**
+ * \brief Set up the WolfSSL session on the connected socket.
+ *
+ * \param kit[inout]          Pointer to an instance of AWS Kit
+ * \return SSL_SUCCESS        On success
+ */
+static int aws_client_tls_open(t_aws_kit* kit)
+{
+	int ret = SSL_SUCCESS;
+
+#if AWS_IOT_TLS_HEAP_STATS
+	/* Set before WolfSSL allocates anything, every block it frees then carries the size header. */
+	wolfSSL_SetAllocators(aws_client_tls_malloc, aws_client_tls_free, aws_client_tls_realloc);
+	gConn.heapPeak = gConn.heapInUse;
+#endif
 
-	aws_net_set_host_addr(0);
-	
 	/* Setup the WolfSSL library */
 	wolfSSL_Init();
+	kit->tls.ssl = NULL;
 	
-	ret = SSL_SUCCESS;
-	if (cb)
-		ret = cb(kit);
+	if (gConn.cb)
+		ret = gConn.cb(kit);
 
 	if (ret == SSL_SUCCESS) {
 		if (kit->tls.context == NULL) {
@@ -200,12 +335,12 @@ int aws_client_mqtt_connect(t_aws_kit* kit, const char *host, uint16_t port,
 			if (kit->tls.ssl) {
 				wolfSSL_SetIOReadCtx(kit->tls.ssl, (void*)&kit->client);
 				wolfSSL_SetIOWriteCtx(kit->tls.ssl, (void*)&kit->client);
-			
-				ret = wolfSSL_connect(kit->tls.ssl);
-				if (ret != SSL_SUCCESS) {
-					ret = AWS_E_NET_TLS_FAILURE;
-					AWS_ERROR("Error(%d) : Failed to TLS connect!", ret);
-				}
+#if AWS_IOT_TLS_RESUMPTION
+				/* If the server still knows the last session, it skips the certificates and the key exchange. */
+				wolfSSL_set_timeout(kit->tls.ssl, AWS_IOT_TLS_SESSION_TIMEOUT_SEC);
+				if (gConn.sessionValid && wolfSSL_set_session(kit->tls.ssl, &gConn.session) != SSL_SUCCESS)
+					gConn.sessionValid = false;
+#endif
 			} else {
 				ret = AWS_E_NET_TLS_FAILURE;
 				AWS_ERROR("Error(%d) : Failed to TLS init!", ret);
@@ -215,21 +350,152 @@ int aws_client_mqtt_connect(t_aws_kit* kit, const char *host, uint16_t port,
 			AWS_ERROR("Error(%d) : Failed to TLS context init!", ret);
 		}
 	}
-			
-	/* Cleanup the WolfSSL library */
-	if (ret == SSL_SUCCESS) {
-		ret = SUCCESS;
-	} else {
-		if (kit->tls.ssl)
-			wolfSSL_free(kit->tls.ssl);
-		
-		if (kit->tls.context)
-			wolfSSL_CTX_free(kit->tls.context);
-		
-		wolfSSL_Cleanup();
-		
-		network_socket_disconnect(kit->socket);
+
+	return ret;
+}
+
+/**
+ * \brief Move the connection started by aws_client_mqtt_connect() on by one step, without blocking.
+ * DNS, TCP connect and the TLS handshake each return to the state machine while they wait, the
+ * handshake is resumed by calling wolfSSL_connect() again.
+ * On failure, the socket and the WolfSSL session are released.
+ *
+ * \param kit[inout]             Pointer to an instance of AWS Kit
+ * \return AWS_E_SUCCESS         Once the TLS session is established
+ * \return AWS_E_NET_WANT_READ   While waiting for the DNS answer or the peer's handshake flight
+ * \return AWS_E_NET_WANT_WRITE  While waiting for the TCP connection or room in the WINC to send
+ * \return AWS_E_NET_WANT_CRYPTO While the ATECC508A works ahead of the handshake
+ */
+int aws_client_mqtt_connect_poll(t_aws_kit* kit)
+{
+	int ret = AWS_E_SUCCESS;
+	int error;
+	WOLFSSL_SESSION* session;
+	NetworkStats stats;
+
+	/* Let the WINC deliver the events the current step waits for. */
+	m2m_wifi_handle_events(NULL);
+
+	switch (gConn.state) {
+		case AWS_CLIENT_CONN_STATE_RESOLVE:
+		{
+			if (!aws_net_get_host_addr()) {
+				if (!TimerIsExpired(&gConn.timer))
+					return AWS_E_NET_WANT_READ;
+				if (!aws_net_use_cached_host_addr(gConn.host)) {
+					ret = AWS_E_NET_DNS_TIMEOUT;
+					AWS_ERROR("Expired DNS timer!(%d)", ret);
+					gConn.state = AWS_CLIENT_CONN_STATE_IDLE;
+					return ret;
+				}
+				AWS_WARN("Expired DNS timer, connecting to the last address of the host");
+			}
+
+			/* Connect to the network socket */
+			ret = network_socket_connect_start(kit->socket, aws_net_get_host_addr(), gConn.port);
+			if (ret != SOCK_ERR_NO_ERROR) {
+				AWS_ERROR("Failed to connect to host!(%d)(%x)", ret, aws_net_get_host_addr());
+				aws_net_set_host_addr(0);
+				ret = AWS_E_NET_CONN_FAILURE;
+				break;
+			}
+			aws_net_set_host_addr(0);
+
+			TimerCountdownMS(&gConn.timer, gConn.timeout_ms);
+			gConn.state = AWS_CLIENT_CONN_STATE_CONNECT;
+			return AWS_E_NET_WANT_WRITE;
+		}
+
+		case AWS_CLIENT_CONN_STATE_CONNECT:
+		{
+			ret = network_socket_connect_poll(kit->socket);
+			if (ret == NETWORK_SOCKET_PENDING) {
+				if (!TimerIsExpired(&gConn.timer))
+					return AWS_E_NET_WANT_WRITE;
+				ret = SOCK_ERR_TIMEOUT;
+			}
+			if (ret != SOCK_ERR_NO_ERROR) {
+				AWS_ERROR("Failed to connect to host!(%d)", ret);
+				ret = AWS_E_NET_CONN_FAILURE;
+				break;
+			}
+
+			gConn.state = AWS_CLIENT_CONN_STATE_HANDSHAKE;
+			ret = aws_client_tls_open(kit);
+			if (ret != SSL_SUCCESS)
+				break;
+
+			/* Send the ClientHello right away. */
+			TimerCountdownMS(&gConn.timer, AWS_CLIENT_TLS_HANDSHAKE_TIMEOUT_MS);
+		}
+		/* no break */
+
+		case AWS_CLIENT_CONN_STATE_HANDSHAKE:
+		{
+			if (TimerIsExpired(&gConn.timer)) {
+				ret = AWS_E_NET_TLS_FAILURE;
+				AWS_ERROR("Expired TLS handshake timer!(%d)", ret);
+				break;
+			}
+
+			/* The ClientKeyExchange needs the Device public key, the handshake starts once the ATECC508A has read it. */
+			if (gConn.prefetch.pending)
+				return AWS_E_NET_WANT_CRYPTO;
+
+			ret = wolfSSL_connect(kit->tls.ssl);
+			if (ret != SSL_SUCCESS) {
+				error = wolfSSL_get_error(kit->tls.ssl, ret);
+				if (error == SSL_ERROR_WANT_READ)
+					return AWS_E_NET_WANT_READ;
+				if (error == SSL_ERROR_WANT_WRITE)
+					return AWS_E_NET_WANT_WRITE;
+			} else {
+				/* Resumed sessions end on a client flight, push it out */
+				if (network_socket_flush(kit->socket, kit->tls.ssl->wflags, AWS_NET_CONN_TIMEOUT_MS) != SOCK_ERR_NO_ERROR)
+					ret = SSL_FATAL_ERROR;
+			}
+			if (ret != SSL_SUCCESS) {
+				ret = AWS_E_NET_TLS_FAILURE;
+				AWS_ERROR("Error(%d) : Failed to TLS connect!", ret);
+				/* Start over with a full handshake and the whole certificate chain. */
+				gConn.sessionValid = false;
+				gConn.registered = false;
+				break;
+			}
+
+			network_socket_get_stats(&stats);
+			AWS_INFO("TLS handshake: %lu bytes sent, %lu received%s", stats.txBytes, stats.rxBytes,
+					 gConn.signerSent ? "" : ", Signer certificate omitted");
+#if AWS_IOT_TLS_HEAP_STATS
+			AWS_INFO("TLS heap: peak %lu bytes, %lu held after the handshake", gConn.heapPeak, gConn.heapInUse);
+#endif
+
+			gConn.resumed = wolfSSL_session_reused(kit->tls.ssl);
+#if AWS_IOT_TLS_RESUMPTION
+			session = wolfSSL_get_session(kit->tls.ssl);
+			if (session) {
+				gConn.session = *session;
+				gConn.sessionValid = true;
+			}
+#endif
+			gConn.state = AWS_CLIENT_CONN_STATE_IDLE;
+			return AWS_E_SUCCESS;
+		}
+
+		default:
+		{
+			ret = AWS_E_FAILURE;
+			AWS_ERROR("No connection in progress!");
+			return ret;
+		}
 	}
+
+	/* Cleanup the socket, and the WolfSSL library once it has been set up */
+	if (gConn.state == AWS_CLIENT_CONN_STATE_HANDSHAKE)
+		aws_client_mqtt_close(kit);
+	else
+		network_socket_disconnect(kit->socket);
+	gConn.state = AWS_CLIENT_CONN_STATE_IDLE;
 	
 	return ret;
 }
@@ -268,7 +534,9 @@ int aws_client_mqtt_disconnect(t_aws_kit* kit)
 			break;
 		}
 		
-		/* Disconnect from AWS MQTT broker. */
+		/* Disconnect from AWS MQTT broker. The next connection may be made with other credentials, forget the session. */
+		gConn.sessionValid = false;
+		gConn.registered = false;
 		if (kit->tls.ssl)
 			wolfSSL_free(kit->tls.ssl);
 			
@@ -361,17 +629,39 @@ int aws_client_net_tls_cb(t_aws_kit* kit)
 			break;
 		}
 
-		/* As the AT88CKECCSIGNER already signed ATECC508A of Thing, There are the Signer and Device certificates in the ATECC508A. 
-		Both certificates should be set to WolfSSL for the JITR achievement. */
-		cert_chain = (uint8_t*)malloc(kit->cert.signerCertLen + kit->cert.devCertLen);
-		memcpy(&cert_chain[0], kit->cert.devCert, kit->cert.devCertLen);
-		memcpy(&cert_chain[kit->cert.devCertLen], kit->cert.signerCert, kit->cert.signerCertLen);
-		ret = wolfSSL_CTX_use_certificate_chain_buffer(kit->tls.context, cert_chain, kit->cert.signerCertLen + kit->cert.devCertLen);
+		/* The ATECC508A computes P-256 only, tell the server which curve to pick for ECDHE. */
+		ret = wolfSSL_CTX_UseSupportedCurve(kit->tls.context, WOLFSSL_ECC_SECP256R1);
 		if (ret != SSL_SUCCESS) {
-			AWS_ERROR("Failed to set cert chain!");
+			AWS_ERROR("Failed to set curve!");
 			break;
 		}
 
+		/* As the AT88CKECCSIGNER already signed ATECC508A of Thing, There are the Signer and Device certificates in the ATECC508A. 
+		Both certificates should be set to WolfSSL for the JITR achievement. 
+		Once AWS IoT has accepted the Device certificate, it is found without the Signer, which saves its bytes in every handshake. */
+		gConn.signerSent = !(AWS_IOT_TLS_OMIT_SIGNER_CERT && gConn.registered);
+		if (!gConn.signerSent) {
+			ret = wolfSSL_CTX_use_certificate_buffer(kit->tls.context, kit->cert.devCert, kit->cert.devCertLen, SSL_FILETYPE_PEM);
+			if (ret != SSL_SUCCESS) {
+				AWS_ERROR("Failed to set device cert!");
+				break;
+			}
+		} else {
+			cert_chain = (uint8_t*)malloc(kit->cert.signerCertLen + kit->cert.devCertLen);
+			if (cert_chain == NULL) {
+				ret = AWS_E_FAILURE;
+				AWS_ERROR("Failed to allocate heap!");
+				break;
+			}
+			memcpy(&cert_chain[0], kit->cert.devCert, kit->cert.devCertLen);
+			memcpy(&cert_chain[kit->cert.devCertLen], kit->cert.signerCert, kit->cert.signerCertLen);
+			ret = wolfSSL_CTX_use_certificate_chain_buffer(kit->tls.context, cert_chain, kit->cert.signerCertLen + kit->cert.devCertLen);
+			if (ret != SSL_SUCCESS) {
+				AWS_ERROR("Failed to set cert chain!");
+				break;
+			}
+		}
+
 		/* This Device private key is not actual private key of ATECC508A, and WolfSSL never use it as own Device key. 
 		   This temporary key has been set to make sure Device owns a private key. */
 		ret = wolfSSL_CTX_use_PrivateKey_buffer(kit->tls.context, AWS_TEMP_DEV_KEY, sizeof(AWS_TEMP_DEV_KEY), SSL_FILETYPE_PEM);
@@ -449,6 +739,11 @@ int aws_client_mqtt_publish(t_aws_kit* kit)
 		AWS_ERROR("Failed to publish the update topic(%d)", ret);
 		return AWS_E_CLI_PUB_FAILURE;
 	}
+	if (!gConn.published) {
+		gConn.published = true;
+		AWS_INFO("First publish %lu ms after connecting started, %s TLS handshake",
+				 rtt_read_timer_value(RTT) - gConn.startTick, gConn.resumed ? "abbreviated" : "full");
+	}
 	
 #ifdef AWS_KIT_DEBUG
 	AWS_INFO("Published LED Message : %s", pubMsg);
@@ -558,6 +853,74 @@ void aws_client_mqtt_message_cb(MessageData* data)
 	return ret;	
 }
 
+/**
+ * \brief Publish the queued messages oldest first, until the queue is empty or a publish fails.
+ * A message is only removed from the queue once it has been published.
+ *
+ * \param kit[in]             Pointer to an instance of AWS Kit
+ * \return AWS_E_SUCCESS      On success
+ */
+int aws_client_mqtt_drain(t_aws_kit* kit)
+{
+	int ret = AWS_E_SUCCESS;
+	t_aws_queue_entry entry;
+	MQTTMessage message;
+	uint32_t count = 0, bytes = 0;
+	uint32_t startTick = rtt_read_timer_value(RTT);
+
+	message.retained = 0;
+	message.qos = QOS0;
+	message.dup = 0;
+
+	while (aws_kit_queue_peek(&entry) == AWS_E_SUCCESS) {
+		message.id = aws_client_mqtt_packet_id();
+		message.payload = (void*)entry.payload;
+		message.payloadlen = entry.length;
+		kit->nonBlocking = true;
+
+		ret = MQTTPublish(&kit->client, (const char*)kit->topic.updateTopic, &message);
+		kit->nonBlocking = false;
+		if (ret != SUCCESS) {
+			AWS_ERROR("Failed to publish update topic!(%d)", ret);
+			ret = AWS_E_CLI_PUB_FAILURE;
+			break;
+		}
+
+		aws_kit_queue_pop(entry.sequence);
+		count++;
+		bytes += entry.length;
+	}
+
+	if (count) {
+		t_aws_queue_stats stats;
+		aws_kit_queue_get_stats(&stats);
+		AWS_INFO("Drained %lu messages (%lu bytes) in %lu ms, %lu dropped, longest wait %lu ms", count, bytes,
+				 rtt_read_timer_value(RTT) - startTick, stats.dropped, stats.maxLatency);
+	}
+
+	return ret;
+}
+
+/**
+ * \brief Release the TLS session and the socket of a broken connection, without any MQTT exchange.
+ *
+ * \param kit[inout]          Pointer to an instance of AWS Kit
+ */
+void aws_client_mqtt_close(t_aws_kit* kit)
+{
+	if (kit->tls.ssl)
+		wolfSSL_free(kit->tls.ssl);
+	kit->tls.ssl = NULL;
+
+	if (kit->tls.context)
+		wolfSSL_CTX_free(kit->tls.context);
+	kit->tls.context = NULL;
+
+	wolfSSL_Cleanup();
+
+	network_socket_disconnect(kit->socket);
+}
+
 /**
  * \brief If a user makes change LEDs state using Insight GUI, it will send the Update topic to AWS broker.
  * Then AWS IoT also will send the Delta topic for Thing to read it.
@@ -572,53 +935,19 @@ int aws_client_mqtt_wait_msg(t_aws_kit* kit)
 	/* Wait for Publish packets to arrive. */
 	ret = MQTTYield(&kit->client, AWS_MQTT_CMD_TIMEOUT_MS);
 	if (ret == SUCCESS) {
-		/* Check for a button state of OLED1 board. */
+		/* The User task has toggled the state of pressed buttons, save it to ATECC508A in the background. */
 		if (aws_client_scan_button(kit)) {
-			
-			char* serializedStr = NULL;
-			char reportedMsg[AWS_MQTT_PAYLOAD_MAX], intBuf[0], reportedBuf[32] = "state.reported.button";
-			JSON_Value* jPubVal = json_value_init_object();
-			JSON_Object* jObject = json_value_get_object(jPubVal);
-
 			for (uint8_t i = AWS_KIT_BUTTON_1; i < AWS_KIT_BUTTON_MAX; i++) {
-				if (kit->button.isPressed[i]) {
-					kit->button.isPressed[i] = false;
-					strcat((char*)reportedBuf, (const char*)itoa(i + 1, (char*)intBuf, 10));
-					json_object_dotset_string(jObject, (const char*)reportedBuf, (kit->button.state[i] ? "up" : "down"));
-					/* Save button state to toggle. */
-					kit->button.state[i] = kit->button.state[i] ? false : true;
-					ret = atcab_write_bytes_zone(ATCA_ZONE_DATA, TLS_SLOT8_ENC_STORE, AWS_USER_DATA_BUTTON_STATE, kit->button.state, 4);
-					if (ret != ATCA_SUCCESS) {
-						AWS_ERROR("Failed to write button state!(%d)", ret);
-						ret = AWS_E_CRYPTO_FAILURE;
-					}
-					break;
-				}
+				kit->button.isPressed[i] = false;
 			}
-
-			serializedStr = json_serialize_to_string((const JSON_Value *)jPubVal);
-			strcpy(reportedMsg, (const char*)serializedStr);
-			json_free_serialized_string(serializedStr);
-
-			MQTTMessage message;
-			message.retained = 0;
-			message.qos = QOS0;
-			message.dup = 0;
-			message.id = aws_client_mqtt_packet_id();
-			message.payload = (void*)reportedMsg;
-			message.payloadlen = strlen((char*)message.payload);
-			kit->nonBlocking = true;
-		
-			ret = MQTTPublish(&kit->client, (const char*)kit->topic.updateTopic, &message);
-			if (ret != SUCCESS) {
-				AWS_ERROR("Failed to publish update topic!(%d)", ret);
-				ret = AWS_E_CLI_PUB_FAILURE;
+			ret = aws_kit_user_data_write(AWS_USER_DATA_BUTTON_STATE, kit->button.state, 4);
+			if (ret != AWS_E_SUCCESS) {
+				AWS_ERROR("Failed to write button state!(%d)", ret);
 			}
+		}
 
-			kit->nonBlocking = false;
-
-			json_value_free(jPubVal);		
-		}		
+		/* Publish the events queued by the User task. */
+		ret = aws_client_mqtt_drain(kit);
 	}
 
 	return ret;
@@ -638,13 +967,28 @@ void aws_client_state_machine(t_aws_kit* kit)
 	static uint8_t currState = CLIENT_STATE_INIT_MQTT_CLIENT;
 	uint8_t nextState = CLIENT_STATE_INVALID;
 
+	/* Keep the wall clock in step from the task which owns the WINC. */
+	aws_net_ntp_poll();
+
 	switch (currState)
 	{
 		case CLIENT_STATE_INIT_MQTT_CLIENT:
+		case CLIENT_STATE_MQTT_CONNECT:
 		{
-			/* After initializing Paho MQTT, try to connect to host address. */
-			ret = aws_client_init_mqtt_client(kit);
-			if (ret == AWS_E_SUCCESS) {
+			if (currState == CLIENT_STATE_INIT_MQTT_CLIENT) {
+				/* After initializing Paho MQTT, start to connect to host address. */
+				ret = aws_client_init_mqtt_client(kit);
+			} else {
+				/* Run one step of the connection, the task comes back to it on its next pass. */
+				ret = aws_client_mqtt_connect_poll(kit);
+				/* If both JITR and TLS session establishment have been successfully made, Send MQTT CONN packet. */
+				if (ret == AWS_E_SUCCESS)
+					ret = aws_client_mqtt_session(kit);
+			}
+
+			if (ret == AWS_E_NET_WANT_READ || ret == AWS_E_NET_WANT_WRITE || ret == AWS_E_NET_WANT_CRYPTO) {
+				nextState = CLIENT_STATE_MQTT_CONNECT;
+			} else if (ret == AWS_E_SUCCESS) {
 				retryDelay = 0;
 				kit->errState = AWS_EX_NONE;
 				errorNoti = false;
@@ -655,7 +999,7 @@ void aws_client_state_machine(t_aws_kit* kit)
 				/* Since Thing is ready to communicate securely with AWS IoT, go to next state. */ 
 				nextState = CLIENT_STATE_MQTT_SUBSCRIBE;
 			/* For the Just In Time Registration, hold on seconds, and retry */
-			} else if (ret == AWS_E_NET_JITR_RETRY || AWS_E_NET_TLS_FAILURE) {
+			} else if (ret == AWS_E_NET_JITR_RETRY || ret == AWS_E_NET_TLS_FAILURE) {
 				retryDelay += 2;
 				if (retryDelay > 120) {
 					AWS_ERROR("Failed to exceed the limited 2 minutes to wait for finishing lambda");
@@ -739,7 +1083,9 @@ void aws_client_state_machine(t_aws_kit* kit)
 						kit->errState = AWS_EX_MQTT_FAILURE;
 						aws_user_exception_init_timer(kit);
 					}
-					nextState = CLIENT_STATE_INVALID;
+					/* Reconnect, the User task keeps queuing events meanwhile. */
+					aws_client_mqtt_close(kit);
+					nextState = CLIENT_STATE_INIT_MQTT_CLIENT;
 				}
 			}
 		}
@@ -777,7 +1123,7 @@ void aws_client_task(void* params)
 		/* Run state machine for Client task. */
 		aws_client_state_machine(kit);
 
-		/* Block for 100ms. */
-		vTaskDelay(AWS_CLIENT_TASK_DELAY);
+		/* Block for 100ms, or only yield between the steps of a connection. */
+		vTaskDelay((kit->clientState == CLIENT_STATE_MQTT_CONNECT) ? AWS_CLIENT_TASK_CONNECT_DELAY : AWS_CLIENT_TASK_DELAY);
 	}
 }
@@ -64,6 +64,7 @@ extern "C" {
    @{ */
 #define AWS_CLIENT_TASK_PRIORITY				(tskIDLE_PRIORITY + 2)
 #define AWS_CLIENT_TASK_DELAY					(100 / portTICK_RATE_MS)
+#define AWS_CLIENT_TASK_CONNECT_DELAY			(10 / portTICK_RATE_MS)
 #define AWS_CLIENT_TASK_STACK_SIZE				(5120)
 /** @} */
 
@@ -73,6 +74,18 @@ extern "C" {
 #define AWS_MQTT_PAYLOAD_MAX					(128)
 /** @} */
 
+/** \name Asynchronous connection states, and the time the whole TLS handshake may take
+   @{ */
+#define AWS_CLIENT_CONN_STATE_IDLE				(0)
+#define AWS_CLIENT_CONN_STATE_RESOLVE			(1)
+#define AWS_CLIENT_CONN_STATE_CONNECT			(2)
+#define AWS_CLIENT_CONN_STATE_HANDSHAKE			(3)
+#define AWS_CLIENT_TLS_HANDSHAKE_TIMEOUT_MS		(15000)
+/** @} */
+
+/** \brief Size header ahead of every WolfSSL heap block while AWS_IOT_TLS_HEAP_STATS is on, keeps the 8 byte alignment */
+#define AWS_CLIENT_TLS_HEAP_HDR_SIZE			(8)
+
 
 typedef int (*MqttTlsCb)(struct t_aws_kit *kit);
 
@@ -84,6 +97,8 @@ int aws_client_init_mqtt_client(t_aws_kit *kit);
 
 int aws_client_mqtt_connect(t_aws_kit* kit, const char *host, uint16_t port, 
 							int timeout_ms, MqttTlsCb cb);
+int aws_client_mqtt_connect_poll(t_aws_kit* kit);
+int aws_client_mqtt_session(t_aws_kit* kit);
 int aws_client_mqtt_disconnect(t_aws_kit* kit);
 
 int aws_client_tls_receive(WOLFSSL* ssl, char *buf, int sz, void *ptr);
@@ -94,6 +109,8 @@ int aws_client_mqtt_subscribe(t_aws_kit* kit);
 int aws_client_mqtt_publish(t_aws_kit* kit);
 void aws_client_mqtt_message_cb(MessageData* data);
 
+int aws_client_mqtt_drain(t_aws_kit* kit);
+void aws_client_mqtt_close(t_aws_kit* kit);
 int aws_client_mqtt_wait_msg(t_aws_kit* kit);
 void aws_client_state_machine(t_aws_kit* kit);
 void aws_client_task(void *params);
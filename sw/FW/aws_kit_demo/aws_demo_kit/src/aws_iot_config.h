@@ -68,6 +68,15 @@ extern "C" {
 //! MQTT message to report current buttons state.
 #define AWS_IOT_BUT_PUB_MESSAGE					"{\"state\":{\"reported\":{\"button1\":\"%s\",\"button2\":\"%s\",\"button3\":\"%s\"}}}"
 
+//! Offer the TLS session of the last connection, so a reconnect runs the abbreviated handshake without any ATECC508A operation.
+#define AWS_IOT_TLS_RESUMPTION					(1)
+//! Seconds a TLS session is offered for resumption after the full handshake.
+#define AWS_IOT_TLS_SESSION_TIMEOUT_SEC			(3600)
+//! Once AWS IoT has accepted the Device certificate, send it without the Signer certificate it was registered with.
+#define AWS_IOT_TLS_OMIT_SIGNER_CERT			(1)
+//! Count the heap WolfSSL holds and report its peak for every handshake. Each WolfSSL block grows by AWS_CLIENT_TLS_HEAP_HDR_SIZE.
+#define AWS_IOT_TLS_HEAP_STATS					(0)
+
 //! Max keep-alive seconds.
 #define AWS_IOT_KEEP_ALIVE_SEC					(1200)
 
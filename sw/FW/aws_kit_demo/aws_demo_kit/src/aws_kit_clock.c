@@ -0,0 +1,238 @@
+/**
+ *
+ * \file
+ *
+ * \brief AWS IoT Demo kit wall clock.
+ *
+ * Copyright (c) 2014-2016 Atmel Corporation. All rights reserved.
+ *
+ * \asf_license_start
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ *    Atmel microcontroller product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \asf_license_stop
+ *
+ */
+
+#include "aws_kit_clock.h"
+#include "aws_kit_debug.h"
+
+/** \brief Convert between binary and the BCD fields of the RTC. */
+#define AWS_CLOCK_TO_BCD(v)						((((v) / 10) << 4) | ((v) % 10))
+#define AWS_CLOCK_FROM_BCD(v)					((((v) >> 4) * 10) + ((v) & 0x0F))
+
+/**
+ * \brief Convert a civil date to days since 1970-01-01.
+ *
+ * \param year[in]           Full year, e.g. 2016
+ * \param mon[in]            Month [1-12]
+ * \param mday[in]           Day of the month [1-31]
+ * \return days since the Unix epoch
+ */
+static int32_t aws_kit_clock_days_from_civil(int year, int mon, int mday)
+{
+	int32_t era, yoe, doy, doe;
+
+	year -= (mon <= 2);
+	era = (year >= 0 ? year : year - 399) / 400;
+	yoe = year - era * 400;
+	doy = (153 * (mon + (mon > 2 ? -3 : 9)) + 2) / 5 + mday - 1;
+	doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+	return era * 146097 + doe - 719468;
+}
+
+/**
+ * \brief Convert days since 1970-01-01 to a civil date.
+ *
+ * \param days[in]           Days since the Unix epoch
+ * \param year[out]          Full year
+ * \param mon[out]           Month [1-12]
+ * \param mday[out]          Day of the month [1-31]
+ */
+static void aws_kit_clock_civil_from_days(int32_t days, int *year, int *mon, int *mday)
+{
+	int32_t era, doe, yoe, doy, mp;
+
+	days += 719468;
+	era = (days >= 0 ? days : days - 146096) / 146097;
+	doe = days - era * 146097;
+	yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	mp = (5 * doy + 2) / 153;
+
+	*mday = doy - (153 * mp + 2) / 5 + 1;
+	*mon = mp + (mp < 10 ? 3 : -9);
+	*year = yoe + era * 400 + (*mon <= 2);
+}
+
+/**
+ * \brief Convert a UTC date and time to seconds since the Unix epoch.
+ *
+ * \param year[in]           Full year, e.g. 2016
+ * \param mon[in]            Month [1-12]
+ * \param mday[in]           Day of the month [1-31]
+ * \param hour[in]           Hours [0-23]
+ * \param min[in]            Minutes [0-59]
+ * \param sec[in]            Seconds [0-59]
+ * \return seconds since 1970-01-01 00:00:00
+ */
+uint32_t aws_kit_clock_mktime(int year, int mon, int mday, int hour, int min, int sec)
+{
+	int32_t days = aws_kit_clock_days_from_civil(year, mon, mday);
+
+	return (uint32_t)days * 86400UL + hour * 3600UL + min * 60UL + sec;
+}
+
+/**
+ * \brief Check if both RTC and backup registers hold a wall clock.
+ *
+ * \return true when the clock has been set since the last power loss
+ */
+static bool aws_kit_clock_is_valid(void)
+{
+	return (GPBR->SYS_GPBR[AWS_CLOCK_GPBR_MAGIC] == AWS_CLOCK_MAGIC)
+			&& !(RTC->RTC_VER & (RTC_VER_NVTIM | RTC_VER_NVCAL));
+}
+
+/**
+ * \brief Initialize the RTC in 24-hour mode and report the restored clock.
+ *
+ * The RTC and GPBR live in the backup domain, so the wall clock survives software,
+ * watchdog and user resets. Only a backup power loss requires a new time source.
+ */
+void aws_kit_clock_init(void)
+{
+	RTC->RTC_MR &= ~RTC_MR_HRMOD;
+
+	if (aws_kit_clock_is_valid()) {
+		AWS_INFO("Wall clock restored from RTC : %lu (source %lu)", aws_kit_clock_get(),
+				 GPBR->SYS_GPBR[AWS_CLOCK_GPBR_SOURCE]);
+	} else {
+		GPBR->SYS_GPBR[AWS_CLOCK_GPBR_MAGIC] = 0;
+		GPBR->SYS_GPBR[AWS_CLOCK_GPBR_SOURCE] = AWS_CLOCK_SOURCE_NONE;
+	}
+}
+
+/**
+ * \brief Read the wall clock from the RTC.
+ *
+ * \return seconds since the Unix epoch, zero if the clock was never set
+ */
+uint32_t aws_kit_clock_get(void)
+{
+	uint32_t timr, calr;
+	int year, mon, mday;
+
+	if (!aws_kit_clock_is_valid())
+		return 0;
+
+	/* The registers are updated asynchronously, read until two samples match. */
+	do {
+		timr = RTC->RTC_TIMR;
+		calr = RTC->RTC_CALR;
+	} while ((timr != RTC->RTC_TIMR) || (calr != RTC->RTC_CALR));
+
+	year = AWS_CLOCK_FROM_BCD((calr & RTC_CALR_CENT_Msk) >> RTC_CALR_CENT_Pos) * 100
+		   + AWS_CLOCK_FROM_BCD((calr & RTC_CALR_YEAR_Msk) >> RTC_CALR_YEAR_Pos);
+	mon = AWS_CLOCK_FROM_BCD((calr & RTC_CALR_MONTH_Msk) >> RTC_CALR_MONTH_Pos);
+	mday = AWS_CLOCK_FROM_BCD((calr & RTC_CALR_DATE_Msk) >> RTC_CALR_DATE_Pos);
+
+	return aws_kit_clock_mktime(year, mon, mday,
+								AWS_CLOCK_FROM_BCD((timr & RTC_TIMR_HOUR_Msk) >> RTC_TIMR_HOUR_Pos),
+								AWS_CLOCK_FROM_BCD((timr & RTC_TIMR_MIN_Msk) >> RTC_TIMR_MIN_Pos),
+								AWS_CLOCK_FROM_BCD((timr & RTC_TIMR_SEC_Msk) >> RTC_TIMR_SEC_Pos));
+}
+
+/**
+ * \brief Write the wall clock into the RTC and mark it valid in the backup registers.
+ *
+ * The RTC accepts an update only at the next second boundary, so the time spent
+ * waiting for it is added before the new value is written.
+ *
+ * \param secs[in]           Seconds since the Unix epoch
+ * \param msec[in]           Milliseconds within the second
+ * \param source[in]         AWS_CLOCK_SOURCE_xxx
+ */
+void aws_kit_clock_set(uint32_t secs, uint16_t msec, uint8_t source)
+{
+	uint32_t startTick = rtt_read_timer_value(RTT);
+	uint32_t days, rem;
+	int year, mon, mday, wday;
+
+	RTC->RTC_CR |= RTC_CR_UPDTIM | RTC_CR_UPDCAL;
+	while (!(RTC->RTC_SR & RTC_SR_ACKUPD));
+	RTC->RTC_SCCR = RTC_SCCR_ACKCLR;
+
+	secs += (msec + (rtt_read_timer_value(RTT) - startTick)) / 1000;
+	days = secs / 86400UL;
+	rem = secs % 86400UL;
+	aws_kit_clock_civil_from_days(days, &year, &mon, &mday);
+	/* 1970-01-01 was a Thursday, the RTC counts weekdays from Monday = 1. */
+	wday = (days + 3) % 7 + 1;
+
+	RTC->RTC_TIMR = RTC_TIMR_HOUR(AWS_CLOCK_TO_BCD(rem / 3600)) | RTC_TIMR_MIN(AWS_CLOCK_TO_BCD((rem % 3600) / 60))
+					| RTC_TIMR_SEC(AWS_CLOCK_TO_BCD(rem % 60));
+	RTC->RTC_CALR = RTC_CALR_CENT(AWS_CLOCK_TO_BCD(year / 100)) | RTC_CALR_YEAR(AWS_CLOCK_TO_BCD(year % 100))
+					| RTC_CALR_MONTH(AWS_CLOCK_TO_BCD(mon)) | RTC_CALR_DAY(wday) | RTC_CALR_DATE(AWS_CLOCK_TO_BCD(mday));
+	RTC->RTC_CR &= ~(RTC_CR_UPDTIM | RTC_CR_UPDCAL);
+
+	GPBR->SYS_GPBR[AWS_CLOCK_GPBR_SOURCE] = source;
+	GPBR->SYS_GPBR[AWS_CLOCK_GPBR_MAGIC] = AWS_CLOCK_MAGIC;
+}
+
+/**
+ * \brief Raise the wall clock to a known lower bound, e.g. the certificate issue date.
+ *
+ * \param secs[in]           Seconds since the Unix epoch
+ * \return true if the clock was behind and has been moved forward
+ */
+bool aws_kit_clock_set_floor(uint32_t secs)
+{
+	if (aws_kit_clock_get() >= secs)
+		return false;
+
+	aws_kit_clock_set(secs, 0, AWS_CLOCK_SOURCE_CERT);
+	return true;
+}
+
+/**
+ * \brief Return where the current wall clock came from.
+ *
+ * \return AWS_CLOCK_SOURCE_xxx
+ */
+uint8_t aws_kit_clock_get_source(void)
+{
+	if (!aws_kit_clock_is_valid())
+		return AWS_CLOCK_SOURCE_NONE;
+
+	return (uint8_t)GPBR->SYS_GPBR[AWS_CLOCK_GPBR_SOURCE];
+}
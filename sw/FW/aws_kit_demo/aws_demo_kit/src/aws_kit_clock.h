@@ -0,0 +1,92 @@
+/**
+ *
+ * \file
+ *
+ * \brief AWS IoT Demo kit wall clock.
+ *
+ * Copyright (c) 2014-2016 Atmel Corporation. All rights reserved.
+ *
+ * \asf_license_start
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ *    Atmel microcontroller product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \asf_license_stop
+ *
+ */
+
+#ifndef AWS_KIT_CLOCK_H_
+#define AWS_KIT_CLOCK_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <asf.h>
+
+/**
+ * \defgroup Wall clock kept in the RTC and backup registers across resets
+ *
+ * @{
+ */
+
+/** \name Backup register layout
+   @{ */
+#define AWS_CLOCK_GPBR_MAGIC					(0)
+#define AWS_CLOCK_GPBR_SOURCE					(1)
+#define AWS_CLOCK_MAGIC							(0x41574343)
+/** @} */
+
+/** \name Where the current wall clock came from
+   @{ */
+#define AWS_CLOCK_SOURCE_NONE					(0)
+#define AWS_CLOCK_SOURCE_CERT					(1)
+#define AWS_CLOCK_SOURCE_NTP					(2)
+/** @} */
+
+/** \name Seconds between 1900 (NTP epoch) and 1970 (Unix epoch)
+   @{ */
+#define AWS_CLOCK_NTP_UNIX_OFFSET				(2208988800UL)
+/** @} */
+
+void aws_kit_clock_init(void);
+uint32_t aws_kit_clock_get(void);
+void aws_kit_clock_set(uint32_t secs, uint16_t msec, uint8_t source);
+bool aws_kit_clock_set_floor(uint32_t secs);
+uint8_t aws_kit_clock_get_source(void);
+uint32_t aws_kit_clock_mktime(int year, int mon, int mday, int hour, int min, int sec);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AWS_KIT_CLOCK_H_ */
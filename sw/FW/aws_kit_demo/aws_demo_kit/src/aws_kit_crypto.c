@@ -0,0 +1,476 @@
+/**
+ *
+ * \file
+ *
+ * \brief AWS IoT Demo kit outbound publish queue.
+ *
+ * Copyright (c) 2014-2016 Atmel Corporation. All rights reserved.
+ *
+ * \asf_license_start
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ *    Atmel microcontroller product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \asf_license_stop
+ *
+ */
+
+#include "aws_kit_crypto.h"
+#include "aws_kit_debug.h"
+#include "cryptoauthlib.h"
+
+//! Argument of the zone read and write requests
+typedef struct {
+	uint8_t zone;
+	uint16_t slot;
+	uint16_t offset;
+	uint8_t *data;
+	uint16_t length;
+} t_aws_crypto_bytes_arg;
+
+//! Handle of the crypto service task
+static xTaskHandle cryptoTaskHandler = NULL;
+//! Requests waiting for the service task, one queue per priority
+static xQueueHandle cryptoQueue[AWS_CRYPTO_PRIO_MAX];
+//! Counts the requests in all queues, the service task blocks on it
+static xSemaphoreHandle cryptoPending = NULL;
+//! Whether the service task is running a request
+static volatile bool cryptoBusy = false;
+//! Contention and wait counters
+static t_aws_crypto_stats cryptoStats;
+//! Completion semaphore of each task which waits for requests
+static struct {
+	xTaskHandle task;
+	xSemaphoreHandle done;
+} cryptoWaiters[AWS_CRYPTO_WAITERS_MAX];
+//! Task which holds the ATECC508A through aws_kit_crypto_acquire()
+static volatile xTaskHandle cryptoHolder = NULL;
+//! Given by the holder to let the service task go on
+static xSemaphoreHandle cryptoReleased = NULL;
+
+/**
+ * \brief Get the completion semaphore of the calling task, creating it on first use.
+ *
+ * A task waits for one request at a time, so one semaphore per task is enough.
+ *
+ * \return Semaphore handle, NULL if there are too many waiting tasks
+ */
+static xSemaphoreHandle aws_kit_crypto_get_waiter(void)
+{
+	xTaskHandle task = xTaskGetCurrentTaskHandle();
+	xSemaphoreHandle done = NULL;
+	uint8_t i;
+
+	taskENTER_CRITICAL();
+	for (i = 0; i < AWS_CRYPTO_WAITERS_MAX; i++) {
+		if (cryptoWaiters[i].task == task) {
+			done = cryptoWaiters[i].done;
+			break;
+		}
+		if (cryptoWaiters[i].task == NULL) {
+			/* Claim the entry, the semaphore is created outside of the critical section. */
+			cryptoWaiters[i].task = task;
+			break;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	if (i < AWS_CRYPTO_WAITERS_MAX && done == NULL) {
+		vSemaphoreCreateBinary(done);
+		if (done) xSemaphoreTake(done, 0);
+		cryptoWaiters[i].done = done;
+	}
+
+	return done;
+}
+
+/**
+ * \brief Crypto service task, runs the oldest request of the highest pending priority.
+ *
+ * \param[in] params        Parameters for the task (Not used.)
+ */
+static void aws_kit_crypto_task(void *params)
+{
+	t_aws_crypto_request *request = NULL;
+	t_aws_crypto_callback callback;
+	xSemaphoreHandle done;
+	portTickType start, wait;
+	int prio;
+
+	for (;;) {
+		if (xSemaphoreTake(cryptoPending, portMAX_DELAY) != pdTRUE)
+			continue;
+
+		/* Every give of the semaphore follows a queued request, so one of the queues holds it. */
+		for (prio = AWS_CRYPTO_PRIO_MAX - 1; prio >= AWS_CRYPTO_PRIO_LOW; prio--) {
+			if (xQueueReceive(cryptoQueue[prio], &request, 0) == pdTRUE)
+				break;
+		}
+		if (prio < AWS_CRYPTO_PRIO_LOW)
+			continue;
+
+		start = xTaskGetTickCount();
+		wait = (start - request->submitted) * portTICK_RATE_MS;
+		taskENTER_CRITICAL();
+		cryptoBusy = true;
+		cryptoStats.requests[prio]++;
+		cryptoStats.totalWait[prio] += wait;
+		if (wait > cryptoStats.maxWait[prio])
+			cryptoStats.maxWait[prio] = wait;
+		taskEXIT_CRITICAL();
+
+		request->status = request->func(request->arg);
+
+		taskENTER_CRITICAL();
+		cryptoBusy = false;
+		cryptoStats.busy += (xTaskGetTickCount() - start) * portTICK_RATE_MS;
+		taskEXIT_CRITICAL();
+
+		callback = request->callback;
+		done = request->done;
+		if (callback)
+			callback(request);
+
+		/* A waiting task may return, and its request go out of scope, as soon as pending is cleared.
+		   Nothing is read from the request after that. */
+		request->pending = false;
+		if (!callback && done)
+			xSemaphoreGive(done);
+	}
+}
+
+/**
+ * \brief Create the request queues and the crypto service task.
+ */
+void aws_kit_crypto_init(void)
+{
+	memset(cryptoWaiters, 0, sizeof(cryptoWaiters));
+	memset(&cryptoStats, 0, sizeof(cryptoStats));
+
+	for (uint8_t i = AWS_CRYPTO_PRIO_LOW; i < AWS_CRYPTO_PRIO_MAX; i++) {
+		cryptoQueue[i] = xQueueCreate(AWS_CRYPTO_QUEUE_DEPTH, sizeof(t_aws_crypto_request *));
+		if (cryptoQueue[i] == NULL) {
+			AWS_ERROR("Failed to create crypto request queue");
+			return;
+		}
+	}
+	cryptoPending = xSemaphoreCreateCounting(AWS_CRYPTO_PRIO_MAX * AWS_CRYPTO_QUEUE_DEPTH, 0);
+	if (cryptoPending == NULL) {
+		AWS_ERROR("Failed to create crypto request semaphore");
+		return;
+	}
+	vSemaphoreCreateBinary(cryptoReleased);
+	if (cryptoReleased == NULL) {
+		AWS_ERROR("Failed to create crypto release semaphore");
+		return;
+	}
+	xSemaphoreTake(cryptoReleased, 0);
+
+	xTaskCreate(aws_kit_crypto_task,
+			(const char *) "Crypto",
+			AWS_CRYPTO_TASK_STACK_SIZE,
+			NULL,
+			AWS_CRYPTO_TASK_PRIORITY,
+			&cryptoTaskHandler);
+}
+
+/**
+ * \brief Check whether the caller runs on the crypto service task, or holds the ATECC508A.
+ *
+ * \return true              If called from a request, a completion callback or the holding task
+ */
+bool aws_kit_crypto_in_service(void)
+{
+	xTaskHandle task = xTaskGetCurrentTaskHandle();
+
+	return cryptoTaskHandler && (task == cryptoTaskHandler || task == cryptoHolder);
+}
+
+/**
+ * \brief Get the contention and wait counters of the crypto service.
+ *
+ * \param stats[out]         Counters since the service was created
+ */
+void aws_kit_crypto_get_stats(t_aws_crypto_stats *stats)
+{
+	taskENTER_CRITICAL();
+	memcpy(stats, &cryptoStats, sizeof(cryptoStats));
+	taskEXIT_CRITICAL();
+}
+
+/**
+ * \brief Queue a request for the crypto service task.
+ *
+ * \param request[out]       Request to fill in, must stay valid until it has completed
+ * \param prio[in]           Priority of the request
+ * \param func[in]           Work to run on the service task
+ * \param arg[in]            Argument of func
+ * \param callback[in]       Completion callback, NULL to wait with aws_kit_crypto_wait()
+ * \param ctx[in]            Free for the callback
+ * \param ticks[in]          Time to wait for room in the request queue of the priority
+ * \return AWS_E_SUCCESS     On success
+ */
+static int aws_kit_crypto_queue(t_aws_crypto_request *request, t_aws_crypto_prio prio, t_aws_crypto_func func,
+								void *arg, t_aws_crypto_callback callback, void *ctx, portTickType ticks)
+{
+	if (!request || !func || prio >= AWS_CRYPTO_PRIO_MAX || !cryptoPending || aws_kit_crypto_in_service())
+		return AWS_E_BAD_PARAM;
+
+	request->func = func;
+	request->prio = prio;
+	request->arg = arg;
+	request->callback = callback;
+	request->ctx = ctx;
+	request->done = NULL;
+	request->status = AWS_E_FAILURE;
+	request->pending = true;
+
+	if (!callback && (request->done = aws_kit_crypto_get_waiter()) == NULL) {
+		request->pending = false;
+		AWS_ERROR("Too many tasks wait for crypto requests");
+		return AWS_E_FAILURE;
+	}
+
+	taskENTER_CRITICAL();
+	if (cryptoBusy || uxQueueMessagesWaiting(cryptoPending) > 0)
+		cryptoStats.contended++;
+	taskEXIT_CRITICAL();
+
+	request->submitted = xTaskGetTickCount();
+	if (xQueueSendToBack(cryptoQueue[prio], &request, ticks) != pdTRUE) {
+		request->pending = false;
+		return AWS_E_QUEUE_FULL;
+	}
+	xSemaphoreGive(cryptoPending);
+
+	return AWS_E_SUCCESS;
+}
+
+/**
+ * \brief Queue a request for the crypto service task.
+ *
+ * Blocks only while the request queue of the priority is full.
+ *
+ * \param request[out]       Request to fill in, must stay valid until it has completed
+ * \param prio[in]           Priority of the request
+ * \param func[in]           Work to run on the service task
+ * \param arg[in]            Argument of func
+ * \param callback[in]       Completion callback, NULL to wait with aws_kit_crypto_wait()
+ * \param ctx[in]            Free for the callback
+ * \return AWS_E_SUCCESS     On success
+ */
+int aws_kit_crypto_submit(t_aws_crypto_request *request, t_aws_crypto_prio prio, t_aws_crypto_func func,
+						  void *arg, t_aws_crypto_callback callback, void *ctx)
+{
+	return aws_kit_crypto_queue(request, prio, func, arg, callback, ctx, portMAX_DELAY);
+}
+
+/**
+ * \brief Queue a request for the crypto service task without blocking.
+ *
+ * For callers which must not block, such as timer callbacks run by the timer daemon task.
+ * The request needs a callback, nobody waits for it.
+ *
+ * \param request[out]       Request to fill in, must stay valid until it has completed
+ * \param prio[in]           Priority of the request
+ * \param func[in]           Work to run on the service task
+ * \param arg[in]            Argument of func
+ * \param callback[in]       Completion callback
+ * \param ctx[in]            Free for the callback
+ * \return AWS_E_SUCCESS     On success
+ * \return AWS_E_QUEUE_FULL  If the request queue of the priority is full
+ */
+int aws_kit_crypto_try_submit(t_aws_crypto_request *request, t_aws_crypto_prio prio, t_aws_crypto_func func,
+							  void *arg, t_aws_crypto_callback callback, void *ctx)
+{
+	if (!callback)
+		return AWS_E_BAD_PARAM;
+
+	return aws_kit_crypto_queue(request, prio, func, arg, callback, ctx, 0);
+}
+
+/**
+ * \brief Wait for a request submitted without a callback to complete.
+ *
+ * \param request[in]        Request
+ * \return Status returned by the work function of the request
+ */
+int aws_kit_crypto_wait(t_aws_crypto_request *request)
+{
+	if (!request || !request->done)
+		return AWS_E_BAD_PARAM;
+
+	while (request->pending)
+		xSemaphoreTake(request->done, portMAX_DELAY);
+
+	return request->status;
+}
+
+/**
+ * \brief Run work on the crypto service task and wait for it.
+ *
+ * The work runs directly when called before the service has been created, or from the
+ * service task itself, so code shared with the boot sequence does not have to care.
+ *
+ * \param prio[in]           Priority of the work
+ * \param func[in]           Work to run on the service task
+ * \param arg[in]            Argument of func
+ * \return Status returned by func
+ */
+int aws_kit_crypto_call(t_aws_crypto_prio prio, t_aws_crypto_func func, void *arg)
+{
+	t_aws_crypto_request request;
+	int ret;
+
+	if (!func)
+		return AWS_E_BAD_PARAM;
+	if (!cryptoTaskHandler || aws_kit_crypto_in_service())
+		return func(arg);
+
+	ret = aws_kit_crypto_submit(&request, prio, func, arg, NULL, NULL);
+	if (ret != AWS_E_SUCCESS)
+		return ret;
+
+	return aws_kit_crypto_wait(&request);
+}
+
+/**
+ * \brief Park the service task while another task holds the ATECC508A.
+ *
+ * \param arg[in]            Request of the holder, its task handle is in ctx
+ * \return AWS_E_SUCCESS     Once the holder has released the device
+ */
+static int aws_kit_crypto_hold_work(void *arg)
+{
+	t_aws_crypto_request *request = (t_aws_crypto_request *)arg;
+
+	cryptoHolder = (xTaskHandle)request->ctx;
+	xSemaphoreGive(request->done);
+	xSemaphoreTake(cryptoReleased, portMAX_DELAY);
+	cryptoHolder = NULL;
+
+	return AWS_E_SUCCESS;
+}
+
+/**
+ * \brief Hold the ATECC508A for the calling task, until aws_kit_crypto_release().
+ *
+ * For long command sequences with large buffers, such as the USB provisioning commands,
+ * which then run on the stack of the calling task. The device is granted through the
+ * request queues like any other work, and the service task runs nothing else until it
+ * is released. Meanwhile aws_kit_crypto_call() from the holding task runs directly.
+ *
+ * \param request[out]       Request to fill in, must stay valid until released
+ * \param prio[in]           Priority of the request
+ * \return AWS_E_SUCCESS     Once the device is held
+ */
+int aws_kit_crypto_acquire(t_aws_crypto_request *request, t_aws_crypto_prio prio)
+{
+	xTaskHandle task = xTaskGetCurrentTaskHandle();
+	int ret;
+
+	if (!request)
+		return AWS_E_BAD_PARAM;
+
+	/* Before the service exists, or within it, the caller already has the device to itself. */
+	request->func = NULL;
+	if (!cryptoTaskHandler || aws_kit_crypto_in_service())
+		return AWS_E_SUCCESS;
+
+	ret = aws_kit_crypto_submit(request, prio, aws_kit_crypto_hold_work, request, NULL, task);
+	if (ret != AWS_E_SUCCESS)
+		return ret;
+
+	/* The completion semaphore of the task is also given once the service has parked. */
+	while (cryptoHolder != task)
+		xSemaphoreTake(request->done, portMAX_DELAY);
+
+	return AWS_E_SUCCESS;
+}
+
+/**
+ * \brief Hand the ATECC508A held with aws_kit_crypto_acquire() back to the service task.
+ *
+ * \param request[in]        Request passed to aws_kit_crypto_acquire()
+ */
+void aws_kit_crypto_release(t_aws_crypto_request *request)
+{
+	if (!request || request->func != aws_kit_crypto_hold_work)
+		return;
+
+	xSemaphoreGive(cryptoReleased);
+	aws_kit_crypto_wait(request);
+}
+
+static int aws_kit_crypto_read_bytes_work(void *arg)
+{
+	t_aws_crypto_bytes_arg *bytes = (t_aws_crypto_bytes_arg *)arg;
+	return atcab_read_bytes_zone(bytes->zone, bytes->slot, bytes->offset, bytes->data, bytes->length);
+}
+
+static int aws_kit_crypto_write_bytes_work(void *arg)
+{
+	t_aws_crypto_bytes_arg *bytes = (t_aws_crypto_bytes_arg *)arg;
+	return atcab_write_bytes_zone(bytes->zone, bytes->slot, bytes->offset, bytes->data, bytes->length);
+}
+
+/**
+ * \brief Read bytes from a zone of the ATECC508A on the crypto service task.
+ *
+ * \param zone[in]           Zone to read from
+ * \param slot[in]           Slot to read from
+ * \param offset[in]         Byte offset in the slot
+ * \param data[out]          Buffer for the bytes
+ * \param length[in]         Number of bytes to read
+ * \return ATCA_SUCCESS      On success
+ */
+int aws_kit_crypto_read_bytes(uint8_t zone, uint16_t slot, uint16_t offset, uint8_t *data, uint16_t length)
+{
+	t_aws_crypto_bytes_arg bytes = { zone, slot, offset, data, length };
+	return aws_kit_crypto_call(AWS_CRYPTO_PRIO_NORMAL, aws_kit_crypto_read_bytes_work, &bytes);
+}
+
+/**
+ * \brief Write bytes to a zone of the ATECC508A on the crypto service task.
+ *
+ * Writes are background work, they run after any pending TLS or provisioning request.
+ *
+ * \param zone[in]           Zone to write to
+ * \param slot[in]           Slot to write to
+ * \param offset[in]         Byte offset in the slot
+ * \param data[in]           Bytes to write
+ * \param length[in]         Number of bytes to write
+ * \return ATCA_SUCCESS      On success
+ */
+int aws_kit_crypto_write_bytes(uint8_t zone, uint16_t slot, uint16_t offset, const uint8_t *data, uint16_t length)
+{
+	t_aws_crypto_bytes_arg bytes = { zone, slot, offset, (uint8_t *)data, length };
+	return aws_kit_crypto_call(AWS_CRYPTO_PRIO_LOW, aws_kit_crypto_write_bytes_work, &bytes);
+}
@@ -0,0 +1,136 @@
+/**
+ *
+ * \file
+ *
+ * \brief AWS IoT Demo kit outbound publish queue.
+ *
+ * Copyright (c) 2014-2016 Atmel Corporation. All rights reserved.
+ *
+ * \asf_license_start
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ *    Atmel microcontroller product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \asf_license_stop
+ *
+ */
+
+#ifndef AWS_KIT_CRYPTO_H_
+#define AWS_KIT_CRYPTO_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <asf.h>
+
+/**
+ * \defgroup Crypto service task which runs all ATECC508A work
+ *
+ * Tasks hand a function to the service instead of talking to the ATECC508A themselves, so
+ * device commands of different tasks never interleave. A request either completes through
+ * a callback run on the service task, or wakes the submitting task in aws_kit_crypto_wait().
+ * Between submit and wait the submitting task is free to do its own work.
+ * Long command sequences with large buffers can instead hold the device with aws_kit_crypto_acquire(),
+ * so they run on the stack of their own task while the service task waits.
+ *
+ * Each request has a priority. Pending requests of a higher priority always run first, so TLS
+ * handshake work never queues behind background slot 8 writes. A running request is not
+ * interrupted, a device command cannot be aborted half way.
+ *
+ * @{
+ */
+
+/** \name Crypto service task configuration
+   @{ */
+#define AWS_CRYPTO_TASK_PRIORITY				(tskIDLE_PRIORITY + 4)
+#define AWS_CRYPTO_TASK_STACK_SIZE				(1024)
+#define AWS_CRYPTO_QUEUE_DEPTH					(4)	/**< Pending requests per priority. */
+#define AWS_CRYPTO_WAITERS_MAX					(4)
+/** @} */
+
+/** \brief Priority of a crypto request. */
+typedef enum {
+	AWS_CRYPTO_PRIO_LOW = 0,			/**< Background work such as slot 8 writes. */
+	AWS_CRYPTO_PRIO_NORMAL,				/**< Boot, certificate and provisioning work. */
+	AWS_CRYPTO_PRIO_HIGH,				/**< TLS handshake work. */
+	AWS_CRYPTO_PRIO_MAX
+} t_aws_crypto_prio;
+
+/** \brief Counters to size the crypto service under load, times are in ms. */
+typedef struct {
+	uint32_t requests[AWS_CRYPTO_PRIO_MAX];		/**< Requests run per priority. */
+	uint32_t contended;							/**< Requests which found the service busy or other requests pending. */
+	uint32_t totalWait[AWS_CRYPTO_PRIO_MAX];	/**< Time requests waited to be run per priority. */
+	uint32_t maxWait[AWS_CRYPTO_PRIO_MAX];		/**< Longest time a request waited to be run per priority. */
+	uint32_t busy;								/**< Time spent running requests. */
+} t_aws_crypto_stats;
+
+struct AWS_CRYPTO_REQUEST;
+
+/** \brief Work run on the service task, returns the status of the request. */
+typedef int (*t_aws_crypto_func)(void *arg);
+/** \brief Completion callback, run on the service task. */
+typedef void (*t_aws_crypto_callback)(struct AWS_CRYPTO_REQUEST *request);
+
+/** \brief A request must stay valid until it has completed. */
+typedef struct AWS_CRYPTO_REQUEST {
+	t_aws_crypto_func func;				/**< Work to run. */
+	t_aws_crypto_prio prio;				/**< Priority of the work. */
+	portTickType submitted;				/**< Tick count when the request was queued. */
+	void *arg;							/**< Argument of func. */
+	t_aws_crypto_callback callback;		/**< Completion callback, or NULL to be waited for. */
+	void *ctx;							/**< Free for the callback. */
+	xSemaphoreHandle done;				/**< Given on completion when there is no callback. */
+	volatile bool pending;				/**< True until the request has completed and its callback returned. */
+	volatile int status;				/**< Return value of func. */
+} t_aws_crypto_request;
+
+void aws_kit_crypto_init(void);
+int aws_kit_crypto_submit(t_aws_crypto_request *request, t_aws_crypto_prio prio, t_aws_crypto_func func,
+						  void *arg, t_aws_crypto_callback callback, void *ctx);
+int aws_kit_crypto_try_submit(t_aws_crypto_request *request, t_aws_crypto_prio prio, t_aws_crypto_func func,
+							  void *arg, t_aws_crypto_callback callback, void *ctx);
+int aws_kit_crypto_wait(t_aws_crypto_request *request);
+int aws_kit_crypto_call(t_aws_crypto_prio prio, t_aws_crypto_func func, void *arg);
+int aws_kit_crypto_acquire(t_aws_crypto_request *request, t_aws_crypto_prio prio);
+void aws_kit_crypto_release(t_aws_crypto_request *request);
+bool aws_kit_crypto_in_service(void);
+void aws_kit_crypto_get_stats(t_aws_crypto_stats *stats);
+int aws_kit_crypto_read_bytes(uint8_t zone, uint16_t slot, uint16_t offset, uint8_t *data, uint16_t length);
+int aws_kit_crypto_write_bytes(uint8_t zone, uint16_t slot, uint16_t offset, const uint8_t *data, uint16_t length);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AWS_KIT_CRYPTO_H_ */
@@ -44,6 +44,10 @@
 
 #include <asf.h>
 #include "aws_kit_debug.h"
+#include "aws_kit_user_data.h"
+#include "aws_kit_store.h"
+#include "aws_kit_queue.h"
+#include "aws_net_interface.h"
 
 /**
  * \brief Return string to print it onto LCD of OLED1. (Not used.)
@@ -92,6 +96,14 @@ void aws_kit_lcd_print(AWS_KIT_LCD_INFO info)
 void aws_kit_software_reset(void)
 {
 	AWS_INFO("Reset system");
+	/* Changes to the user data which are still in RAM would be lost. */
+	aws_kit_user_data_flush();
+	/* The key/value store is only reachable with the WINC halted, save the runtime caches now. */
+	if (aws_kit_store_open() == AWS_E_SUCCESS) {
+		aws_kit_queue_save();
+		aws_net_save_host_cache();
+	}
+	aws_kit_store_close();
 	delay_ms(500);
 	rstc_start_software_reset(RSTC);
 }
\ No newline at end of file
@@ -86,6 +86,10 @@ enum {
 	AWS_E_CLI_PUB_FAILURE,
 	AWS_E_CLI_SUB_FAILURE,
 	AWS_E_MQTT_REINITIALIZE,
+	AWS_E_QUEUE_FULL,
+	AWS_E_NET_WANT_READ,
+	AWS_E_NET_WANT_WRITE,
+	AWS_E_NET_WANT_CRYPTO,
 } AWS_KIT_RET;
 
 typedef enum {
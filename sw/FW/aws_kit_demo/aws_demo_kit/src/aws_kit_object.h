@@ -153,6 +153,7 @@ typedef enum {
 typedef enum { 
 	CLIENT_STATE_INVALID,
 	CLIENT_STATE_INIT_MQTT_CLIENT,
+	CLIENT_STATE_MQTT_CONNECT,
 	CLIENT_STATE_MQTT_SUBSCRIBE,
 	CLIENT_STATE_MQTT_PUBLISH,
 	CLIENT_STATE_MQTT_WAIT_MESSAGE,
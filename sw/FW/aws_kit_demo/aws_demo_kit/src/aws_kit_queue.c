@@ -0,0 +1,279 @@
+/**
+ *
+ * \file
+ *
+ * \brief AWS IoT Demo kit outbound publish queue.
+ *
+ * Copyright (c) 2014-2016 Atmel Corporation. All rights reserved.
+ *
+ * \asf_license_start
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ *    Atmel microcontroller product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \asf_license_stop
+ *
+ */
+
+#include "aws_kit_queue.h"
+#include "aws_kit_store.h"
+#include "aws_kit_debug.h"
+#include "timer_interface.h"
+
+static t_aws_queue_entry queueEntries[AWS_QUEUE_DEPTH];
+static uint8_t queueHead = 0;
+static uint8_t queueCount = 0;
+static uint32_t queueSequence = 0;
+static t_aws_queue_stats queueStats;
+static xSemaphoreHandle queueLock = NULL;
+static xSemaphoreHandle queueSpace = NULL;
+
+/**
+ * \brief Put a message at the tail of the queue. The lock must be held and there must be room.
+ */
+static void aws_kit_queue_insert(const char *payload, uint16_t length)
+{
+	t_aws_queue_entry *entry = &queueEntries[(queueHead + queueCount) % AWS_QUEUE_DEPTH];
+
+	entry->sequence = ++queueSequence;
+	entry->tick = rtt_read_timer_value(RTT);
+	entry->length = length;
+	memcpy(entry->payload, payload, length);
+
+	queueCount++;
+	queueStats.pushed++;
+	if (queueCount > queueStats.highWater)
+		queueStats.highWater = queueCount;
+}
+
+/**
+ * \brief Create the queue. This must be called before any task pushes to it.
+ */
+void aws_kit_queue_init(void)
+{
+	queueLock = xSemaphoreCreateMutex();
+	vSemaphoreCreateBinary(queueSpace);
+	xSemaphoreTake(queueSpace, 0);
+	queueHead = queueCount = 0;
+	memset(&queueStats, 0, sizeof(queueStats));
+}
+
+/**
+ * \brief Push a message to the tail of the queue.
+ *
+ * When the queue is full, AWS_QUEUE_FULL_POLICY decides whether the oldest message is evicted,
+ * the new message is refused, or the producer waits for the client task to make room.
+ *
+ * \param payload[in]        Message payload
+ * \param length[in]         Length of payload, up to AWS_QUEUE_PAYLOAD_MAX
+ * \param timeout_ms[in]     How long to wait for room with AWS_QUEUE_BLOCK
+ * \return AWS_E_SUCCESS     On success, AWS_E_QUEUE_FULL if the message was not queued
+ */
+int aws_kit_queue_push(const char *payload, uint16_t length, uint32_t timeout_ms)
+{
+	int ret = AWS_E_QUEUE_FULL;
+	Timer waitTimer;
+
+	if (!payload || !length || length > AWS_QUEUE_PAYLOAD_MAX)
+		return AWS_E_BAD_PARAM;
+
+	TimerInit(&waitTimer);
+	TimerCountdownMS(&waitTimer, timeout_ms);
+
+	for (;;) {
+		xSemaphoreTake(queueLock, portMAX_DELAY);
+		if (queueCount == AWS_QUEUE_DEPTH && AWS_QUEUE_FULL_POLICY == AWS_QUEUE_DROP_OLDEST) {
+			queueHead = (queueHead + 1) % AWS_QUEUE_DEPTH;
+			queueCount--;
+			queueStats.dropped++;
+		}
+		if (queueCount < AWS_QUEUE_DEPTH) {
+			aws_kit_queue_insert(payload, length);
+			ret = AWS_E_SUCCESS;
+		}
+		xSemaphoreGive(queueLock);
+
+		if (ret == AWS_E_SUCCESS || AWS_QUEUE_FULL_POLICY != AWS_QUEUE_BLOCK || TimerIsExpired(&waitTimer))
+			break;
+
+		/* Hold the producer back until a message has been drained. */
+		xSemaphoreTake(queueSpace, TimerLeftMS(&waitTimer) / portTICK_RATE_MS + 1);
+	}
+
+	if (ret != AWS_E_SUCCESS) {
+		xSemaphoreTake(queueLock, portMAX_DELAY);
+		queueStats.dropped++;
+		xSemaphoreGive(queueLock);
+	}
+
+	return ret;
+}
+
+/**
+ * \brief Copy the oldest message without removing it.
+ *
+ * \param entry[out]         Oldest message
+ * \return AWS_E_SUCCESS     On success, AWS_E_FAILURE if the queue is empty
+ */
+int aws_kit_queue_peek(t_aws_queue_entry *entry)
+{
+	int ret = AWS_E_FAILURE;
+
+	xSemaphoreTake(queueLock, portMAX_DELAY);
+	if (queueCount) {
+		memcpy(entry, &queueEntries[queueHead], sizeof(t_aws_queue_entry));
+		ret = AWS_E_SUCCESS;
+	}
+	xSemaphoreGive(queueLock);
+
+	return ret;
+}
+
+/**
+ * \brief Remove the oldest message once it has been published.
+ *
+ * Nothing is removed if the message was evicted in the meantime.
+ *
+ * \param sequence[in]       Sequence of the message returned by aws_kit_queue_peek()
+ */
+void aws_kit_queue_pop(uint32_t sequence)
+{
+	uint32_t latency;
+
+	xSemaphoreTake(queueLock, portMAX_DELAY);
+	if (queueCount && queueEntries[queueHead].sequence == sequence) {
+		latency = rtt_read_timer_value(RTT) - queueEntries[queueHead].tick;
+		if (latency > queueStats.maxLatency)
+			queueStats.maxLatency = latency;
+		queueHead = (queueHead + 1) % AWS_QUEUE_DEPTH;
+		queueCount--;
+		queueStats.drained++;
+	}
+	xSemaphoreGive(queueLock);
+
+	xSemaphoreGive(queueSpace);
+}
+
+/**
+ * \brief Number of queued messages.
+ */
+uint8_t aws_kit_queue_count(void)
+{
+	return queueCount;
+}
+
+/**
+ * \brief Report the counters of the queue.
+ *
+ * \param stats[out]         Counters of the queue
+ */
+void aws_kit_queue_get_stats(t_aws_queue_stats *stats)
+{
+	xSemaphoreTake(queueLock, portMAX_DELAY);
+	memcpy(stats, &queueStats, sizeof(t_aws_queue_stats));
+	xSemaphoreGive(queueLock);
+}
+
+/**
+ * \brief Write the queued messages to the key/value store, oldest first.
+ *
+ * The store must have been opened with aws_kit_store_open().
+ *
+ * \return AWS_E_SUCCESS     On success
+ */
+int aws_kit_queue_save(void)
+{
+	int ret = AWS_E_SUCCESS;
+	uint8_t i;
+
+	xSemaphoreTake(queueLock, portMAX_DELAY);
+	for (i = 0; i < AWS_QUEUE_DEPTH && ret == AWS_E_SUCCESS; i++) {
+		if (i < queueCount) {
+			t_aws_queue_entry *entry = &queueEntries[(queueHead + i) % AWS_QUEUE_DEPTH];
+			ret = aws_kit_store_set(AWS_STORE_KEY_PUB_QUEUE + i, (const uint8_t *)entry->payload, entry->length);
+		} else {
+			ret = aws_kit_store_delete(AWS_STORE_KEY_PUB_QUEUE + i);
+		}
+	}
+	if (ret == AWS_E_SUCCESS)
+		AWS_INFO("Saved %d queued messages", queueCount);
+	xSemaphoreGive(queueLock);
+
+	return ret;
+}
+
+/**
+ * \brief Put the messages saved by aws_kit_queue_save() in front of the queue, and remove them from the store.
+ *
+ * The store must have been opened with aws_kit_store_open(). Messages are delivered at most once
+ * across resets, they are only saved again if the connection cannot be restored.
+ *
+ * \return AWS_E_SUCCESS     On success
+ */
+int aws_kit_queue_restore(void)
+{
+	int ret = AWS_E_SUCCESS;
+	t_aws_queue_entry *entry;
+	uint8_t i, restored = 0;
+
+	xSemaphoreTake(queueLock, portMAX_DELAY);
+	for (i = AWS_QUEUE_DEPTH; i-- > 0;) {
+		if (!aws_kit_store_exists(AWS_STORE_KEY_PUB_QUEUE + i))
+			continue;
+
+		if (queueCount < AWS_QUEUE_DEPTH) {
+			queueHead = (queueHead + AWS_QUEUE_DEPTH - 1) % AWS_QUEUE_DEPTH;
+			entry = &queueEntries[queueHead];
+			if (aws_kit_store_get(AWS_STORE_KEY_PUB_QUEUE + i, (uint8_t *)entry->payload,
+					sizeof(entry->payload), &entry->length) == AWS_E_SUCCESS) {
+				entry->sequence = ++queueSequence;
+				entry->tick = rtt_read_timer_value(RTT);
+				queueCount++;
+				restored++;
+			} else {
+				queueHead = (queueHead + 1) % AWS_QUEUE_DEPTH;
+			}
+		} else {
+			queueStats.dropped++;
+		}
+
+		ret = aws_kit_store_delete(AWS_STORE_KEY_PUB_QUEUE + i);
+		if (ret != AWS_E_SUCCESS)
+			break;
+	}
+	if (queueCount > queueStats.highWater)
+		queueStats.highWater = queueCount;
+	xSemaphoreGive(queueLock);
+
+	if (restored)
+		AWS_INFO("Restored %d queued messages", restored);
+
+	return ret;
+}
@@ -0,0 +1,110 @@
+/**
+ *
+ * \file
+ *
+ * \brief AWS IoT Demo kit outbound publish queue.
+ *
+ * Copyright (c) 2014-2016 Atmel Corporation. All rights reserved.
+ *
+ * \asf_license_start
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ *    Atmel microcontroller product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \asf_license_stop
+ *
+ */
+
+#ifndef AWS_KIT_QUEUE_H_
+#define AWS_KIT_QUEUE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <asf.h>
+
+/**
+ * \defgroup Outbound publish queue which holds messages while the MQTT connection is down
+ *
+ * Messages leave the queue in the order they were pushed. The client task peeks the oldest
+ * message, publishes it and only then pops it, so a failed publish is retried after reconnecting.
+ * The queue lives in RAM and is carried across a reset through the key/value store.
+ *
+ * @{
+ */
+
+/** \name Queue configuration
+   @{ */
+#define AWS_QUEUE_DEPTH							(16)
+#define AWS_QUEUE_PAYLOAD_MAX					(128)
+/** @} */
+
+/** \name What happens to a push when the queue is full
+   @{ */
+#define AWS_QUEUE_DROP_OLDEST					(0)
+#define AWS_QUEUE_DROP_NEWEST					(1)
+#define AWS_QUEUE_BLOCK							(2)
+#define AWS_QUEUE_FULL_POLICY					(AWS_QUEUE_DROP_OLDEST)
+/** @} */
+
+/** \brief A queued message. */
+typedef struct {
+	uint32_t sequence;						/**< Identifies the message while it is queued. */
+	uint32_t tick;							/**< RTT tick when the message was pushed. */
+	uint16_t length;						/**< Length of payload. */
+	char payload[AWS_QUEUE_PAYLOAD_MAX];	/**< Message payload. */
+} t_aws_queue_entry;
+
+/** \brief Counters of the queue, reported by aws_kit_queue_get_stats(). */
+typedef struct {
+	uint32_t pushed;		/**< Messages accepted. */
+	uint32_t dropped;		/**< Messages evicted or refused because the queue was full. */
+	uint32_t drained;		/**< Messages published and popped. */
+	uint32_t highWater;		/**< Highest number of messages queued at once. */
+	uint32_t maxLatency;	/**< Longest time in ms a message waited in the queue. */
+} t_aws_queue_stats;
+
+void aws_kit_queue_init(void);
+int aws_kit_queue_push(const char *payload, uint16_t length, uint32_t timeout_ms);
+int aws_kit_queue_peek(t_aws_queue_entry *entry);
+void aws_kit_queue_pop(uint32_t sequence);
+uint8_t aws_kit_queue_count(void);
+void aws_kit_queue_get_stats(t_aws_queue_stats *stats);
+int aws_kit_queue_save(void);
+int aws_kit_queue_restore(void);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AWS_KIT_QUEUE_H_ */
@@ -0,0 +1,671 @@
+/**
+ *
+ * \file
+ *
+ * \brief AWS IoT Demo kit persistent key/value store on the ATWINC1500 SPI flash.
+ *
+ * Copyright (c) 2014-2016 Atmel Corporation. All rights reserved.
+ *
+ * \asf_license_start
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ *    Atmel microcontroller product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \asf_license_stop
+ *
+ */
+
+#include "aws_kit_store.h"
+#include "aws_kit_debug.h"
+#include "bsp/include/nm_bsp.h"
+#include "driver/include/m2m_wifi.h"
+#include "driver/source/nmdrv.h"
+#include "spi_flash/include/spi_flash.h"
+
+/** \name On-flash layout
+   @{ */
+#define AWS_STORE_SECTOR_MAGIC					(0x41575353)
+#define AWS_STORE_RECORD_MAGIC					(0xA5)
+#define AWS_STORE_RECORD_LIVE					(0x5A)
+#define AWS_STORE_RECORD_DELETED				(0x00)
+#define AWS_STORE_ERASED						(0xFFFFFFFF)
+#define AWS_STORE_ALIGN(n)						(((n) + 3) & ~3)
+/** @} */
+
+/** \name Working limits
+   @{ */
+#define AWS_STORE_FLASH_MIN_MBIT				(4)
+#define AWS_STORE_COPY_CHUNK					(64)
+/** @} */
+
+/** \name State of a sector in RAM
+   @{ */
+#define AWS_STORE_SECTOR_DIRTY					(0)
+#define AWS_STORE_SECTOR_FREE					(1)
+#define AWS_STORE_SECTOR_ACTIVE					(2)
+/** @} */
+
+/** \brief Header at the start of every sector. The sequence and its complement are programmed when the sector joins the log. */
+typedef struct {
+	uint32_t magic;
+	uint32_t eraseCount;
+	uint32_t sequence;
+	uint32_t sequenceInv;
+} t_aws_store_sector_hdr;
+
+/** \brief Header in front of every record. The CRC covers key, flags, length and value. */
+typedef struct {
+	uint8_t magic;
+	uint8_t key;
+	uint8_t flags;
+	uint8_t reserved;
+	uint16_t length;
+	uint16_t crc;
+} t_aws_store_record_hdr;
+
+typedef struct {
+	uint8_t state;
+	uint16_t used;
+	uint32_t sequence;
+	uint32_t eraseCount;
+} t_aws_store_sector;
+
+typedef struct {
+	uint8_t key;
+	uint8_t sector;
+	uint16_t offset;
+	uint16_t length;
+} t_aws_store_index;
+
+static t_aws_store_sector storeSectors[AWS_STORE_SECTORS];
+static t_aws_store_index storeIndex[AWS_STORE_MAX_KEYS];
+static uint8_t storeHead = 0;
+static uint32_t storeNextSequence = 1;
+static bool storeMounted = false;
+static bool storeOpened = false;
+
+/**
+ * \brief Update a CRC-16/CCITT with a block of data.
+ *
+ * \param crc[in]            CRC of the preceding data, 0xFFFF to start
+ * \param data[in]           Data to be added
+ * \param length[in]         Length of data
+ * \return updated CRC
+ */
+static uint16_t aws_kit_store_crc(uint16_t crc, const uint8_t *data, uint32_t length)
+{
+	uint8_t bit;
+
+	while (length--) {
+		crc ^= (uint16_t)(*data++) << 8;
+		for (bit = 0; bit < 8; bit++) {
+			crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+		}
+	}
+
+	return crc;
+}
+
+/**
+ * \brief CRC of a record header, the value is added on top of it.
+ */
+static uint16_t aws_kit_store_crc_header(const t_aws_store_record_hdr *hdr)
+{
+	uint8_t fields[4] = { hdr->key, hdr->flags, (uint8_t)hdr->length, (uint8_t)(hdr->length >> 8) };
+
+	return aws_kit_store_crc(0xFFFF, fields, sizeof(fields));
+}
+
+static uint32_t aws_kit_store_addr(uint8_t sector, uint16_t offset)
+{
+	return AWS_STORE_FLASH_OFFSET + (uint32_t)sector * AWS_STORE_SECTOR_SIZE + offset;
+}
+
+static int aws_kit_store_read(uint32_t addr, void *buf, uint32_t length)
+{
+	return (spi_flash_read((uint8_t *)buf, addr, length) == M2M_SUCCESS) ? AWS_E_SUCCESS : AWS_E_FAILURE;
+}
+
+static int aws_kit_store_write(uint32_t addr, const void *buf, uint32_t length)
+{
+	return (spi_flash_write((uint8_t *)buf, addr, length) == M2M_SUCCESS) ? AWS_E_SUCCESS : AWS_E_FAILURE;
+}
+
+static t_aws_store_index* aws_kit_store_find(uint8_t key)
+{
+	int i;
+
+	for (i = 0; i < AWS_STORE_MAX_KEYS; i++) {
+		if (storeIndex[i].key == key)
+			return &storeIndex[i];
+	}
+
+	return NULL;
+}
+
+/**
+ * \brief Point the index at the newest record of a key, or drop the key for a deleted record.
+ *
+ * \return AWS_E_SUCCESS     On success, AWS_E_FAILURE when the index is full
+ */
+static int aws_kit_store_index_update(uint8_t key, uint8_t flags, uint8_t sector, uint16_t offset, uint16_t length)
+{
+	t_aws_store_index *entry = aws_kit_store_find(key);
+
+	if (flags == AWS_STORE_RECORD_DELETED) {
+		if (entry)
+			entry->key = 0;
+		return AWS_E_SUCCESS;
+	}
+
+	if (!entry)
+		entry = aws_kit_store_find(0);
+	if (!entry)
+		return AWS_E_FAILURE;
+
+	entry->key = key;
+	entry->sector = sector;
+	entry->offset = offset;
+	entry->length = length;
+
+	return AWS_E_SUCCESS;
+}
+
+/**
+ * \brief Check the CRC of a record by streaming its value out of flash.
+ */
+static bool aws_kit_store_check_record(uint8_t sector, uint16_t offset, const t_aws_store_record_hdr *hdr)
+{
+	uint8_t chunk[AWS_STORE_COPY_CHUNK];
+	uint32_t addr = aws_kit_store_addr(sector, offset + sizeof(t_aws_store_record_hdr));
+	uint16_t remain = hdr->length, size;
+	uint16_t crc = aws_kit_store_crc_header(hdr);
+
+	while (remain) {
+		size = (remain > sizeof(chunk)) ? sizeof(chunk) : remain;
+		if (aws_kit_store_read(addr, chunk, size) != AWS_E_SUCCESS)
+			return false;
+		crc = aws_kit_store_crc(crc, chunk, size);
+		addr += size;
+		remain -= size;
+	}
+
+	return (crc == hdr->crc);
+}
+
+/**
+ * \brief Replay the records of a sector into the index and find where the sector ends.
+ *
+ * A torn record with a sane header is skipped. Anything else which is not erased seals the sector.
+ */
+static void aws_kit_store_scan_sector(uint8_t sector)
+{
+	t_aws_store_record_hdr hdr;
+	uint16_t offset = sizeof(t_aws_store_sector_hdr);
+
+	while (offset + sizeof(hdr) <= AWS_STORE_SECTOR_SIZE) {
+
+		if (aws_kit_store_read(aws_kit_store_addr(sector, offset), &hdr, sizeof(hdr)) != AWS_E_SUCCESS) {
+			offset = AWS_STORE_SECTOR_SIZE;
+			break;
+		}
+
+		if (hdr.magic == 0xFF && hdr.key == 0xFF && hdr.length == 0xFFFF)
+			break;
+
+		if (hdr.magic != AWS_STORE_RECORD_MAGIC || hdr.length > AWS_STORE_VALUE_MAX ||
+			offset + sizeof(hdr) + AWS_STORE_ALIGN(hdr.length) > AWS_STORE_SECTOR_SIZE) {
+			AWS_WARN("Store sector %d sealed at %d", sector, offset);
+			offset = AWS_STORE_SECTOR_SIZE;
+			break;
+		}
+
+		if (aws_kit_store_check_record(sector, offset, &hdr)) {
+			if (aws_kit_store_index_update(hdr.key, hdr.flags, sector, offset, hdr.length) != AWS_E_SUCCESS)
+				AWS_WARN("Store index is full, key %d dropped", hdr.key);
+		} else {
+			AWS_WARN("Store record at %d:%d is corrupted", sector, offset);
+		}
+
+		offset += sizeof(hdr) + AWS_STORE_ALIGN(hdr.length);
+	}
+
+	storeSectors[sector].used = offset;
+}
+
+/**
+ * \brief Erase a sector and leave a header with its erase count, so the count survives until it is reused.
+ */
+static int aws_kit_store_erase_sector(uint8_t sector)
+{
+	t_aws_store_sector_hdr hdr;
+
+	if (spi_flash_erase(aws_kit_store_addr(sector, 0), AWS_STORE_SECTOR_SIZE) != M2M_SUCCESS) {
+		AWS_ERROR("Failed to erase store sector %d", sector);
+		return AWS_E_FAILURE;
+	}
+
+	hdr.magic = AWS_STORE_SECTOR_MAGIC;
+	hdr.eraseCount = storeSectors[sector].eraseCount + 1;
+	hdr.sequence = AWS_STORE_ERASED;
+	hdr.sequenceInv = AWS_STORE_ERASED;
+	if (aws_kit_store_write(aws_kit_store_addr(sector, 0), &hdr, sizeof(hdr)) != AWS_E_SUCCESS)
+		return AWS_E_FAILURE;
+
+	storeSectors[sector].state = AWS_STORE_SECTOR_FREE;
+	storeSectors[sector].eraseCount = hdr.eraseCount;
+	storeSectors[sector].sequence = 0;
+	storeSectors[sector].used = sizeof(hdr);
+
+	return AWS_E_SUCCESS;
+}
+
+static uint8_t aws_kit_store_free_sectors(void)
+{
+	uint8_t i, count = 0;
+
+	for (i = 0; i < AWS_STORE_SECTORS; i++) {
+		if (storeSectors[i].state != AWS_STORE_SECTOR_ACTIVE)
+			count++;
+	}
+
+	return count;
+}
+
+/**
+ * \brief Make the least worn free sector the new head of the log.
+ */
+static int aws_kit_store_next_sector(void)
+{
+	uint8_t i, sector = AWS_STORE_SECTORS;
+	uint32_t sequence[2] = { storeNextSequence, ~storeNextSequence };
+
+	for (i = 0; i < AWS_STORE_SECTORS; i++) {
+		if (storeSectors[i].state == AWS_STORE_SECTOR_ACTIVE)
+			continue;
+		if (sector == AWS_STORE_SECTORS || storeSectors[i].eraseCount < storeSectors[sector].eraseCount)
+			sector = i;
+	}
+	if (sector == AWS_STORE_SECTORS)
+		return AWS_E_FAILURE;
+
+	if (storeSectors[sector].state == AWS_STORE_SECTOR_DIRTY) {
+		if (aws_kit_store_erase_sector(sector) != AWS_E_SUCCESS)
+			return AWS_E_FAILURE;
+	}
+
+	/* Erased bits of the header are programmed in place. */
+	if (aws_kit_store_write(aws_kit_store_addr(sector, offsetof(t_aws_store_sector_hdr, sequence)),
+			sequence, sizeof(sequence)) != AWS_E_SUCCESS)
+		return AWS_E_FAILURE;
+
+	storeSectors[sector].state = AWS_STORE_SECTOR_ACTIVE;
+	storeSectors[sector].sequence = storeNextSequence;
+	storeSectors[sector].used = sizeof(t_aws_store_sector_hdr);
+	storeNextSequence++;
+	storeHead = sector;
+
+	return AWS_E_SUCCESS;
+}
+
+static int aws_kit_store_reserve(uint16_t need, bool compacting);
+
+/**
+ * \brief Move the live records out of the oldest sector to the head of the log, and erase it.
+ */
+static int aws_kit_store_compact(void)
+{
+	uint8_t chunk[AWS_STORE_COPY_CHUNK];
+	uint8_t i, oldest = AWS_STORE_SECTORS;
+	uint16_t need, done, size;
+
+	for (i = 0; i < AWS_STORE_SECTORS; i++) {
+		if (storeSectors[i].state != AWS_STORE_SECTOR_ACTIVE)
+			continue;
+		if (oldest == AWS_STORE_SECTORS || storeSectors[i].sequence < storeSectors[oldest].sequence)
+			oldest = i;
+	}
+	if (oldest == AWS_STORE_SECTORS || oldest == storeHead)
+		return AWS_E_FAILURE;
+
+	for (i = 0; i < AWS_STORE_MAX_KEYS; i++) {
+		if (!storeIndex[i].key || storeIndex[i].sector != oldest)
+			continue;
+
+		need = sizeof(t_aws_store_record_hdr) + AWS_STORE_ALIGN(storeIndex[i].length);
+		if (aws_kit_store_reserve(need, true) != AWS_E_SUCCESS)
+			return AWS_E_FAILURE;
+
+		for (done = 0; done < need; done += size) {
+			size = ((uint16_t)(need - done) > sizeof(chunk)) ? sizeof(chunk) : (uint16_t)(need - done);
+			if (aws_kit_store_read(aws_kit_store_addr(oldest, storeIndex[i].offset + done), chunk, size) != AWS_E_SUCCESS ||
+				aws_kit_store_write(aws_kit_store_addr(storeHead, storeSectors[storeHead].used + done), chunk, size) != AWS_E_SUCCESS)
+				return AWS_E_FAILURE;
+		}
+
+		storeIndex[i].sector = storeHead;
+		storeIndex[i].offset = storeSectors[storeHead].used;
+		storeSectors[storeHead].used += need;
+	}
+
+	return aws_kit_store_erase_sector(oldest);
+}
+
+/**
+ * \brief Make sure the head of the log has room for a record.
+ *
+ * One sector is held back for compaction, only a compaction may take it.
+ *
+ * \param need[in]           Size of the record including its header
+ * \param compacting[in]     True when called to relocate records
+ * \return AWS_E_SUCCESS     On success
+ */
+static int aws_kit_store_reserve(uint16_t need, bool compacting)
+{
+	uint8_t rounds = 0;
+
+	while (storeSectors[storeHead].used + need > AWS_STORE_SECTOR_SIZE) {
+
+		if (aws_kit_store_free_sectors() > (compacting ? 0 : AWS_STORE_RESERVED_SECTORS)) {
+			if (aws_kit_store_next_sector() != AWS_E_SUCCESS)
+				return AWS_E_FAILURE;
+		} else if (compacting || rounds++ >= AWS_STORE_SECTORS || aws_kit_store_compact() != AWS_E_SUCCESS) {
+			AWS_ERROR("Store is full");
+			return AWS_E_FAILURE;
+		}
+	}
+
+	return AWS_E_SUCCESS;
+}
+
+/**
+ * \brief Append a record to the head of the log and index it.
+ */
+static int aws_kit_store_append(uint8_t key, uint8_t flags, const uint8_t *value, uint16_t length)
+{
+	t_aws_store_record_hdr hdr;
+	uint16_t need = sizeof(hdr) + AWS_STORE_ALIGN(length);
+	uint16_t offset;
+
+	if (aws_kit_store_reserve(need, false) != AWS_E_SUCCESS)
+		return AWS_E_FAILURE;
+	offset = storeSectors[storeHead].used;
+
+	hdr.magic = AWS_STORE_RECORD_MAGIC;
+	hdr.key = key;
+	hdr.flags = flags;
+	hdr.reserved = 0xFF;
+	hdr.length = length;
+	hdr.crc = aws_kit_store_crc(aws_kit_store_crc_header(&hdr), value, length);
+
+	/* The header goes first, so a torn value is caught by its CRC and skipped on the next mount. */
+	storeSectors[storeHead].used += need;
+	if (aws_kit_store_write(aws_kit_store_addr(storeHead, offset), &hdr, sizeof(hdr)) != AWS_E_SUCCESS)
+		return AWS_E_FAILURE;
+	if (length && aws_kit_store_write(aws_kit_store_addr(storeHead, offset + sizeof(hdr)), value, length) != AWS_E_SUCCESS)
+		return AWS_E_FAILURE;
+
+	return aws_kit_store_index_update(key, flags, storeHead, offset, length);
+}
+
+/**
+ * \brief Build the RAM index from the sectors in the order they joined the log.
+ */
+static int aws_kit_store_mount(void)
+{
+	t_aws_store_sector_hdr hdr;
+	uint8_t i, sector;
+	uint32_t last = 0;
+
+	memset(storeIndex, 0, sizeof(storeIndex));
+	memset(storeSectors, 0, sizeof(storeSectors));
+	storeNextSequence = 1;
+
+	for (i = 0; i < AWS_STORE_SECTORS; i++) {
+		if (aws_kit_store_read(aws_kit_store_addr(i, 0), &hdr, sizeof(hdr)) != AWS_E_SUCCESS)
+			return AWS_E_FAILURE;
+		if (hdr.magic != AWS_STORE_SECTOR_MAGIC) {
+			storeSectors[i].state = AWS_STORE_SECTOR_DIRTY;
+			continue;
+		}
+		storeSectors[i].eraseCount = hdr.eraseCount;
+		if (hdr.sequence == AWS_STORE_ERASED && hdr.sequenceInv == AWS_STORE_ERASED) {
+			storeSectors[i].state = AWS_STORE_SECTOR_FREE;
+			storeSectors[i].used = sizeof(hdr);
+		} else if (hdr.sequence != ~hdr.sequenceInv) {
+			/* Torn while joining the log, nothing was written behind it. */
+			storeSectors[i].state = AWS_STORE_SECTOR_DIRTY;
+		} else {
+			storeSectors[i].state = AWS_STORE_SECTOR_ACTIVE;
+			storeSectors[i].sequence = hdr.sequence;
+		}
+	}
+
+	for (;;) {
+		sector = AWS_STORE_SECTORS;
+		for (i = 0; i < AWS_STORE_SECTORS; i++) {
+			if (storeSectors[i].state != AWS_STORE_SECTOR_ACTIVE || storeSectors[i].sequence <= last)
+				continue;
+			if (sector == AWS_STORE_SECTORS || storeSectors[i].sequence < storeSectors[sector].sequence)
+				sector = i;
+		}
+		if (sector == AWS_STORE_SECTORS)
+			break;
+
+		aws_kit_store_scan_sector(sector);
+		last = storeSectors[sector].sequence;
+		storeHead = sector;
+		storeNextSequence = last + 1;
+	}
+
+	if (!last && aws_kit_store_next_sector() != AWS_E_SUCCESS)
+		return AWS_E_FAILURE;
+
+	storeMounted = true;
+	return AWS_E_SUCCESS;
+}
+
+/**
+ * \brief Halt the ATWINC1500 to get at its SPI flash, and mount the store on first use.
+ *
+ * \return AWS_E_SUCCESS     On success
+ */
+int aws_kit_store_open(void)
+{
+	int ret = AWS_E_FAILURE;
+
+	do {
+		if (storeOpened) {
+			ret = AWS_E_SUCCESS;
+			break;
+		}
+
+		ret = m2m_wifi_download_mode();
+		if (ret != M2M_SUCCESS) {
+			AWS_ERROR("Failed to enter download mode!(%d)", ret);
+			ret = AWS_E_WIFI_INVALID;
+			break;
+		}
+		storeOpened = true;
+
+		spi_flash_enable(1);
+		if (spi_flash_get_size() < AWS_STORE_FLASH_MIN_MBIT) {
+			AWS_ERROR("Unexpected SPI flash size(%lu)", (unsigned long)spi_flash_get_size());
+			ret = AWS_E_FAILURE;
+			break;
+		}
+
+		ret = storeMounted ? AWS_E_SUCCESS : aws_kit_store_mount();
+		if (ret != AWS_E_SUCCESS) {
+			AWS_ERROR("Failed to mount store!(%d)", ret);
+			break;
+		}
+	} while(0);
+
+	return ret;
+}
+
+/**
+ * \brief Release the SPI flash and reset the ATWINC1500, so it boots its firmware on the next m2m_wifi_init().
+ */
+void aws_kit_store_close(void)
+{
+	if (!storeOpened)
+		return;
+
+	nm_drv_deinit(NULL);
+	nm_bsp_reset();
+	storeOpened = false;
+}
+
+/**
+ * \brief Read the value of a key.
+ *
+ * \param key[in]            Key identifier
+ * \param value[out]         Buffer to receive the value
+ * \param size[in]           Size of the buffer
+ * \param length[out]        Length of the value
+ * \return AWS_E_SUCCESS     On success, AWS_E_USER_DATA_INVALID if the key does not exist
+ */
+int aws_kit_store_get(uint8_t key, uint8_t *value, uint16_t size, uint16_t *length)
+{
+	t_aws_store_index *entry;
+
+	if (!storeOpened || !value || !length)
+		return AWS_E_BAD_PARAM;
+
+	entry = aws_kit_store_find(key);
+	if (!key || !entry)
+		return AWS_E_USER_DATA_INVALID;
+	if (entry->length > size)
+		return AWS_E_BAD_PARAM;
+
+	*length = entry->length;
+	return aws_kit_store_read(aws_kit_store_addr(entry->sector, entry->offset + sizeof(t_aws_store_record_hdr)),
+				value, entry->length);
+}
+
+/**
+ * \brief Write the value of a key. Nothing is written if the value did not change.
+ *
+ * \param key[in]            Key identifier
+ * \param value[in]          Value
+ * \param length[in]         Length of the value, up to AWS_STORE_VALUE_MAX
+ * \return AWS_E_SUCCESS     On success
+ */
+int aws_kit_store_set(uint8_t key, const uint8_t *value, uint16_t length)
+{
+	uint8_t chunk[AWS_STORE_COPY_CHUNK];
+	t_aws_store_index *entry;
+	uint32_t addr;
+	uint16_t done, size;
+
+	if (!storeOpened || !key || key == 0xFF || (!value && length) || length > AWS_STORE_VALUE_MAX)
+		return AWS_E_BAD_PARAM;
+
+	entry = aws_kit_store_find(key);
+	if (entry && entry->length == length) {
+		addr = aws_kit_store_addr(entry->sector, entry->offset + sizeof(t_aws_store_record_hdr));
+		for (done = 0; done < length; done += size) {
+			size = ((length - done) > sizeof(chunk)) ? sizeof(chunk) : (length - done);
+			if (aws_kit_store_read(addr + done, chunk, size) != AWS_E_SUCCESS || memcmp(chunk, &value[done], size))
+				break;
+		}
+		if (done >= length)
+			return AWS_E_SUCCESS;
+	} else if (!entry && !aws_kit_store_find(0)) {
+		AWS_ERROR("Store index is full");
+		return AWS_E_FAILURE;
+	}
+
+	return aws_kit_store_append(key, AWS_STORE_RECORD_LIVE, value, length);
+}
+
+/**
+ * \brief Remove a key from the store.
+ *
+ * \param key[in]            Key identifier
+ * \return AWS_E_SUCCESS     On success
+ */
+int aws_kit_store_delete(uint8_t key)
+{
+	if (!storeOpened || !key || key == 0xFF)
+		return AWS_E_BAD_PARAM;
+
+	if (!aws_kit_store_find(key))
+		return AWS_E_SUCCESS;
+
+	return aws_kit_store_append(key, AWS_STORE_RECORD_DELETED, NULL, 0);
+}
+
+/**
+ * \brief Check a key against the RAM index. This works while the store is closed.
+ *
+ * \param key[in]            Key identifier
+ * \return true if the key exists
+ */
+bool aws_kit_store_exists(uint8_t key)
+{
+	return (key && aws_kit_store_find(key) != NULL);
+}
+
+/**
+ * \brief Report the usage and the wear of the store.
+ *
+ * \param stats[out]         Usage of the store
+ */
+void aws_kit_store_get_stats(t_aws_store_stats *stats)
+{
+	uint8_t i;
+
+	memset(stats, 0, sizeof(t_aws_store_stats));
+	stats->minErase = AWS_STORE_ERASED;
+
+	for (i = 0; i < AWS_STORE_MAX_KEYS; i++) {
+		if (storeIndex[i].key) {
+			stats->keys++;
+			stats->liveBytes += sizeof(t_aws_store_record_hdr) + AWS_STORE_ALIGN(storeIndex[i].length);
+		}
+	}
+
+	for (i = 0; i < AWS_STORE_SECTORS; i++) {
+		if (storeSectors[i].eraseCount > stats->maxErase)
+			stats->maxErase = storeSectors[i].eraseCount;
+		if (storeSectors[i].eraseCount < stats->minErase)
+			stats->minErase = storeSectors[i].eraseCount;
+	}
+
+	if (storeMounted) {
+		stats->freeBytes = AWS_STORE_SECTOR_SIZE - storeSectors[storeHead].used;
+		if (aws_kit_store_free_sectors() > AWS_STORE_RESERVED_SECTORS)
+			stats->freeBytes += (aws_kit_store_free_sectors() - AWS_STORE_RESERVED_SECTORS) *
+				(AWS_STORE_SECTOR_SIZE - sizeof(t_aws_store_sector_hdr));
+	}
+}
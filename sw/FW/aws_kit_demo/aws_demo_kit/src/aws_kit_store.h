@@ -0,0 +1,113 @@
+/**
+ *
+ * \file
+ *
+ * \brief AWS IoT Demo kit persistent key/value store on the ATWINC1500 SPI flash.
+ *
+ * Copyright (c) 2014-2016 Atmel Corporation. All rights reserved.
+ *
+ * \asf_license_start
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ *    Atmel microcontroller product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \asf_license_stop
+ *
+ */
+
+#ifndef AWS_KIT_STORE_H_
+#define AWS_KIT_STORE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <asf.h>
+#include "spi_flash/include/spi_flash_map.h"
+
+/**
+ * \defgroup Log-structured key/value store kept in the application area of the ATWINC1500 SPI flash
+ *
+ * Records are only ever appended. A newer record for a key supersedes the older ones, and
+ * the oldest sector is compacted into the head of the log once the free sectors run out,
+ * so every sector of the area takes its turn being erased.
+ * The SPI flash is only reachable while the ATWINC1500 CPU is halted in download mode,
+ * so all accesses have to be bracketed by aws_kit_store_open() and aws_kit_store_close()
+ * from the task which owns the ATWINC1500, while WIFI is not initialized.
+ *
+ * @{
+ */
+
+/** \name Flash area used by the store
+   @{ */
+#define AWS_STORE_FLASH_OFFSET					(M2M_APP_4M_MEM_FLASH_OFFSET)
+#define AWS_STORE_SECTOR_SIZE					(FLASH_SECTOR_SZ)
+#define AWS_STORE_SECTORS						(M2M_APP_4M_MEM_FLASH_SZ / FLASH_SECTOR_SZ)
+#define AWS_STORE_RESERVED_SECTORS				(1)
+/** @} */
+
+/** \name Store limits
+   @{ */
+#define AWS_STORE_MAX_KEYS						(32)
+#define AWS_STORE_VALUE_MAX						(1024)
+/** @} */
+
+/** \name Key identifiers, 0x00 and 0xFF are reserved
+   @{ */
+#define AWS_STORE_KEY_HOST_ADDR					(0x01)
+#define AWS_STORE_KEY_CERT_SIGNER				(0x05)
+#define AWS_STORE_KEY_CERT_DEVICE				(0x06)
+#define AWS_STORE_KEY_PUB_QUEUE					(0x10)	/**< First of AWS_QUEUE_DEPTH keys. */
+/** @} */
+
+/** \brief Usage of the store, reported by aws_kit_store_get_stats(). */
+typedef struct {
+	uint32_t keys;			/**< Number of live keys. */
+	uint32_t liveBytes;		/**< Bytes held by the live records. */
+	uint32_t freeBytes;		/**< Bytes left before a compaction is needed. */
+	uint32_t maxErase;		/**< Highest erase count of a sector. */
+	uint32_t minErase;		/**< Lowest erase count of a sector. */
+} t_aws_store_stats;
+
+int aws_kit_store_open(void);
+void aws_kit_store_close(void);
+int aws_kit_store_get(uint8_t key, uint8_t *value, uint16_t size, uint16_t *length);
+int aws_kit_store_set(uint8_t key, const uint8_t *value, uint16_t length);
+int aws_kit_store_delete(uint8_t key);
+bool aws_kit_store_exists(uint8_t key);
+void aws_kit_store_get_stats(t_aws_store_stats *stats);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AWS_KIT_STORE_H_ */
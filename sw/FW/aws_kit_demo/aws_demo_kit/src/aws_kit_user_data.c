@@ -0,0 +1,301 @@
+/**
+ *
+ * \file
+ *
+ * \brief AWS IoT Demo kit RAM mirror of the user data in slot 8.
+ *
+ * Copyright (c) 2014-2016 Atmel Corporation. All rights reserved.
+ *
+ * \asf_license_start
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ *    Atmel microcontroller product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \asf_license_stop
+ *
+ */
+
+#include "aws_kit_user_data.h"
+#include "aws_kit_crypto.h"
+#include "aws_kit_debug.h"
+#include "cryptoauthlib.h"
+#include "tls/atcatls_cfg.h"
+
+//! Copy of the first blocks of slot 8
+static uint8_t userDataMirror[AWS_USER_DATA_MIRROR_SIZE];
+//! Whether the mirror has been read from the ATECC508A
+static volatile bool userDataLoaded = false;
+//! Words changed since the last write-back, one bit per word of each block
+static uint8_t userDataDirty[AWS_USER_DATA_BLOCKS];
+//! One-shot timer which starts the write-back
+static xTimerHandle userDataTimer = NULL;
+//! Background write-back request
+static t_aws_crypto_request userDataRequest;
+
+static int aws_kit_user_data_flush_work(void *arg)
+{
+	uint8_t block[AWS_USER_DATA_BLOCK_SIZE];
+	uint8_t dirty, count, word;
+	int ret = ATCA_SUCCESS, status;
+
+	for (uint8_t i = 0; i < AWS_USER_DATA_BLOCKS; i++) {
+		/* Take the dirty words and their values at once, words changed later are marked again. */
+		taskENTER_CRITICAL();
+		dirty = userDataDirty[i];
+		userDataDirty[i] = 0;
+		memcpy(block, &userDataMirror[i * AWS_USER_DATA_BLOCK_SIZE], sizeof(block));
+		taskEXIT_CRITICAL();
+
+		for (word = 0, count = 0; word < AWS_USER_DATA_WORDS_PER_BLOCK; word++) {
+			if (dirty & (1 << word))
+				count++;
+		}
+		if (count == 0)
+			continue;
+
+		/* One 32-byte write costs less than several 4-byte writes to the same block. */
+		if (count > 1) {
+			status = atcab_write_zone(ATCA_ZONE_DATA, TLS_SLOT8_ENC_STORE, i, 0, block, AWS_USER_DATA_BLOCK_SIZE);
+			if (status == ATCA_SUCCESS)
+				dirty = 0;
+		} else {
+			for (word = 0; word < AWS_USER_DATA_WORDS_PER_BLOCK; word++) {
+				if (!(dirty & (1 << word)))
+					continue;
+				status = atcab_write_zone(ATCA_ZONE_DATA, TLS_SLOT8_ENC_STORE, i, word,
+										  &block[word * AWS_USER_DATA_WORD_SIZE], AWS_USER_DATA_WORD_SIZE);
+				if (status != ATCA_SUCCESS)
+					break;
+				dirty &= ~(1 << word);
+			}
+		}
+
+		if (dirty) {
+			taskENTER_CRITICAL();
+			userDataDirty[i] |= dirty;
+			taskEXIT_CRITICAL();
+			if (ret == ATCA_SUCCESS)
+				ret = status;
+		}
+	}
+
+	return ret;
+}
+
+/**
+ * \brief Completion callback of the background write-back, run on the crypto service task.
+ *
+ * \param request[in]        Write-back request
+ */
+static void aws_kit_user_data_flushed(t_aws_crypto_request *request)
+{
+	if (request->status != ATCA_SUCCESS)
+		AWS_ERROR("Failed to write user data!(%d)", request->status);
+
+	/* Retry failed words and catch words changed while the timer could not queue another write-back. */
+	if (aws_kit_user_data_is_dirty() && !xTimerIsTimerActive(userDataTimer))
+		xTimerStart(userDataTimer, 0);
+}
+
+/**
+ * \brief Timer callback, queues the background write-back.
+ *
+ * \param timer[in]          Write-back timer
+ */
+static void aws_kit_user_data_timer(xTimerHandle timer)
+{
+	/* A queued write-back takes the words changed until it runs, its callback rearms the timer otherwise. */
+	if (userDataRequest.pending)
+		return;
+
+	/* The timer daemon must not block, retry later if the queue is full. */
+	if (aws_kit_crypto_try_submit(&userDataRequest, AWS_CRYPTO_PRIO_LOW, aws_kit_user_data_flush_work, NULL,
+								  aws_kit_user_data_flushed, NULL) != AWS_E_SUCCESS)
+		xTimerStart(userDataTimer, 0);
+}
+
+/**
+ * \brief Create the write-back timer.
+ */
+void aws_kit_user_data_init(void)
+{
+	memset(userDataMirror, 0, sizeof(userDataMirror));
+	memset(userDataDirty, 0, sizeof(userDataDirty));
+	memset(&userDataRequest, 0, sizeof(userDataRequest));
+	userDataLoaded = false;
+
+	userDataTimer = xTimerCreate((const signed char *) "UserData",
+								 AWS_USER_DATA_FLUSH_DELAY_MS / portTICK_RATE_MS,
+								 pdFALSE,
+								 NULL,
+								 aws_kit_user_data_timer);
+	if (userDataTimer == NULL)
+		AWS_ERROR("Failed to create user data timer");
+}
+
+/**
+ * \brief Read slot 8 into the mirror, unless it has been read already.
+ *
+ * \return AWS_E_SUCCESS     On success
+ */
+int aws_kit_user_data_load(void)
+{
+	uint8_t data[AWS_USER_DATA_MIRROR_SIZE];
+	int ret;
+
+	if (userDataLoaded)
+		return AWS_E_SUCCESS;
+
+	ret = aws_kit_crypto_read_bytes(ATCA_ZONE_DATA, TLS_SLOT8_ENC_STORE, 0x00, data, sizeof(data));
+	if (ret != ATCA_SUCCESS) {
+		AWS_ERROR("Failed to read user data!(%d)", ret);
+		return AWS_E_CRYPTO_FAILURE;
+	}
+
+	/* Another task may have loaded and changed the mirror meanwhile. */
+	taskENTER_CRITICAL();
+	if (!userDataLoaded) {
+		memcpy(userDataMirror, data, sizeof(userDataMirror));
+		memset(userDataDirty, 0, sizeof(userDataDirty));
+		userDataLoaded = true;
+	}
+	taskEXIT_CRITICAL();
+
+	return AWS_E_SUCCESS;
+}
+
+/**
+ * \brief Read user data from the mirror.
+ *
+ * \param offset[in]         Byte offset in slot 8
+ * \param data[out]          Buffer for the bytes
+ * \param length[in]         Number of bytes to read
+ * \return AWS_E_SUCCESS     On success
+ */
+int aws_kit_user_data_read(uint16_t offset, uint8_t *data, uint16_t length)
+{
+	int ret;
+
+	if (!data || offset + length > AWS_USER_DATA_OFFSET_MAX)
+		return AWS_E_BAD_PARAM;
+
+	ret = aws_kit_user_data_load();
+	if (ret != AWS_E_SUCCESS)
+		return ret;
+
+	taskENTER_CRITICAL();
+	memcpy(data, &userDataMirror[offset], length);
+	taskEXIT_CRITICAL();
+
+	return AWS_E_SUCCESS;
+}
+
+/**
+ * \brief Write user data to the mirror, and schedule the write-back of the changed words.
+ *
+ * Writing the value a word already holds costs nothing.
+ *
+ * \param offset[in]         Byte offset in slot 8
+ * \param data[in]           Bytes to write
+ * \param length[in]         Number of bytes to write
+ * \return AWS_E_SUCCESS     On success
+ */
+int aws_kit_user_data_write(uint16_t offset, const uint8_t *data, uint16_t length)
+{
+	bool changed = false;
+	uint16_t pos;
+	int ret;
+
+	if (!data || offset + length > AWS_USER_DATA_OFFSET_MAX)
+		return AWS_E_BAD_PARAM;
+
+	ret = aws_kit_user_data_load();
+	if (ret != AWS_E_SUCCESS)
+		return ret;
+
+	taskENTER_CRITICAL();
+	for (uint16_t i = 0; i < length; i++) {
+		pos = offset + i;
+		if (userDataMirror[pos] == data[i])
+			continue;
+		userDataMirror[pos] = data[i];
+		userDataDirty[pos / AWS_USER_DATA_BLOCK_SIZE] |= 1 << ((pos % AWS_USER_DATA_BLOCK_SIZE) / AWS_USER_DATA_WORD_SIZE);
+		changed = true;
+	}
+	taskEXIT_CRITICAL();
+
+	/* The delay runs from the first change, so steady changes cannot hold the write-back off. */
+	if (changed && userDataTimer && !xTimerIsTimerActive(userDataTimer))
+		xTimerStart(userDataTimer, 0);
+
+	return AWS_E_SUCCESS;
+}
+
+/**
+ * \brief Write the changed words back to slot 8 and wait for it.
+ *
+ * \return AWS_E_SUCCESS     On success
+ */
+int aws_kit_user_data_flush(void)
+{
+	int ret;
+
+	if (!aws_kit_user_data_is_dirty())
+		return AWS_E_SUCCESS;
+
+	ret = aws_kit_crypto_call(AWS_CRYPTO_PRIO_LOW, aws_kit_user_data_flush_work, NULL);
+	if (ret != ATCA_SUCCESS) {
+		AWS_ERROR("Failed to write user data!(%d)", ret);
+		return AWS_E_CRYPTO_FAILURE;
+	}
+
+	return AWS_E_SUCCESS;
+}
+
+/**
+ * \brief Check whether the mirror holds words which have not been written back.
+ *
+ * \return true              If a write-back is due
+ */
+bool aws_kit_user_data_is_dirty(void)
+{
+	bool dirty = false;
+
+	taskENTER_CRITICAL();
+	for (uint8_t i = 0; i < AWS_USER_DATA_BLOCKS; i++) {
+		if (userDataDirty[i]) {
+			dirty = true;
+			break;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return dirty;
+}
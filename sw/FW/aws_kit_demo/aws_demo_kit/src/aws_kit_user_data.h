@@ -0,0 +1,92 @@
+/**
+ *
+ * \file
+ *
+ * \brief AWS IoT Demo kit RAM mirror of the user data in slot 8.
+ *
+ * Copyright (c) 2014-2016 Atmel Corporation. All rights reserved.
+ *
+ * \asf_license_start
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ *    Atmel microcontroller product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \asf_license_stop
+ *
+ */
+
+#ifndef AWS_KIT_USER_DATA_H_
+#define AWS_KIT_USER_DATA_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <asf.h>
+#include "aws_kit_object.h"
+
+/**
+ * \defgroup RAM mirror of the user data kept in slot 8 of ATECC508A
+ *
+ * The user data is read from the ATECC508A once and served from RAM afterwards. Writes only
+ * update the mirror and mark the 4-byte words whose value has changed. The dirty words are
+ * written back by a background request of the crypto service, a while after the first change,
+ * so a burst of changes such as button presses costs one EEPROM write per word at most.
+ * A block with several dirty words is written as a single 32-byte write, other words as
+ * 4-byte writes. Callers which need the data on the device right away, provisioning or
+ * a reset, call aws_kit_user_data_flush().
+ *
+ * @{
+ */
+
+/** \name User data mirror configuration
+   @{ */
+#define AWS_USER_DATA_FLUSH_DELAY_MS			(5000)	/**< Delay from the first change to the write-back. */
+#define AWS_USER_DATA_WORD_SIZE					(4)
+#define AWS_USER_DATA_BLOCK_SIZE				(32)
+#define AWS_USER_DATA_WORDS_PER_BLOCK			(AWS_USER_DATA_BLOCK_SIZE / AWS_USER_DATA_WORD_SIZE)
+#define AWS_USER_DATA_BLOCKS					((AWS_USER_DATA_OFFSET_MAX + AWS_USER_DATA_BLOCK_SIZE - 1) / AWS_USER_DATA_BLOCK_SIZE)
+#define AWS_USER_DATA_MIRROR_SIZE				(AWS_USER_DATA_BLOCKS * AWS_USER_DATA_BLOCK_SIZE)	/**< Whole blocks of slot 8. */
+/** @} */
+
+void aws_kit_user_data_init(void);
+int aws_kit_user_data_load(void);
+int aws_kit_user_data_read(uint16_t offset, uint8_t *data, uint16_t length);
+int aws_kit_user_data_write(uint16_t offset, const uint8_t *data, uint16_t length);
+int aws_kit_user_data_flush(void);
+bool aws_kit_user_data_is_dirty(void);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AWS_KIT_USER_DATA_H_ */
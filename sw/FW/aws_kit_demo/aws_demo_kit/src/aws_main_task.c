@@ -48,8 +48,14 @@
 #include "aws_main_task.h"
 #include "aws_net_interface.h"
 #include "aws_kit_debug.h"
+#include "aws_kit_clock.h"
+#include "aws_kit_store.h"
+#include "aws_kit_queue.h"
+#include "aws_kit_crypto.h"
+#include "aws_kit_user_data.h"
 #include "cryptoauthlib.h"
 #include "tls/atcatls_cfg.h"
+#include "atcacert/atcacert_client.h"
 #include "atecc508cb.h"
 
 //! Handle for about Main task
@@ -92,24 +98,20 @@ int aws_main_wait_notification(t_aws_kit* kit)
 }
 
 /**
- * \brief Build certificates.
- *
- * Now that both signer and device certificate was saved onto specified slot with certificate definition,
- * Both certificates can be built based on certificate definition in order to pass them to TLS library.
+ * \brief Initialize the ATECC508A, run on the crypto service task.
  *
- * \param kit[inout]        Pointer to an instance of AWS Kit
+ * \param arg[inout]        Pointer to an instance of AWS Kit
  * \return AWS_E_SUCCESS    On success
  */
-int aws_main_init_kit(t_aws_kit* kit)
+static int aws_main_init_crypto(void* arg)
 {
+	t_aws_kit* kit = (t_aws_kit*)arg;
 	int ret = AWS_E_FAILURE;
 	bool lockstate = false;
 	uint8_t revision[INFO_SIZE];
 
 	do {
 
-		kit->errState = AWS_EX_NONE;
-
 		/* Initialize CryptoAuthLib to communicate with ATECC508A over I2C interface. */
 		cfg_ateccx08a_i2c_default.atcai2c.slave_address = DEVICE_I2C;
 		atcab_init( &cfg_ateccx08a_i2c_default );
@@ -164,6 +166,40 @@ int aws_main_init_kit(t_aws_kit* kit)
 			break;
 		}
 
+		/* Seed the random numbers of TLS from ATECC508A, personalized with its serial number. */
+		ret = atca_tls_init_random(kit->user.clientID, kit->user.clientIDLen);
+		if (ret != ATCA_SUCCESS) {
+			AWS_ERROR("Failed to seed random number generator!(%d)", ret);
+			ret = AWS_E_CRYPTO_FAILURE;
+			break;
+		}
+
+	} while(0);
+
+	return ret;
+}
+
+/**
+ * \brief Build certificates.
+ *
+ * Now that both signer and device certificate was saved onto specified slot with certificate definition,
+ * Both certificates can be built based on certificate definition in order to pass them to TLS library.
+ *
+ * \param kit[inout]        Pointer to an instance of AWS Kit
+ * \return AWS_E_SUCCESS    On success
+ */
+int aws_main_init_kit(t_aws_kit* kit)
+{
+	int ret = AWS_E_FAILURE;
+
+	do {
+
+		kit->errState = AWS_EX_NONE;
+
+		/* Check the ATECC508A and read its serial number on the crypto service task. */
+		ret = aws_kit_crypto_call(AWS_CRYPTO_PRIO_NORMAL, aws_main_init_crypto, kit);
+		if (ret != AWS_E_SUCCESS) break;
+
 		/* initialize IOs bewteen ATSAMG55 and ATWINC1500. */
 		ret = nm_bsp_init();
 		if (ret != M2M_SUCCESS) {
@@ -172,6 +208,26 @@ int aws_main_init_kit(t_aws_kit* kit)
 			break;
 		}
 
+		/* Mount the key/value store while WIFI is still down, a failure only costs the persisted caches. */
+		if (aws_kit_store_open() == AWS_E_SUCCESS) {
+			t_aws_store_stats stats;
+			aws_kit_store_get_stats(&stats);
+			AWS_INFO("Store: %lu keys, %lu bytes used, %lu bytes free, erase count %lu~%lu", stats.keys,
+				stats.liveBytes, stats.freeBytes, stats.minErase, stats.maxErase);
+			/* Messages which could not be published before the last reset go out first. */
+			aws_kit_queue_restore();
+			/* The last address of the host stands in if the DNS server does not answer. */
+			aws_net_load_host_cache();
+			/* Build the certificates while they can be taken from or cached in the store.
+			   Without compressed certificates yet, they are built again after provisioning. */
+			if (aws_main_build_certificate(kit) != AWS_E_SUCCESS)
+				AWS_WARN("Certificates are not available yet");
+		} else {
+			AWS_WARN("Key/value store is not available");
+		}
+		aws_kit_store_close();
+		ret = AWS_E_SUCCESS;
+
 		/* initialize flags. */
 		kit->quitMQTT = false;
 		kit->blocking = false;
@@ -182,54 +238,137 @@ int aws_main_init_kit(t_aws_kit* kit)
 	return ret;
 }
 
+//! Digest of the ATECC508A data the certificates in the kit instance were built from
+static uint8_t mainCertDigest[ATCERT_DIGEST_SIZE];
+//! Whether the kit instance holds certificates matching mainCertDigest
+static bool mainCertBuilt = false;
+
 /**
- * \brief Build certificates.
+ * \brief Load a DER certificate cached in the store.
  *
- * Now that both signer and device certificate was saved onto specified slot with certificate definition,
- * Both certificates can be built based on certificate definition in order to pass them to TLS library.
+ * The cached value is the certificate digest followed by the DER certificate,
+ * so a certificate of other compressed data or another device is never used.
  *
- * \param kit[inout]        Pointer to an instance of AWS Kit
+ * \param key[in]            Store key of the certificate
+ * \param digest[in]         Digest of the current certificate data
+ * \param buf[out]           Buffer for the digest and the DER certificate
+ * \param derLen[out]        Length of the DER certificate
+ * \return AWS_E_SUCCESS     On success
+ */
+static int aws_main_load_certificate(uint8_t key, const uint8_t* digest, uint8_t* buf, uint32_t* derLen)
+{
+	uint16_t length = 0;
+
+	if (aws_kit_store_get(key, buf, ATCERT_DIGEST_SIZE + DER_CERT_INIT_SIZE, &length) != AWS_E_SUCCESS)
+		return AWS_E_FAILURE;
+	if (length <= ATCERT_DIGEST_SIZE || memcmp(buf, digest, ATCERT_DIGEST_SIZE) != 0)
+		return AWS_E_FAILURE;
+
+	*derLen = length - ATCERT_DIGEST_SIZE;
+	return AWS_E_SUCCESS;
+}
+
+/**
+ * \brief Build certificates, run while the ATECC508A is held through the crypto service.
+ *
+ * \param arg[inout]        Pointer to an instance of AWS Kit
  * \return AWS_E_SUCCESS    On success
  */
-int aws_main_build_certificate(t_aws_kit* kit)
+static int aws_main_build_certificate_work(void* arg)
 {
+	t_aws_kit* kit = (t_aws_kit*)arg;
 	int ret = AWS_E_FAILURE;
 	t_atcert cert;
+	atcacert_tm_utc_t issueDate;
+	uint8_t digest[ATCERT_DIGEST_SIZE];
+	uint8_t* signerBuf = NULL;
+	uint8_t* deviceBuf = NULL;
+	bool cached;
+	uint32_t startTick;
 
-	/* Allocate heap to obtain signer DER, PEM certificates and public key space. */
-	cert.signer_der = (uint8_t*)malloc(DER_CERT_INIT_SIZE);
-	if (cert.signer_der == NULL) goto free_cert;
-	cert.signer_der_size = DER_CERT_INIT_SIZE;
+	memset(&cert, 0x00, sizeof(cert));
+
+	ret = atca_tls_get_cert_digest(digest);
+	if (ret != ATCA_SUCCESS) {
+		ret = AWS_E_CRYPTO_CERT_FAILURE;
+		AWS_ERROR("Failed to read certificate data!(%d)", ret);
+		return ret;
+	}
+	if (mainCertBuilt && memcmp(digest, mainCertDigest, sizeof(digest)) == 0)
+		return AWS_E_SUCCESS;
+	mainCertBuilt = false;
+
+	/* Allocate heap to obtain DER, PEM certificates and public key space. DER certificates follow the digest. */
+	ret = AWS_E_FAILURE;
+	signerBuf = (uint8_t*)malloc(ATCERT_DIGEST_SIZE + DER_CERT_INIT_SIZE);
+	if (signerBuf == NULL) goto free_cert;
+	cert.signer_der = &signerBuf[ATCERT_DIGEST_SIZE];
 	cert.signer_pem = (uint8_t*)malloc(PEM_CERT_INIT_SIZE);
 	if (cert.signer_pem == NULL) goto free_cert;
 	cert.signer_pem_size = PEM_CERT_INIT_SIZE;
 	cert.signer_pubkey= (uint8_t*)malloc(ATCERT_PUBKEY_SIZE);
 	if (cert.signer_pubkey == NULL) goto free_cert;
 
-	/* Build signer certificate */
-	ret = atca_tls_build_signer_cert(&cert);
-	if (ret != ATCA_SUCCESS) {
-		ret = AWS_E_CRYPTO_CERT_FAILURE;
-		AWS_ERROR("Failed to build signer certificate!(%d)", ret);
-		goto free_cert; 
-	}
-
-	/* Allocate heap to secure device DER, PEM certificates and public key space. */
-	cert.device_der = (uint8_t*)malloc(DER_CERT_INIT_SIZE);
-	if (cert.device_der == NULL) goto free_cert;
-	cert.device_der_size = DER_CERT_INIT_SIZE;
+	deviceBuf = (uint8_t*)malloc(ATCERT_DIGEST_SIZE + DER_CERT_INIT_SIZE);
+	if (deviceBuf == NULL) goto free_cert;
+	cert.device_der = &deviceBuf[ATCERT_DIGEST_SIZE];
 	cert.device_pem = (uint8_t*)malloc(PEM_CERT_INIT_SIZE);
 	if (cert.device_pem == NULL) goto free_cert;
 	cert.device_pem_size = PEM_CERT_INIT_SIZE;
 	cert.device_pubkey= (uint8_t*)malloc(ATCERT_PUBKEY_SIZE);
 	if (cert.device_pubkey == NULL) goto free_cert;
 
-	/* Build device certificate. */
-	ret = atca_tls_build_device_cert(&cert);
-	if (ret != ATCA_SUCCESS) {
-		ret = AWS_E_CRYPTO_CERT_FAILURE;
-		AWS_ERROR("Failed to build device certificate!(%d)", ret);
-		goto free_cert; 
+	/* Both certificates have to be cached for the current digest to skip the rebuild. */
+	cached = aws_main_load_certificate(AWS_STORE_KEY_CERT_SIGNER, digest, signerBuf, &cert.signer_der_size) == AWS_E_SUCCESS
+			&& aws_main_load_certificate(AWS_STORE_KEY_CERT_DEVICE, digest, deviceBuf, &cert.device_der_size) == AWS_E_SUCCESS;
+
+	if (cached) {
+		ret = atcacert_encode_pem_cert(cert.signer_der, cert.signer_der_size, (char*)cert.signer_pem, (size_t*)&cert.signer_pem_size);
+		if (ret == ATCACERT_E_SUCCESS)
+			ret = atcacert_encode_pem_cert(cert.device_der, cert.device_der_size, (char*)cert.device_pem, (size_t*)&cert.device_pem_size);
+		if (ret != ATCACERT_E_SUCCESS) {
+			ret = AWS_E_CRYPTO_CERT_FAILURE;
+			AWS_ERROR("Failed to convert cached certificates!(%d)", ret);
+			goto free_cert;
+		}
+		AWS_INFO("Certificates loaded from the store");
+	} else {
+		cert.signer_der_size = DER_CERT_INIT_SIZE;
+		cert.device_der_size = DER_CERT_INIT_SIZE;
+
+		/* Build signer certificate */
+		startTick = rtt_read_timer_value(RTT);
+		ret = atca_tls_build_signer_cert(&cert);
+		if (ret != ATCA_SUCCESS) {
+			ret = AWS_E_CRYPTO_CERT_FAILURE;
+			AWS_ERROR("Failed to build signer certificate!(%d)", ret);
+			goto free_cert;
+		}
+		AWS_INFO("Signer certificate built in %lu ms", rtt_read_timer_value(RTT) - startTick);
+
+		/* Build device certificate. */
+		startTick = rtt_read_timer_value(RTT);
+		ret = atca_tls_build_device_cert(&cert);
+		if (ret != ATCA_SUCCESS) {
+			ret = AWS_E_CRYPTO_CERT_FAILURE;
+			AWS_ERROR("Failed to build device certificate!(%d)", ret);
+			goto free_cert;
+		}
+		AWS_INFO("Device certificate built in %lu ms", rtt_read_timer_value(RTT) - startTick);
+
+		/* Cache both DER certificates behind their digest, this fails quietly when the store is closed. */
+		memcpy(signerBuf, digest, ATCERT_DIGEST_SIZE);
+		memcpy(deviceBuf, digest, ATCERT_DIGEST_SIZE);
+		if (aws_kit_store_set(AWS_STORE_KEY_CERT_SIGNER, signerBuf, ATCERT_DIGEST_SIZE + cert.signer_der_size) == AWS_E_SUCCESS
+			&& aws_kit_store_set(AWS_STORE_KEY_CERT_DEVICE, deviceBuf, ATCERT_DIGEST_SIZE + cert.device_der_size) == AWS_E_SUCCESS)
+			AWS_INFO("Certificates cached in the store");
+	}
+
+	/* The device certificate cannot have been issued in the future, use its date as a lower bound of the wall clock. */
+	if (atca_tls_get_device_issue_date(&cert, &issueDate) == ATCA_SUCCESS) {
+		if (aws_kit_clock_set_floor(aws_kit_clock_mktime(issueDate.tm_year + 1900, issueDate.tm_mon + 1, issueDate.tm_mday,
+														 issueDate.tm_hour, issueDate.tm_min, issueDate.tm_sec)))
+			AWS_INFO("Wall clock moved forward to the certificate issue date");
 	}
 
 	/* Copy both PEM certificates to corresponding fields to be used for TLS library. */
@@ -238,18 +377,51 @@ int aws_main_build_certificate(t_aws_kit* kit)
 	kit->cert.devCertLen = cert.device_pem_size;
 	memcpy(kit->cert.devCert, cert.device_pem, kit->cert.devCertLen);
 
+	memcpy(mainCertDigest, digest, sizeof(digest));
+	mainCertBuilt = true;
+	ret = AWS_E_SUCCESS;
+
 	/* Release temporary heap region */
 free_cert:
-	if (cert.signer_der) free(cert.signer_der);
+	if (signerBuf) free(signerBuf);
 	if (cert.signer_pem) free(cert.signer_pem);
 	if (cert.signer_pubkey) free(cert.signer_pubkey);
-	if (cert.device_der) free(cert.device_der);
+	if (deviceBuf) free(deviceBuf);
 	if (cert.device_pem) free(cert.device_pem);
 	if (cert.device_pubkey) free(cert.device_pubkey);
 
 	return ret;
 }
 
+/**
+ * \brief Build certificates.
+ *
+ * Now that both signer and device certificate was saved onto specified slot with certificate definition,
+ * Both certificates can be built based on certificate definition in order to pass them to TLS library.
+ * A digest of the serial number and the compressed certificate data is checked first. Nothing is done
+ * if the kit already holds certificates for it, and DER certificates cached in the store for the same
+ * digest are used instead of rebuilding them. Rebuilt certificates are cached while the store is open.
+ *
+ * The ATECC508A is held through the crypto service, the certificates are built on the stack of the caller.
+ *
+ * \param kit[inout]        Pointer to an instance of AWS Kit
+ * \return AWS_E_SUCCESS    On success
+ */
+int aws_main_build_certificate(t_aws_kit* kit)
+{
+	t_aws_crypto_request request;
+	int ret;
+
+	ret = aws_kit_crypto_acquire(&request, AWS_CRYPTO_PRIO_NORMAL);
+	if (ret != AWS_E_SUCCESS)
+		return ret;
+
+	ret = aws_main_build_certificate_work(kit);
+	aws_kit_crypto_release(&request);
+
+	return ret;
+}
+
 /**
  * \brief User data initialization.
  *
@@ -268,18 +440,19 @@ int aws_main_reset_user_data(t_aws_kit* kit)
 
 		memset(userData, 0x00, sizeof(userData));
 		/* Write zero values to slot8 of ATECC508A to reset all user data. */
-		ret = atcab_write_bytes_zone(ATCA_ZONE_DATA, TLS_SLOT8_ENC_STORE, 0, &userData[0], sizeof(userData));
-		if (ret != ATCA_SUCCESS) {
-			ret = AWS_E_CRYPTO_FAILURE;
+		ret = aws_kit_user_data_write(0, &userData[0], sizeof(userData));
+		if (ret != AWS_E_SUCCESS)
 			break;
-		}
 
 		/* Write zero values to slot8 of ATECC508A to reset button state. */
-		ret = atcab_write_bytes_zone(ATCA_ZONE_DATA, TLS_SLOT8_ENC_STORE, AWS_USER_DATA_BUTTON_STATE, &userData[0], 4);
-		if (ret != ATCA_SUCCESS) {
-			ret = AWS_E_CRYPTO_FAILURE;
+		ret = aws_kit_user_data_write(AWS_USER_DATA_BUTTON_STATE, &userData[0], 4);
+		if (ret != AWS_E_SUCCESS)
+			break;
+
+		/* The kit is reset next, write the changed words back now. */
+		ret = aws_kit_user_data_flush();
+		if (ret != AWS_E_SUCCESS)
 			break;
-		}
 
 	} while(0);
 
@@ -304,11 +477,10 @@ int aws_main_check_kit_state(t_aws_kit* kit)
 	do {
 
 		memset(userData, 0x00, sizeof(userData));
-		/* Read a bunch of user data from slot8 of ATECC508A. */
-		ret = atcab_read_bytes_zone(ATCA_ZONE_DATA, TLS_SLOT8_ENC_STORE, 0x00, userData, sizeof(userData));
-		if (ret != ATCA_SUCCESS) {
+		/* Read a bunch of user data from slot8 of ATECC508A, it is only read from the device once. */
+		ret = aws_kit_user_data_read(0x00, userData, sizeof(userData));
+		if (ret != AWS_E_SUCCESS) {
 			AWS_ERROR("Failed to get user data!(%d)", ret);
-			ret = AWS_E_CRYPTO_FAILURE;
 			break;
 		}
 
@@ -353,20 +525,13 @@ int aws_main_check_kit_state(t_aws_kit* kit)
 			if (ret != AWS_E_SUCCESS) break;
 		}
 
-		/* Get time information from NTP server. 
-		   If a WIFI router cannot get to connect the server, reboot device. */
-		if (aws_net_get_ntp_seconds() <= 0) {
-			ret = aws_net_get_time(kit);
-			if (ret != AWS_E_SUCCESS) {
-				AWS_ERROR("Reset kit to reconnect to router to get correct Time info!(%d)", ret);
-				aws_kit_software_reset();
-				// Never come back here
-			}
-		}
-
-		/* Build signer & device certificates to be set for TLS library. */
+		/* Build signer & device certificates to be set for TLS library. 
+		   The wall clock comes from the RTC, raised to the device certificate issue date if it is behind.
+		   NTP runs in the background since DHCP, so boot does not wait for it. */
 		ret = aws_main_build_certificate(kit);
 		if (ret != AWS_E_SUCCESS) break;
+		if (aws_kit_clock_get_source() != AWS_CLOCK_SOURCE_NTP)
+			AWS_WARN("Wall clock not synchronized yet, using %lu", aws_kit_clock_get());
 #ifdef AWS_KIT_DEBUG
 		AWS_INFO("SSID : %s, PWD : %s", kit->user.ssid, kit->user.psk);
 #endif
@@ -496,6 +661,14 @@ void aws_main_task(void* params)
  */
 void aws_demo_tasks_init(void)
 {
+	/* Create the publish queue before any task can push to it. */
+	aws_kit_queue_init();
+
+	/* Create Crypto task before any task can hand ATECC508A work to it. */
+	aws_kit_crypto_init();
+
+	/* Create the write-back timer of the slot 8 mirror. */
+	aws_kit_user_data_init();
 
 	/* Create Main task to initialize ATECC508 and ATWINC1500. */
 	xTaskCreate(aws_main_task,
@@ -47,15 +47,34 @@
 #include "socket/include/socket.h"
 #include "aws_net_interface.h"
 #include "aws_kit_debug.h"
+#include "network_interface.h"
+#include "aws_kit_clock.h"
+#include "aws_kit_store.h"
 
 uint16_t tcp_socket_status = 0;
 uint16_t tcp_ntp_socket_status = 0;
 static bool gIsWifiConnected = false;
 static SOCKET gNtpSocket = -1;
-static t_time_date curr_time_date;
-static time_t gSecSince1900 = 0;
-static uint8_t ntp_dns_address[HOSTNAME_MAX_SIZE];
+static uint8_t ntp_packet[AWS_NET_NTP_PACKET_SIZE];
+static const char* ntp_servers[] = {
+	MAIN_WORLDWIDE_NTP_POOL_HOSTNAME,
+	AWS_NET_NTP_SERVER_2,
+	AWS_NET_NTP_SERVER_3
+};
+
+/** \brief Asynchronous NTP client context. */
+static struct {
+	uint8_t		state;
+	uint8_t		server;
+	uint32_t	sendTick;
+	Timer		timer;
+} gNtp;
 static uint32_t hostAddress = 0;
+/** \brief Last address the MQTT host resolved to, kept in the key/value store across resets. */
+static struct {
+	uint32_t	addr;
+	uint8_t		host[AWS_HOST_ADDR_MAX];
+} gHostCache;
 tstrSocketRecvMsg *pstrRecv = NULL;
 
 /**
@@ -156,8 +175,8 @@ void aws_net_wifi_cb(uint8_t u8MsgType, void* pvMsg)
 			uint8_t *pu8IPAddress = (uint8_t *)pvMsg;
 			aws_net_set_wifi_status(M2M_WIFI_CONNECTED);
 			AWS_INFO("M2M_WIFI_REQ_DHCP_CONF: IP is %u.%u.%u.%u", pu8IPAddress[0], pu8IPAddress[1], pu8IPAddress[2], pu8IPAddress[3]);
-			memcpy(ntp_dns_address, (uint8_t *)MAIN_WORLDWIDE_NTP_POOL_HOSTNAME, strlen(MAIN_WORLDWIDE_NTP_POOL_HOSTNAME));
-			gethostbyname((uint8_t *)ntp_dns_address);
+			/* Keep the wall clock in step in the background, nobody waits for it. */
+			aws_net_ntp_start();
 			break;
 		}
 
@@ -194,6 +213,7 @@ int aws_net_init_wifi(t_aws_kit* kit, int timeout_sec)
 
 		/* Initialize socket module. */
 		network_socket_init();
+		registerSocketCallback(aws_net_socket_cb, aws_net_dns_resolve_cb);
 
 		/* Connect to router. */
 		ret = m2m_wifi_connect((char *)kit->user.ssid, kit->user.ssidLen, MAIN_WLAN_AUTH, 
@@ -221,34 +241,6 @@ int aws_net_init_wifi(t_aws_kit* kit, int timeout_sec)
 	return ret;
 }
 
-/**
- * \brief Get current time using Network Time Protocol.
- *
- * \param kit[in]            Not used
- * \return AWS_E_SUCCESS     On success
- */
-int aws_net_get_time(t_aws_kit* kit)
-{
-	int ret = AWS_E_FAILURE;
-
-	/* Set both socket and resolve callbacks. */
-	registerSocketCallback(aws_net_ntp_socket_cb, aws_net_ntp_resolve_cb);
-	if (aws_net_get_ntp_socket() < 0) {
-		/* Get current time in 5 seconds over UDP. */
-		ret = aws_net_get_ntp_time(AWS_NET_NTP_TIMEOUT_MS);
-		if (ret != AWS_E_SUCCESS) {
-			AWS_ERROR("Failed to get time and date!(%d)", ret);
-			ret = AWS_E_NET_SOCKET_INVALID;
-		}
-	} else {
-		ret = AWS_E_NET_SOCKET_INVALID;
-		aws_net_set_ntp_socket((SOCKET)-1);
-		AWS_ERROR("Failed to get NTP socket!(%d)", ret);
-	}
-
-	return ret;
-}
-
 /**
  * \brief Main interface bewteen application and ATWINC1500 driver.
  *
@@ -258,6 +250,12 @@ int aws_net_get_time(t_aws_kit* kit)
  */
 void aws_net_socket_cb(SOCKET sock, uint8_t u8Msg, void *pvMsg)
 {
+	/* The NTP client shares the socket callback with the MQTT connection. */
+	if (sock >= 0 && sock == aws_net_get_ntp_socket()) {
+		aws_net_ntp_socket_cb(sock, u8Msg, pvMsg);
+		return;
+	}
+
 	AWS_INFO("Socket Event : %s", aws_net_get_socket_string(u8Msg));
 	switch (u8Msg) {
 		case SOCKET_MSG_BIND:
@@ -324,6 +322,7 @@ void aws_net_socket_cb(SOCKET sock, uint8_t u8Msg, void *pvMsg)
 		case SOCKET_MSG_SEND:
 		{
 			sint16 sent_size = *(sint16*)pvMsg;
+			network_socket_send_done(sent_size);
 			if (sent_size > 0) {
 				ENABLE_SOCKET_STATUS(SOCKET_STATUS_SEND);
 			} else {
@@ -359,11 +358,12 @@ SOCKET aws_net_get_ntp_socket(void)
 }
 
 /**
- * \brief Set local time and date came from the NTP server.
+ * \brief Convert seconds since the Unix epoch to time and date.
  *
- * \param secsSince1900[in]  Unix time
+ * \param secs[in]           Unix time
+ * \param tm[out]            Time and date, tm_year is the full year and tm_mon starts at 1
  */
-int aws_net_set_current_time(uint32_t secsSince1900)
+static void aws_net_epoch_to_date(time_t secs, t_time_date* tm)
 {
     #define YEAR0          1900
     #define EPOCH_YEAR     1970
@@ -371,8 +371,6 @@ int aws_net_set_current_time(uint32_t secsSince1900)
     #define LEAPYEAR(year) (!((year) % 4) && (((year) % 100) || !((year) %400)))
     #define YEARSIZE(year) (LEAPYEAR(year) ? 366 : 365)
 
-    int ret = 0;
-    time_t secs = secsSince1900;
     unsigned long dayclock, dayno;
     int year = EPOCH_YEAR;
     static const int _ytab[2][12] =
@@ -381,42 +379,53 @@ int aws_net_set_current_time(uint32_t secsSince1900)
         {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31}
     };
 
-	gSecSince1900 = secs;
     dayclock = (unsigned long)secs % SECS_DAY;
     dayno    = (unsigned long)secs / SECS_DAY;
 
-    curr_time_date.tm_sec  = (int) dayclock % 60;
-    curr_time_date.tm_min  = (int)(dayclock % 3600) / 60;
-    curr_time_date.tm_hour = (int) dayclock / 3600;
-    curr_time_date.tm_wday = (int) (dayno + 4) % 7;        /* day 0 a Thursday */
+    tm->tm_sec  = (int) dayclock % 60;
+    tm->tm_min  = (int)(dayclock % 3600) / 60;
+    tm->tm_hour = (int) dayclock / 3600;
+    tm->tm_wday = (int) (dayno + 4) % 7;        /* day 0 a Thursday */
 
     while(dayno >= (unsigned long)YEARSIZE(year)) {
         dayno -= YEARSIZE(year);
         year++;
     }
 
-    curr_time_date.tm_year = year - YEAR0;
-    curr_time_date.tm_yday = (int)dayno;
-    curr_time_date.tm_mon  = 0;
+    tm->tm_year = year - YEAR0;
+    tm->tm_yday = (int)dayno;
+    tm->tm_mon  = 0;
 
-    while(dayno >= (unsigned long)_ytab[LEAPYEAR(year)][curr_time_date.tm_mon]) {
-        dayno -= _ytab[LEAPYEAR(year)][curr_time_date.tm_mon];
-        curr_time_date.tm_mon++;
+    while(dayno >= (unsigned long)_ytab[LEAPYEAR(year)][tm->tm_mon]) {
+        dayno -= _ytab[LEAPYEAR(year)][tm->tm_mon];
+        tm->tm_mon++;
     }
 
-    curr_time_date.tm_mday  = (int)++dayno;
-    curr_time_date.tm_isdst = 0;
+    tm->tm_mday  = (int)++dayno;
+    tm->tm_isdst = 0;
 
-    curr_time_date.tm_year += 1900;
-    curr_time_date.tm_mon += 1;
+    tm->tm_year += 1900;
+    tm->tm_mon += 1;
+}
 
-	AWS_INFO("Date of Today : %d / %d / %d", curr_time_date.tm_year, curr_time_date.tm_mon, curr_time_date.tm_mday);
-    return ret;
+/**
+ * \brief Set local time and date, and keep it in the RTC across resets.
+ *
+ * \param secs[in]           Unix time
+ */
+int aws_net_set_current_time(uint32_t secs)
+{
+	t_time_date today;
 
+	aws_kit_clock_set(secs, 0, AWS_CLOCK_SOURCE_NTP);
+	aws_net_epoch_to_date(secs, &today);
+
+	AWS_INFO("Date of Today : %d / %d / %d", today.tm_year, today.tm_mon, today.tm_mday);
+	return 0;
 }
 
 /**
- * \brief Assign received time and date to out param.
+ * \brief Assign current time and date to out param.
  *
  * \param t_time_date[out]   For WolfSSL to check the date validity in certificate
  * \return zero
@@ -430,70 +439,110 @@ int aws_net_get_current_time(t_time_date* tm)
 		return -1;
 	} 
 
-	tm->tm_year = curr_time_date.tm_year;
-	tm->tm_mon = curr_time_date.tm_mon;
-	tm->tm_mday = curr_time_date.tm_mday;
-	tm->tm_hour = curr_time_date.tm_hour;
-	tm->tm_min = curr_time_date.tm_min;
-	tm->tm_sec = curr_time_date.tm_sec;
+	aws_net_epoch_to_date(aws_kit_clock_get(), tm);
 
 	return ret;
 }
 
 /**
- * \brief Return current seconds received from NTP server.
+ * \brief Return current seconds since the Unix epoch, kept by the RTC.
  *
- * \return the seconds
+ * \return the seconds, zero if the wall clock is unknown
  */
 time_t aws_net_get_ntp_seconds(void)
 {
-	return gSecSince1900;
+	return aws_kit_clock_get();
 }
 
 /**
- * \brief Wait for socket event to get current date from NTP server.
- *
- * \param timeout_ms[in]     Wait until input milliseconds
- * \return AWS_E_SUCCESS     On success
+ * \brief Move on to the next NTP server, or give up until the retry interval.
+ */
+static void aws_net_ntp_next_server(void)
+{
+	if (++gNtp.server < sizeof(ntp_servers) / sizeof(ntp_servers[0])) {
+		gNtp.state = AWS_NET_NTP_STATE_RESOLVE;
+		TimerCountdownMS(&gNtp.timer, AWS_NET_NTP_TIMEOUT_MS);
+		gethostbyname((uint8_t *)ntp_servers[gNtp.server]);
+		return;
+	}
+
+	AWS_WARN("No NTP server answered, retry in %d seconds", AWS_NET_NTP_RETRY_SEC);
+	close(aws_net_get_ntp_socket());
+	aws_net_set_ntp_socket((SOCKET)-1);
+	gNtp.state = AWS_NET_NTP_STATE_WAIT;
+	TimerCountdown(&gNtp.timer, AWS_NET_NTP_RETRY_SEC);
+}
+
+/**
+ * \brief Start an asynchronous time synchronization, trying each NTP server in turn.
+ * Nothing waits for it, the result is written into the RTC when a server answers.
  */
-int aws_net_get_ntp_time(uint32_t timeout_ms)
+void aws_net_ntp_start(void)
 {
-	int ret = AWS_E_SUCCESS;
 	SOCKET ntp_socket = -1;
 	struct sockaddr_in addr;
-	Timer ntpTimer;
 
+	if (gNtp.state == AWS_NET_NTP_STATE_RESOLVE || gNtp.state == AWS_NET_NTP_STATE_QUERY)
+		return;
+
+	TimerInit(&gNtp.timer);
 	ntp_socket = socket(AF_INET, SOCK_DGRAM, 0);
 	if (ntp_socket < 0) {
 		AWS_ERROR("Failed to create UDP Client Socket!");
-		return AWS_E_NET_SOCKET_INVALID;
-	} else {
-		aws_net_set_ntp_socket(ntp_socket);
+		gNtp.state = AWS_NET_NTP_STATE_WAIT;
+		TimerCountdown(&gNtp.timer, AWS_NET_NTP_RETRY_SEC);
+		return;
 	}
+	aws_net_set_ntp_socket(ntp_socket);
+	DISABLE_NTP_SOCKET_STATUS(NTP_SOCKET_STATUS_RECEIVE_FROM);
 
 	addr.sin_family = AF_INET;
 	addr.sin_addr.s_addr = _htonl(MAIN_DEFAULT_ADDRESS);
-	addr.sin_port = _htons(6666);
-	delay_ms(50);
-	if (bind((SOCKET)aws_net_get_ntp_socket(), (struct sockaddr *)&addr, sizeof(struct sockaddr_in)) != SOCK_ERR_NO_ERROR) {
-		close(ntp_socket);
-		AWS_ERROR("Failed to bind socket!");
-		return AWS_E_NET_SOCKET_INVALID;        
-	}
+	addr.sin_port = _htons(AWS_NET_NTP_LOCAL_PORT);
+	bind(ntp_socket, (struct sockaddr *)&addr, sizeof(struct sockaddr_in));
 
-	TimerInit(&ntpTimer);
-	TimerCountdownMS(&ntpTimer, timeout_ms);
-	while (!GET_NTP_SOCKET_STATUS(NTP_SOCKET_STATUS_RECEIVE_FROM)) {
-		if(TimerIsExpired(&ntpTimer)) {
-			close(ntp_socket);
-			AWS_ERROR("Expired connection time!(%d)", ret);
-			return AWS_E_NET_SOCKET_TIMEOUT;
-		}
-		m2m_wifi_handle_events(NULL);
+	gNtp.server = 0;
+	gNtp.state = AWS_NET_NTP_STATE_RESOLVE;
+	TimerCountdownMS(&gNtp.timer, AWS_NET_NTP_TIMEOUT_MS);
+	gethostbyname((uint8_t *)ntp_servers[gNtp.server]);
+}
+
+/**
+ * \brief Drive NTP timeouts and the periodic resync. Call it from the task owning the WINC.
+ */
+void aws_net_ntp_poll(void)
+{
+	if (aws_net_get_wifi_status() != M2M_WIFI_CONNECTED)
+		return;
+
+	switch (gNtp.state) {
+		case AWS_NET_NTP_STATE_RESOLVE:
+		case AWS_NET_NTP_STATE_QUERY:
+			if (TimerIsExpired(&gNtp.timer)) {
+				AWS_WARN("NTP server %s timed out", ntp_servers[gNtp.server]);
+				aws_net_ntp_next_server();
+			}
+			break;
+
+		case AWS_NET_NTP_STATE_WAIT:
+			if (TimerIsExpired(&gNtp.timer))
+				aws_net_ntp_start();
+			break;
+
+		default:
+			break;
 	}
+}
 
-	close(ntp_socket);
-	return ret;    
+/**
+ * \brief Read a big-endian 32-bit field of an NTP packet.
+ *
+ * \param buf[in]            Pointer to the field
+ * \return the value
+ */
+static uint32_t aws_net_ntp_get_u32(const uint8_t* buf)
+{
+	return ((uint32_t)buf[0] << 24) | ((uint32_t)buf[1] << 16) | ((uint32_t)buf[2] << 8) | buf[3];
 }
 
 /**
@@ -514,7 +563,7 @@ void aws_net_ntp_socket_cb(SOCKET sock, uint8_t u8Msg, void* pvMsg)
 			tstrSocketBindMsg *pstrBind = (tstrSocketBindMsg *)pvMsg;
 			if (pstrBind && pstrBind->status == 0) {
 				ENABLE_NTP_SOCKET_STATUS(NTP_SOCKET_STATUS_BIND);
-				ret = recvfrom(sock, ntp_dns_address, sizeof(ntp_dns_address), 0);
+				ret = recvfrom(sock, ntp_packet, sizeof(ntp_packet), 0);
 				if (ret != SOCK_ERR_NO_ERROR) {
 					AWS_ERROR("socket_cb: recv error(%d)", ret);
 				}
@@ -528,31 +577,44 @@ void aws_net_ntp_socket_cb(SOCKET sock, uint8_t u8Msg, void* pvMsg)
 		case SOCKET_MSG_RECVFROM:
 		{
 			tstrSocketRecvMsg *pstrRx = (tstrSocketRecvMsg *)pvMsg;
-			if (pstrRx->pu8Buffer && pstrRx->s16BufferSize) {
-				uint8_t packetBuffer[48];
-				memcpy(&packetBuffer, pstrRx->pu8Buffer, sizeof(packetBuffer));
+			if (pstrRx->pu8Buffer && pstrRx->s16BufferSize >= AWS_NET_NTP_PACKET_SIZE
+				&& gNtp.state == AWS_NET_NTP_STATE_QUERY) {
+				uint32_t roundTrip = rtt_read_timer_value(RTT) - gNtp.sendTick;
+				uint32_t rxSecs, rxMs, txSecs, txMs, msec;
+				int32_t delay;
 
-	   			ENABLE_NTP_SOCKET_STATUS(NTP_SOCKET_STATUS_RECEIVE_FROM);
-				if ((packetBuffer[0] & 0x7) != 4) {                   /* expect only server response */
+				if ((ntp_packet[0] & 0x7) != 4) {                   /* expect only server response */
 					AWS_ERROR("socket_cb: Expecting response from Server Only!");
-					return;                    /* MODE is not server, abort */
-				} else {
-					uint32_t secsSince1900 = packetBuffer[40] << 24 | packetBuffer[41] << 16 | packetBuffer[42] << 8 | packetBuffer[43];
-
-					/* Now convert NTP time into everyday time.
-					 * Unix time starts on Jan 1 1970. In seconds, that's 2208988800.
-					 * Subtract seventy years.
-					 */
-					const uint32_t seventyYears = 2208988800UL;
-					uint32_t epoch = secsSince1900 - seventyYears;
-					/* Print the hour, minute and second.
-					 * GMT is the time at Greenwich Meridian.
-					 */
-					aws_net_set_current_time(epoch);
-					ret = close(sock);
+					recvfrom(sock, ntp_packet, sizeof(ntp_packet), 0);
+					return;                    /* MODE is not server, keep listening */
 				}
+				ENABLE_NTP_SOCKET_STATUS(NTP_SOCKET_STATUS_RECEIVE_FROM);
+
+				/* Receive (T2) and transmit (T3) timestamps of the server, fractions in ms. */
+				rxSecs = aws_net_ntp_get_u32(&ntp_packet[32]);
+				rxMs = (uint32_t)(((uint64_t)aws_net_ntp_get_u32(&ntp_packet[36]) * 1000) >> 32);
+				txSecs = aws_net_ntp_get_u32(&ntp_packet[40]);
+				txMs = (uint32_t)(((uint64_t)aws_net_ntp_get_u32(&ntp_packet[44]) * 1000) >> 32);
+
+				/* One-way delay is half of the round trip minus the time the server held the packet. */
+				delay = (int32_t)roundTrip - ((int32_t)(txSecs - rxSecs) * 1000 + (int32_t)txMs - (int32_t)rxMs);
+				if (delay < 0)
+					delay = 0;
+				msec = txMs + delay / 2;
+
+				/* Now convert NTP time into everyday time, Unix time starts 70 years later. */
+				aws_kit_clock_set(txSecs - AWS_CLOCK_NTP_UNIX_OFFSET + msec / 1000, msec % 1000, AWS_CLOCK_SOURCE_NTP);
+				AWS_INFO("Time synchronized with %s, round trip %lu ms", ntp_servers[gNtp.server], roundTrip);
+
+				ret = close(sock);
+				aws_net_set_ntp_socket((SOCKET)-1);
+				gNtp.state = AWS_NET_NTP_STATE_WAIT;
+				TimerCountdown(&gNtp.timer, AWS_NET_NTP_RESYNC_SEC);
 			} else {
 	            DISABLE_NTP_SOCKET_STATUS(NTP_SOCKET_STATUS_RECEIVE_FROM);
+				/* Late answer from a server we gave up on, keep listening for the current one. */
+				if (pstrRx->s16BufferSize > 0)
+					recvfrom(sock, ntp_packet, sizeof(ntp_packet), 0);
 			}
 			break;
 		}
@@ -566,15 +628,21 @@ void aws_net_ntp_socket_cb(SOCKET sock, uint8_t u8Msg, void* pvMsg)
  * \brief Query date and time to NTP server over UDP.
  *
  * \param pu8DomainName[in]  Not used
- * \param u32ServerIP[in]    IP address of NTP server(pool.ntp.org)
+ * \param u32ServerIP[in]    IP address of the current NTP server
  */
 void aws_net_ntp_resolve_cb(uint8_t* pu8DomainName, uint32_t u32ServerIP)
 {
 	struct sockaddr_in addr;
-	int8_t cDataBuf[48];
+	int8_t cDataBuf[AWS_NET_NTP_PACKET_SIZE];
 	memset(cDataBuf, 0, sizeof(cDataBuf));
 	cDataBuf[0] = 0x1B; /* time query */
 
+	if (u32ServerIP == 0) {
+		AWS_WARN("Failed to resolve %s", ntp_servers[gNtp.server]);
+		aws_net_ntp_next_server();
+		return;
+	}
+
 	if (aws_net_get_ntp_socket() >= 0) {
 		/* Set NTP server socket address structure. */
 		addr.sin_family = AF_INET;
@@ -582,6 +650,9 @@ void aws_net_ntp_resolve_cb(uint8_t* pu8DomainName, uint32_t u32ServerIP)
 		addr.sin_addr.s_addr = u32ServerIP;
 
 		/*Send an NTP time query to the NTP server. */
+		gNtp.state = AWS_NET_NTP_STATE_QUERY;
+		gNtp.sendTick = rtt_read_timer_value(RTT);
+		TimerCountdownMS(&gNtp.timer, AWS_NET_NTP_TIMEOUT_MS);
 		if (sendto((SOCKET)aws_net_get_ntp_socket(), (int8_t *)&cDataBuf, sizeof(cDataBuf), 0, (struct sockaddr *)&addr, sizeof(addr)) != M2M_SUCCESS)
 			AWS_ERROR("Failed to time query!\r\n");
 	}
@@ -618,7 +689,18 @@ int aws_net_compare_date(t_time_date* local, atcacert_tm_utc_t* cert)
  */
 void aws_net_dns_resolve_cb(uint8_t* pu8DomainName, uint32_t u32ServerIP)
 {
+	/* The NTP client shares the resolve callback with the MQTT connection. */
+	if (gNtp.state == AWS_NET_NTP_STATE_RESOLVE
+		&& strcmp((const char*)pu8DomainName, ntp_servers[gNtp.server]) == 0) {
+		aws_net_ntp_resolve_cb(pu8DomainName, u32ServerIP);
+		return;
+	}
+
 	hostAddress = u32ServerIP;
+	if (u32ServerIP) {
+		gHostCache.addr = u32ServerIP;
+		strncpy((char*)gHostCache.host, (const char*)pu8DomainName, sizeof(gHostCache.host) - 1);
+	}
 }
 
 /**
@@ -641,6 +723,52 @@ void aws_net_set_host_addr(uint32_t addr)
 	hostAddress = addr;
 }
 
+/**
+ * \brief Fall back on the last address the host resolved to, when the DNS server does not answer.
+ *
+ * \param host[in]           Host name
+ * \return true              If an address of the host is known
+ */
+bool aws_net_use_cached_host_addr(const char* host)
+{
+	if (gHostCache.addr == 0 || strncmp((const char*)gHostCache.host, host, sizeof(gHostCache.host)) != 0)
+		return false;
+
+	hostAddress = gHostCache.addr;
+	return true;
+}
+
+/**
+ * \brief Load the last address of the host from the key/value store, which must have been opened.
+ *
+ * \return AWS_E_SUCCESS      On success
+ */
+int aws_net_load_host_cache(void)
+{
+	int ret;
+	uint16_t length = 0;
+
+	ret = aws_kit_store_get(AWS_STORE_KEY_HOST_ADDR, (uint8_t*)&gHostCache, sizeof(gHostCache), &length);
+	if (ret != AWS_E_SUCCESS || length != sizeof(gHostCache))
+		memset(&gHostCache, 0, sizeof(gHostCache));
+	gHostCache.host[sizeof(gHostCache.host) - 1] = '\0';
+
+	return ret;
+}
+
+/**
+ * \brief Save the last address of the host to the key/value store, which must have been opened.
+ *
+ * \return AWS_E_SUCCESS      On success
+ */
+int aws_net_save_host_cache(void)
+{
+	if (gHostCache.addr == 0)
+		return AWS_E_SUCCESS;
+
+	return aws_kit_store_set(AWS_STORE_KEY_HOST_ADDR, (const uint8_t*)&gHostCache, sizeof(gHostCache));
+}
+
 int aws_net_disconnect_cb(void* ctx)
 {
 	SOCKET* sock = (SOCKET*)ctx;
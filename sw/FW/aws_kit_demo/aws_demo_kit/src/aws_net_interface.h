@@ -79,6 +79,8 @@ extern "C" {
    @{ */
 #define AWS_NET_CONN_TIMEOUT_MS					(5000)
 #define AWS_NET_NTP_TIMEOUT_MS					(5000)
+#define AWS_NET_NTP_RETRY_SEC					(60)
+#define AWS_NET_NTP_RESYNC_SEC					(3600)
 #define AWS_NET_SUBSCRIBE_TIMEOUT_MS			(1000)
 /** @} */
 
@@ -109,8 +111,20 @@ extern "C" {
 /** \name NTP server definition
    @{ */
 #define MAIN_WORLDWIDE_NTP_POOL_HOSTNAME		"pool.ntp.org"
+#define AWS_NET_NTP_SERVER_2					"time.google.com"
+#define AWS_NET_NTP_SERVER_3					"time.nist.gov"
 #define MAIN_SERVER_PORT_FOR_UDP				(123)
 #define MAIN_DEFAULT_ADDRESS					0xFFFFFFFF /* "255.255.255.255" */
+#define AWS_NET_NTP_LOCAL_PORT					(6666)
+#define AWS_NET_NTP_PACKET_SIZE					(48)
+/** @} */
+
+/** \name Asynchronous NTP states
+   @{ */
+#define AWS_NET_NTP_STATE_IDLE					(0)
+#define AWS_NET_NTP_STATE_RESOLVE				(1)
+#define AWS_NET_NTP_STATE_QUERY					(2)
+#define AWS_NET_NTP_STATE_WAIT					(3)
 /** @} */
 
 extern uint16_t tcp_socket_status;
@@ -156,20 +170,23 @@ void aws_net_set_wifi_status(bool status);
 bool aws_net_get_wifi_status(void);
 void aws_net_wifi_cb(uint8_t u8MsgType, void* pvMsg);
 int aws_net_init_wifi(t_aws_kit* kit, int timeout_sec);
-int aws_net_get_time(t_aws_kit* kit);
+void aws_net_ntp_start(void);
+void aws_net_ntp_poll(void);
 void aws_net_socket_cb(SOCKET sock, uint8_t u8Msg, void *pvMsg);
 void aws_net_set_ntp_socket(SOCKET socket);
 SOCKET aws_net_get_ntp_socket(void);
 int aws_net_set_current_time(uint32_t secs);
 int aws_net_get_current_time(t_time_date* tm);
 time_t aws_net_get_ntp_seconds(void);
-int aws_net_get_ntp_time(uint32_t timeout_ms);
 void aws_net_ntp_socket_cb(SOCKET sock, uint8_t u8Msg, void* pvMsg);
 void aws_net_ntp_resolve_cb(uint8_t* pu8DomainName, uint32_t u32ServerIP);
 int aws_net_compare_date(t_time_date* local, atcacert_tm_utc_t* cert);
 void aws_net_dns_resolve_cb(uint8_t* pu8DomainName, uint32_t u32ServerIP);
 uint32_t aws_net_get_host_addr(void);
 void aws_net_set_host_addr(uint32_t addr);
+bool aws_net_use_cached_host_addr(const char* host);
+int aws_net_load_host_cache(void);
+int aws_net_save_host_cache(void);
 int aws_net_disconnect_cb(void* ctx);
 
 /** @} */
@@ -48,6 +48,8 @@
 #include "tls/atcatls_cfg.h"
 #include "aws_prov_task.h"
 #include "aws_kit_object.h"
+#include "aws_kit_crypto.h"
+#include "aws_kit_user_data.h"
 #include "cert_def_1_signer.h"
 #include "cert_def_2_device.h"
 
@@ -73,6 +75,8 @@ static uint8_t pucUsbRxBuffer[USB_BUFFER_SIZE_RX];	//!< USB CDC RX buffer
 static uint8_t pucUsbTxBuffer[USB_BUFFER_SIZE_TX];	//!< USB CDC TX buffer
 static uint8_t rxPacketStatus = KIT_STATUS_SUCCESS;	//!< USB RX packet status
 static uint16_t rxBufferIndex = 0;					//!< Index of USB RX buffer
+static uint32_t factoryDevices = 0;					//!< Devices provisioned by aws_prov_factory_config()
+static portTickType factoryStart = 0;				//!< Tick count when the first of them was started
 
 /**
  * \brief This function returns the pointer of USB RX buffer.
@@ -1315,10 +1319,10 @@ uint8_t aws_prov_write_user_data(uint8_t offset, uint8_t* data, uint32_t len)
 		write_size = sizeof(userData) / 2;
 	}
 
-	/* Write the data with specified address and size. */
-	status = atcab_write_bytes_zone(ATCA_ZONE_DATA, TLS_SLOT8_ENC_STORE, offset, userData, write_size);
-	if (status != ATCA_SUCCESS) {
-		AWS_ERROR("Failed to write user data!(%d)", status);
+	/* Write the data with specified address and size, the Insight GUI expects it on the device when answered. */
+	if (aws_kit_user_data_write(offset, userData, write_size) != AWS_E_SUCCESS
+		|| aws_kit_user_data_flush() != AWS_E_SUCCESS) {
+		AWS_ERROR("Failed to write user data!");
 		status = AWS_E_CRYPTO_FAILURE;
 	}
 
@@ -1776,6 +1780,110 @@ uint8_t aws_prov_build_device_tbs(char* command, uint8_t* tbs_digest, uint16_t*
 	return status;
 }
 
+/**
+ * \brief Write a complete configuration zone image and lock it, for mass provisioning on a production line.
+ *
+ * The configuration zone is read once, only the words differing from the image are written, and the zone is
+ * locked with the CRC of the image, all while the device stays awake. A device locked with the same image
+ * already is reported as success, so a fixture can retry a device. The device is discovered again first, a
+ * fresh ATECC508A answers at FACTORY_INIT_I2C rather than DEVICE_I2C. The response holds the number of words
+ * written, the time spent in ms, the number of devices provisioned since boot and the line throughput in
+ * devices per hour, measured from the start of the first device, all big-endian.
+ *
+ * \param[in] command          Command string
+ * \param[out] response        Buffer for the response
+ * \param[out] response_length Length of the response packet
+ * \return KIT_STATUS_SUCCESS  On success
+ * \return KIT_STATUS_NO_DEVICE If no ATECC508A answers at either I2C address
+ * \return KIT_STATUS_CONFIG_MISMATCH If the configuration zone is locked with another image
+ * \return KIT_STATUS_COMMAND_FAILED If a device command failed
+ */
+uint8_t aws_prov_factory_config(char* command, uint8_t* response, uint16_t* response_length)
+{
+	uint8_t status = KIT_STATUS_SUCCESS;
+	uint8_t *data_buffer = NULL;
+	uint16_t buffer_length = 0;
+	uint8_t configdata[ATCA_CONFIG_SIZE];
+	uint8_t crc[ATCA_CRC_SIZE];
+	uint8_t words = 0;
+	bool mismatch = false;
+	portTickType start = xTaskGetTickCount();
+	uint32_t elapsed, perHour;
+
+	*response_length = 0;
+
+	/* Extract the configuration zone image passed by the fixture */
+	status = aws_prov_extract_data_load((const char*)command, &buffer_length, &data_buffer);
+	if (status != KIT_STATUS_SUCCESS)
+		return status;
+	if (buffer_length != ATCA_CONFIG_SIZE)
+		return KIT_STATUS_INVALID_PARAMS;
+
+	/* Point the basic API at the address the device answers at. */
+	if (aws_prov_discover_devices() == DEVKIT_IF_UNKNOWN) {
+		AWS_ERROR("Factory configuration failed, no ATECC508A at 0x%02X or 0x%02X", DEVICE_I2C, FACTORY_INIT_I2C);
+		return KIT_STATUS_NO_DEVICE;
+	}
+
+	status = atcab_session_begin();
+	if (status != ATCA_SUCCESS) {
+		AWS_ERROR("Factory configuration failed!(%d)", status);
+		return KIT_STATUS_COMMAND_FAILED;
+	}
+
+	do {
+
+		status = atcab_read_config_zone(configdata);
+		if (status != ATCA_SUCCESS) break;
+
+		if (configdata[FACTORY_CONFIG_LOCK_OFFSET] != FACTORY_CONFIG_UNLOCKED) {
+			/* Compare the bytes atcab_cmp_config_zone() compares, the others may change in the field. */
+			if (memcmp(&configdata[16], &data_buffer[16], 52 - 16) != 0
+				|| memcmp(&configdata[90], &data_buffer[90], ATCA_CONFIG_SIZE - 90) != 0)
+				mismatch = true;
+			break;
+		}
+
+		status = atcab_update_ecc_config_zone(data_buffer, configdata, &words);
+		if (status != ATCA_SUCCESS) break;
+
+		/* The device refuses the lock unless the zone holds exactly what has been written. */
+		atCRC(ATCA_CONFIG_SIZE, configdata, crc);
+		status = atcab_lock_config_zone_crc((uint16_t)crc[0] | ((uint16_t)crc[1] << 8));
+		if (status != ATCA_SUCCESS) break;
+
+	} while(0);
+
+	atcab_session_end();
+
+	if (mismatch) {
+		AWS_ERROR("Factory configuration failed, the zone is locked with another image");
+		return KIT_STATUS_CONFIG_MISMATCH;
+	}
+	if (status != ATCA_SUCCESS) {
+		AWS_ERROR("Factory configuration failed!(%d)", status);
+		return KIT_STATUS_COMMAND_FAILED;
+	}
+
+	/* The line throughput includes the time the fixture spends between devices. */
+	if (factoryDevices++ == 0)
+		factoryStart = start;
+	elapsed = (xTaskGetTickCount() - start) * portTICK_RATE_MS;
+	perHour = (xTaskGetTickCount() - factoryStart) * portTICK_RATE_MS;
+	perHour = perHour ? (uint32_t)((uint64_t)factoryDevices * 3600000 / perHour) : 0;
+	AWS_INFO("Factory: %d words written in %lu ms, %lu devices, %lu devices/h", words, elapsed, factoryDevices, perHour);
+
+	response[0] = words;
+	for (uint8_t i = 0; i < 4; i++) {
+		response[1 + i] = (uint8_t)(elapsed >> (24 - i * 8));
+		response[5 + i] = (uint8_t)(factoryDevices >> (24 - i * 8));
+		response[9 + i] = (uint8_t)(perHour >> (24 - i * 8));
+	}
+	*response_length = FACTORY_RESPONSE_SIZE;
+
+	return KIT_STATUS_SUCCESS;
+}
+
 /**
  * \brief This function parses communication commands received from Insight GUI in the context of an AWS application.
  * aws: Indicates that this is a command for the AWS Starter Kit.
@@ -1790,6 +1898,7 @@ uint8_t aws_prov_build_device_tbs(char* command, uint8_t* tbs_digest, uint16_t*
  * aw[s]:ss[ignature]          aws_save_cert
  * aw[s]:sw[ifissid]           aws_save_wifi_ssid
  * aw[s]:sh[ost]               aws_save_host_address
+ * aw[s]:f[actory]             aws_factory_config
  *
  * \param[in] commandLength    Length of command (Not used.)
  * \param[in] command          The second parameter of entire command
@@ -1824,6 +1933,11 @@ uint8_t aws_prov_parse_aws_commands(uint16_t commandLength, uint8_t *command, ui
 			else
 				status = aws_prov_get_cert(pToken + 1, response, responseLength);
 			break;
+		/* "aw[s]:f(configuration zone)" */
+		case 'F':
+		case 'f':
+			status = aws_prov_factory_config(pToken + 1, response, responseLength);
+			break;
 		/* "aw[s]:p(slotId)" */
 		case 'p':
 		case 'P':
@@ -1887,6 +2001,7 @@ void aws_prov_handler(void)
 {
 	uint16_t rx_length = 0, tx_length = 0;
 	uint8_t* tx_buffer = NULL;
+	t_aws_crypto_request request;
 
 	/* Check for received data */
    	if ((udi_cdc_is_rx_ready()) && ((rx_length = udi_cdc_get_nb_received_data()) > 0)) {
@@ -1898,8 +2013,12 @@ void aws_prov_handler(void)
 		rx_length = udi_cdc_get_nb_received_data();
 		udi_cdc_read_buf((void *)pucUsbRxBuffer, rx_length);
 
-		/* Parse received data and execute command */
-		tx_buffer = aws_prov_process_usb_packet(rx_length, &tx_length);
+		/* Parse received data and execute command. Commands talk to ATECC508A, so it is held through the crypto service
+		   while they run on this task. */
+		if (aws_kit_crypto_acquire(&request, AWS_CRYPTO_PRIO_NORMAL) == AWS_E_SUCCESS) {
+			tx_buffer = aws_prov_process_usb_packet(rx_length, &tx_length);
+			aws_kit_crypto_release(&request);
+		}
 
 		/* Write a result of command execution into TX buffer to notify it to Insight GUI */
 		if(udi_cdc_is_tx_ready() && tx_length > 0) {
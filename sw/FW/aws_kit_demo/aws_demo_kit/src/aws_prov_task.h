@@ -92,6 +92,9 @@ extern "C" {
 // I2C address for device programming and initial communication
 #define FACTORY_INIT_I2C						(uint8_t)(0xC0)	//!< Initial I2C address is set to 0xC0 in the factory
 #define DEVICE_I2C								(uint8_t)(0xB0)	//!< Device I2C Address to program device to
+#define FACTORY_CONFIG_LOCK_OFFSET				(87)			//!< Offset of the LockConfig byte in the configuration zone
+#define FACTORY_CONFIG_UNLOCKED					(uint8_t)(0x55)	//!< LockConfig value of an unlocked configuration zone
+#define FACTORY_RESPONSE_SIZE					(13)			//!< Words written, session time, devices and devices per hour
 
 #define AWS_ROOT_CERT_ID						(uint8_t)(0x00)	//!< AWS Root Certificate Identifier		
 #define AWS_SIGNER_CERT_ID						(uint8_t)(0x01)	//!< AWS Signer Certificate Identifier
@@ -107,7 +110,9 @@ enum {
 	KIT_STATUS_USB_TX_OVERFLOW     = 0xC2,
 	KIT_STATUS_INVALID_PARAMS      = 0xC3,
 	KIT_STATUS_INVALID_IF_FUNCTION = 0xC4,
-	KIT_STATUS_NO_DEVICE           = 0xC5
+	KIT_STATUS_NO_DEVICE           = 0xC5,
+	KIT_STATUS_COMMAND_FAILED      = 0xC6,
+	KIT_STATUS_CONFIG_MISMATCH     = 0xC7
 };
 
 //! USB packet state.
@@ -192,6 +197,7 @@ uint8_t aws_prov_save_signature(char* command, uint8_t* response, uint16_t* resp
 uint8_t aws_prov_get_public_key(char* command, uint8_t* response, uint16_t* response_length);
 uint8_t aws_prov_get_cert(char* command, uint8_t* response, uint16_t* response_length);
 uint8_t aws_prov_build_device_tbs(char* command, uint8_t* tbs_digest, uint16_t* tbs_size);
+uint8_t aws_prov_factory_config(char* command, uint8_t* response, uint16_t* response_length);
 uint8_t aws_prov_parse_aws_commands(uint16_t commandLength, uint8_t *command, uint16_t *responseLength, uint8_t *response);
 void aws_prov_handler(void);
 void aws_prov_task(void *params);
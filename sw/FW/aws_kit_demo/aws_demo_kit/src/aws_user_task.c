@@ -45,6 +45,7 @@
 #include "aws_main_task.h"
 #include "aws_user_task.h"
 #include "aws_kit_object.h"
+#include "aws_kit_queue.h"
 #include "cryptoauthlib.h"
 
 static OLED1_CREATE_INSTANCE(oled1, OLED1_EXT_HEADER);
@@ -278,6 +279,29 @@ void aws_user_exception_blink_led(t_aws_kit* kit)
 	TimerCountdown(&kit->exceptionTimer, AWS_USER_ERROR_TIMEOUT_SEC);
 }
 
+/**
+ * \brief Toggle the state of a pressed button, and queue the event for the Client task to publish.
+ * Events pressed while the MQTT connection is down are kept in order until it is restored.
+ *
+ * \param kit[inout]          Pointer to an instance of AWS Kit
+ * \param button[in]          Pressed button
+ */
+void aws_user_report_button(t_aws_kit* kit, uint8_t button)
+{
+	char msg[AWS_QUEUE_PAYLOAD_MAX];
+	int len;
+
+	len = snprintf(msg, sizeof(msg), AWS_USER_BUTTON_EVENT_MESSAGE, button + 1, kit->button.state[button] ? "up" : "down");
+
+	/* Save button state to toggle, the Client task writes it to ATECC508A. */
+	kit->button.state[button] = kit->button.state[button] ? false : true;
+	kit->button.isPressed[button] = true;
+
+	if (aws_kit_queue_push(msg, (uint16_t)len, AWS_USER_QUEUE_TIMEOUT_MS) != AWS_E_SUCCESS) {
+		AWS_WARN("Dropped the event of button %d", button + 1);
+	}
+}
+
 /**
  * \brief This User task monitors all button state from ISR to make user MQTT client reports the state.
  *
@@ -302,11 +326,11 @@ void aws_user_task(void* params)
 		while (xQueueReceive(kit->buttonQueue, butBuffer, 0)) {
 			AWS_INFO("Pressed a button on the OLED1 : %d", butBuffer[0]);
 			if (butBuffer[0] == OLED1_BUTTON1_ID)
-				kit->button.isPressed[AWS_KIT_BUTTON_1] = AWS_BUTTON_PRESSED;
+				aws_user_report_button(kit, AWS_KIT_BUTTON_1);
 			else if(butBuffer[0] == OLED1_BUTTON2_ID)
-				kit->button.isPressed[AWS_KIT_BUTTON_2] = AWS_BUTTON_PRESSED;
+				aws_user_report_button(kit, AWS_KIT_BUTTON_2);
 			else if(butBuffer[0] == OLED1_BUTTON3_ID)
-				kit->button.isPressed[AWS_KIT_BUTTON_3] = AWS_BUTTON_PRESSED;
+				aws_user_report_button(kit, AWS_KIT_BUTTON_3);
 		}
 
 		/* If a user presses the SW0 button for 3 seconds, then reset all user data including WIFI credential, host address, etc. */ 
@@ -67,6 +67,12 @@
 #define AWS_USER_ERROR_TIMEOUT_SEC				(1)
 /** @} */
 
+/** \name Button event reported through the publish queue
+   @{ */
+#define AWS_USER_BUTTON_EVENT_MESSAGE			"{\"state\":{\"reported\":{\"button%d\":\"%s\"}}}"
+#define AWS_USER_QUEUE_TIMEOUT_MS				(100)
+/** @} */
+
 /**
  * \defgroup oled1_xpro_io_group OLED1 Xplained Pro LED and button driver
  *
@@ -312,6 +318,7 @@ void aws_user_oled1_button_cb(uint32_t id, uint32_t mask);
 void aws_user_sw0_init(void);
 void aws_user_oled1_init(void);
 void aws_user_scan_oled1_button(void);
+void aws_user_report_button(t_aws_kit* kit, uint8_t button);
 void aws_user_exception_init_timer(t_aws_kit* kit);
 void aws_user_exception_blink_led(t_aws_kit* kit);
 void aws_user_task(void *params);
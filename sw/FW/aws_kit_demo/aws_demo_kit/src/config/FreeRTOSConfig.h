@@ -72,14 +72,18 @@
 #define configTICK_RATE_HZ				( ( portTickType ) 1000 )
 #define configMAX_PRIORITIES			( ( unsigned portBASE_TYPE ) 5 )
 #define configMINIMAL_STACK_SIZE		( ( unsigned short ) 1024 )
-#define configTOTAL_HEAP_SIZE			( ( size_t ) ( 51200 ) )
+#define configTOTAL_HEAP_SIZE			( ( size_t ) ( 55296 ) )
 #define configMAX_TASK_NAME_LEN			( 10 )
 #define configUSE_TRACE_FACILITY		1
 #define configUSE_16_BIT_TICKS			0
 #define configIDLE_SHOULD_YIELD			1
 #define configUSE_MUTEXES				1
 #define configQUEUE_REGISTRY_SIZE		8
+#ifdef DEBUG
+#define configCHECK_FOR_STACK_OVERFLOW	2
+#else
 #define configCHECK_FOR_STACK_OVERFLOW	0
+#endif
 #define configUSE_RECURSIVE_MUTEXES		1
 #define configUSE_MALLOC_FAILED_HOOK	0
 #define configUSE_APPLICATION_TASK_TAG	0
@@ -105,6 +109,7 @@ to exclude the API function. */
 #define INCLUDE_vTaskSuspend			1
 #define INCLUDE_vTaskDelayUntil			1
 #define INCLUDE_vTaskDelay				1
+#define INCLUDE_xTaskGetCurrentTaskHandle	1
 
 /* FreeRTOS+CLI definitions. */
 
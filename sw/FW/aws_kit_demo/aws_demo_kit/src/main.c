@@ -43,6 +43,7 @@
  
 #include <asf.h>
 #include "aws_main_task.h"
+#include "aws_kit_clock.h"
 
 
 /**
@@ -62,6 +63,19 @@ static void configure_console(void)
 	stdio_serial_init(CONF_UART, &uart_serial_options);
 }
 
+#if configCHECK_FOR_STACK_OVERFLOW
+/**
+ * \brief Called by FreeRTOS when a task has overflowed its stack, debug builds only.
+ */
+void vApplicationStackOverflowHook(xTaskHandle pxTask, signed char *pcTaskName)
+{
+	taskDISABLE_INTERRUPTS();
+	printf("Stack overflow in %s task\r\n", (char *)pcTaskName);
+
+	for (;;) {
+	}
+}
+#endif
 
 int main(void)
 {
@@ -80,6 +94,9 @@ int main(void)
 	// Initialize RTT
 	configure_rtt();
 
+	// Restore the wall clock kept by the RTC across resets
+	aws_kit_clock_init();
+
 	// Initialize the demo..
 	aws_demo_tasks_init();
 